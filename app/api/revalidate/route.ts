@@ -0,0 +1,31 @@
+// app/api/revalidate/route.ts
+//
+// On-demand revalidation webhook for the pre-rendered project and profile
+// pages. Called by hardwaresphere-api/services/revalidation-service.js.
+
+import { NextRequest, NextResponse } from "next/server";
+import { revalidateTag } from "next/cache";
+
+// Only tags produced by lib/server-api.ts are accepted.
+const TAG_PATTERN = /^(project|user):\S{1,128}$/;
+
+export async function POST(request: NextRequest) {
+  const secret = process.env.REVALIDATE_SECRET;
+  if (!secret || request.headers.get("x-revalidate-secret") !== secret) {
+    return NextResponse.json({ error: "Unauthorized" }, { status: 401 });
+  }
+
+  let tags: unknown;
+  try {
+    ({ tags } = await request.json());
+  } catch {
+    return NextResponse.json({ error: "Invalid JSON body" }, { status: 400 });
+  }
+
+  if (!Array.isArray(tags) || tags.length === 0 || !tags.every((tag) => typeof tag === "string" && TAG_PATTERN.test(tag))) {
+    return NextResponse.json({ error: "Expected a non-empty list of project:/user: tags" }, { status: 400 });
+  }
+
+  tags.forEach((tag) => revalidateTag(tag));
+  return NextResponse.json({ revalidated: tags, now: Date.now() });
+}
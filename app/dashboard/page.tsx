@@ -7,7 +7,9 @@ import { Button } from '@/components/ui/button';
 import { Avatar, AvatarFallback, AvatarImage } from '@/components/ui/avatar';
 import { User, Settings, Plus, LogOut } from 'lucide-react';
 import AuthGuard from '@/components/auth/auth-guard';
+import ViewAnalyticsCard from '@/components/analytics/view-analytics-card';
 import { getCurrentUser } from '@/lib/api';
+import { resizedImageUrl } from '@/lib/image-loader';
 import { useRouter } from 'next/navigation';
 
 
@@ -98,7 +100,7 @@ function DashboardContent() {
             <CardContent>
               <div className="flex items-center space-x-4">
                 <Avatar className="h-12 w-12">
-                  <AvatarImage src={userProfile?.avatar} />
+                  <AvatarImage src={resizedImageUrl(userProfile?.avatar, 48)} />
                   <AvatarFallback>
                     {userProfile?.displayName ? getInitials(userProfile.displayName) : 'U'}
                   </AvatarFallback>
@@ -165,6 +167,9 @@ function DashboardContent() {
               )}
             </CardContent>
           </Card>
+
+          {/* View Analytics */}
+          <ViewAnalyticsCard />
         </div>
 
         {/* Debug Information (remove in production) */}
@@ -12,6 +12,8 @@ import { Badge } from '@/components/ui/badge';
 import { Tooltip, TooltipContent, TooltipProvider, TooltipTrigger } from '@/components/ui/tooltip';
 import { Upload, Save, Eye, Loader2, Camera, X, CheckCircle2, AlertCircle } from 'lucide-react';
 import { useAuth } from '@/hooks/use-auth';
+import { resizeImageForUpload } from '@/lib/upload/resize-image';
+import { checkUsername as checkUsernameAvailability, updateProfile } from '@/lib/api';
 import AuthGuard from '@/components/auth/auth-guard';
 import { Toaster, toast } from 'sonner';
 
@@ -29,7 +31,7 @@ interface ProfileFormData {
 }
 
 // --- Username Availability State ---
-type UsernameStatus = 'idle' | 'checking' | 'available' | 'taken' | 'invalid';
+type UsernameStatus = 'idle' | 'checking' | 'available' | 'taken' | 'invalid' | 'reserved';
 
 // --- Skills Input Component ---
 const SkillsInput = ({ skills, setSkills }: { skills: string[], setSkills: (skills: string[]) => void }) => {
@@ -118,14 +120,8 @@ export default function ProfileEditPage() {
     }
     setUsernameStatus('checking');
     try {
-      const token = await user?.getIdToken();
-      const response = await fetch(`${process.env.NEXT_PUBLIC_API_URL}/api/users/username-check`, {
-        method: 'POST',
-        headers: { 'Content-Type': 'application/json', 'Authorization': `Bearer ${token}` },
-        body: JSON.stringify({ username }),
-      });
-      const data = await response.json();
-      setUsernameStatus(data.available ? 'available' : 'taken');
+      const data = await checkUsernameAvailability(username);
+      setUsernameStatus(data.available ? 'available' : data.reason ?? 'taken');
     } catch {
       setUsernameStatus('idle'); // Fallback on error
     }
@@ -186,11 +182,14 @@ export default function ProfileEditPage() {
       toast.error('Username is already taken. Please choose another.');
       return;
     }
+    if (usernameStatus === 'reserved' || usernameStatus === 'invalid') {
+      toast.error('Please choose a different username.');
+      return;
+    }
     setIsSaving(true);
     
     const submissionPromise = async () => {
-      const token = await user?.getIdToken();
-      if (!token) throw new Error("Authentication failed.");
+      if (!user) throw new Error("Authentication failed.");
 
       const data = new FormData();
       data.append('displayName', formData.displayName);
@@ -201,20 +200,16 @@ export default function ProfileEditPage() {
       data.append('linkedin', formData.linkedin);
       data.append('skills', JSON.stringify(formData.skills));
 
-      if (formData.avatarFile) data.append('avatar', formData.avatarFile);
-      if (formData.bannerFile) data.append('backgroundImage', formData.bannerFile);
+      // 🚀 OPTIMIZATION: Resize in the browser so only the stored size is uploaded
+      const [avatarUpload, backgroundUpload] = await Promise.all([
+        formData.avatarFile ? resizeImageForUpload(formData.avatarFile, 'avatar') : null,
+        formData.bannerFile ? resizeImageForUpload(formData.bannerFile, 'background') : null,
+      ]);
+      if (avatarUpload) data.append('avatar', avatarUpload);
+      if (backgroundUpload) data.append('backgroundImage', backgroundUpload);
 
-      const response = await fetch(`${process.env.NEXT_PUBLIC_API_URL}/api/users/me`, {
-        method: 'PUT',
-        headers: { 'Authorization': `Bearer ${token}` },
-        body: data,
-      });
+      await updateProfile(data);
 
-      if (!response.ok) {
-        const err = await response.json();
-        throw new Error(err.error || 'Failed to update profile.');
-      }
-      
       await revalidateUserProfile();
     };
 
@@ -286,11 +281,12 @@ export default function ProfileEditPage() {
                       {usernameStatus === 'checking' && <Loader2 className="h-5 w-5 text-muted-foreground animate-spin" />}
                       {usernameStatus === 'available' && <CheckCircle2 className="h-5 w-5 text-green-500" />}
                       {usernameStatus === 'taken' && <AlertCircle className="h-5 w-5 text-red-500" />}
-                      {usernameStatus === 'invalid' && <AlertCircle className="h-5 w-5 text-yellow-500" />}
+                      {(usernameStatus === 'invalid' || usernameStatus === 'reserved') && <AlertCircle className="h-5 w-5 text-yellow-500" />}
                     </div>
                   </div>
                   {usernameStatus === 'taken' && <p className="text-xs text-red-500 mt-1">This username is already taken.</p>}
-                  {usernameStatus === 'invalid' && <p className="text-xs text-yellow-500 mt-1">Username must be at least 3 characters.</p>}
+                  {usernameStatus === 'invalid' && <p className="text-xs text-yellow-500 mt-1">Use 3-30 letters, numbers, dots, dashes or underscores.</p>}
+                  {usernameStatus === 'reserved' && <p className="text-xs text-yellow-500 mt-1">This username is reserved.</p>}
                 </div>
                 <div><Label>Password</Label>
                   <TooltipProvider><Tooltip><TooltipTrigger asChild>
@@ -302,7 +298,7 @@ export default function ProfileEditPage() {
 
             <div className="flex justify-end space-x-4 mt-8">
               <Button type="button" variant="ghost" onClick={() => router.back()}>Cancel</Button>
-              <Button type="submit" disabled={isSaving || usernameStatus === 'taken' || usernameStatus === 'checking'}>
+              <Button type="submit" disabled={isSaving || usernameStatus === 'taken' || usernameStatus === 'reserved' || usernameStatus === 'checking'}>
                 {isSaving ? <Loader2 className="h-4 w-4 mr-2 animate-spin" /> : <Save className="h-4 w-4 mr-2" />}
                 Save All Changes
               </Button>
@@ -0,0 +1,135 @@
+// /app/embed/[id]/embed-viewer.tsx
+
+'use client';
+
+import { useEffect, useRef, useState } from 'react';
+import { supportsOffscreenCanvas } from '@/lib/three/offscreen-support';
+import { serializeEvent } from '@/lib/three/viewer-protocol';
+import type { ViewerWorkerRequest, ViewerWorkerResponse } from '@/lib/three/viewer-protocol';
+import type { LoadProgress } from '@/lib/three/viewer-core';
+import { reportVital } from '@/lib/vitals';
+
+interface EmbedViewerProps {
+  modelUrl: string;
+  environment: boolean;
+  autoRotate: boolean;
+}
+
+type Status =
+  | { state: 'loading'; progress: number | null }
+  | { state: 'ready' }
+  | { state: 'error'; message: string };
+
+const FORWARDED_EVENTS = ['pointerdown', 'pointermove', 'pointerup', 'pointercancel', 'wheel', 'contextmenu'] as const;
+
+const toFraction = ({ loaded, total }: LoadProgress) => (total ? loaded / total : null);
+const reportModelFirstFrame = (ms: number) => reportVital('MODEL_TTFF', ms);
+
+/**
+ * Bootstrap for the embed route. With OffscreenCanvas it only ships the
+ * message plumbing and lets the worker stream and render the GLB; otherwise
+ * it lazy-loads ViewerCore and renders on the main thread.
+ */
+export default function EmbedViewer({ modelUrl, environment, autoRotate }: EmbedViewerProps) {
+  const hostRef = useRef<HTMLDivElement>(null);
+  const [status, setStatus] = useState<Status>({ state: 'loading', progress: null });
+
+  useEffect(() => {
+    const host = hostRef.current;
+    if (!host) return;
+
+    const canvas = document.createElement('canvas');
+    canvas.style.cssText = 'display:block;width:100%;height:100%;touch-action:none;outline:none';
+    host.appendChild(canvas);
+
+    const pixelRatio = () => Math.min(window.devicePixelRatio || 1, 2);
+    const rect = () => {
+      const { left, top, width, height } = canvas.getBoundingClientRect();
+      return { left, top, width, height };
+    };
+    const onProgress = (progress: LoadProgress) => setStatus({ state: 'loading', progress: toFraction(progress) });
+    const onError = (message: string) => setStatus({ state: 'error', message });
+
+    let cleanup: () => void = () => {};
+    let cancelled = false;
+
+    if (supportsOffscreenCanvas()) {
+      const worker = new Worker(new URL('../../../lib/three/viewer.worker.ts', import.meta.url), { type: 'module' });
+      const send = (message: ViewerWorkerRequest, transfer: Transferable[] = []) => worker.postMessage(message, transfer);
+
+      worker.onmessage = (e: MessageEvent<ViewerWorkerResponse>) => {
+        const message = e.data;
+        if (message.type === 'progress') onProgress(message.progress);
+        else if (message.type === 'loaded') setStatus({ state: 'ready' });
+        else if (message.type === 'first-frame') reportModelFirstFrame(message.ms);
+        else if (message.type === 'error') onError(message.message);
+      };
+      worker.onerror = () => onError('The viewer stopped unexpectedly.');
+
+      const offscreen = canvas.transferControlToOffscreen();
+      send({ type: 'init', canvas: offscreen, rect: rect(), pixelRatio: pixelRatio(), environment }, [offscreen]);
+      send({ type: 'options', options: { autoRotate } });
+      send({ type: 'load', url: modelUrl });
+
+      const forward = (event: Event) => {
+        if (event.type === 'wheel' || event.type === 'contextmenu') event.preventDefault();
+        if (event.type === 'pointerdown') canvas.setPointerCapture((event as PointerEvent).pointerId);
+        send({ type: 'event', event: serializeEvent(event) });
+      };
+      FORWARDED_EVENTS.forEach(type => canvas.addEventListener(type, forward, { passive: false }));
+
+      const resizeObserver = new ResizeObserver(() => send({ type: 'resize', rect: rect(), pixelRatio: pixelRatio() }));
+      resizeObserver.observe(host);
+
+      cleanup = () => {
+        resizeObserver.disconnect();
+        FORWARDED_EVENTS.forEach(type => canvas.removeEventListener(type, forward));
+        send({ type: 'dispose' });
+        setTimeout(() => worker.terminate(), 1000);
+      };
+    } else {
+      // Fallback: same core, main thread. Loaded on demand so the worker path never pays for it.
+      import('@/lib/three/viewer-core').then(({ ViewerCore }) => {
+        if (cancelled) return;
+        const { width, height } = rect();
+        const viewer = new ViewerCore(canvas, canvas, {
+          width, height, pixelRatio: pixelRatio(), environment, onFirstFrame: reportModelFirstFrame,
+        });
+        viewer.setOptions({ autoRotate });
+        viewer.loadModel(modelUrl, onProgress)
+          .then(() => setStatus({ state: 'ready' }))
+          .catch((error) => onError(error instanceof Error ? error.message : 'Failed to load model'));
+
+        const resizeObserver = new ResizeObserver(() => {
+          const next = rect();
+          viewer.resize(next.width, next.height, pixelRatio());
+        });
+        resizeObserver.observe(host);
+
+        cleanup = () => {
+          resizeObserver.disconnect();
+          viewer.dispose();
+        };
+      }).catch(() => onError('Failed to start the viewer.'));
+    }
+
+    return () => {
+      cancelled = true;
+      cleanup();
+      canvas.remove();
+    };
+  }, [modelUrl, environment, autoRotate]);
+
+  return (
+    <div className="relative h-full w-full">
+      <div ref={hostRef} className="h-full w-full" />
+      {status.state !== 'ready' && (
+        <div className="pointer-events-none absolute inset-0 flex items-center justify-center text-sm text-slate-300">
+          {status.state === 'error'
+            ? status.message
+            : `Loading model${status.progress !== null ? ` ${Math.round(status.progress * 100)}%` : '…'}`}
+        </div>
+      )}
+    </div>
+  );
+}
@@ -0,0 +1,86 @@
+// /app/embed/[id]/page.tsx
+//
+// Minimal, iframe-friendly model viewer. Everything heavy on the project page
+// (React Three Fiber, drei, leva, lucide, shadcn) is deliberately left out:
+// the only client code is the small bootstrap in ./embed-viewer.tsx.
+
+import type { Metadata } from "next";
+import EmbedViewer from "./embed-viewer";
+
+const API_URL = process.env.NEXT_PUBLIC_API_URL || 'http://localhost:3001';
+
+interface EmbedProject {
+  id: string;
+  title: string;
+  username?: string;
+  visibility: 'public' | 'private';
+  files?: {
+    model?: { glb?: { url?: string } };
+  };
+  conversionStatus?: { completed?: boolean };
+}
+
+interface EmbedPageProps {
+  params: Promise<{ id: string }>;
+  searchParams: Promise<{ env?: string; autorotate?: string }>;
+}
+
+// Model URLs are short-lived signed URLs, so embeds are always rendered fresh.
+async function getEmbedProject(id: string): Promise<EmbedProject | null> {
+  try {
+    const response = await fetch(`${API_URL}/api/projects/${encodeURIComponent(id)}`, { cache: 'no-store' });
+    if (!response.ok) return null;
+    const project: EmbedProject = await response.json();
+    return project.visibility === 'public' ? project : null;
+  } catch (error) {
+    console.error(`Embed: failed to fetch project ${id}:`, error);
+    return null;
+  }
+}
+
+export async function generateMetadata({ params }: EmbedPageProps): Promise<Metadata> {
+  const { id } = await params;
+  const project = await getEmbedProject(id);
+  return {
+    title: project ? `${project.title} · HardwareSphere` : 'HardwareSphere',
+    robots: { index: false },
+  };
+}
+
+const EmbedMessage = ({ text }: { text: string }) => (
+  <div className="flex h-full items-center justify-center text-sm text-slate-400">{text}</div>
+);
+
+export default async function EmbedPage({ params, searchParams }: EmbedPageProps) {
+  const { id } = await params;
+  const { env, autorotate } = await searchParams;
+  const project = await getEmbedProject(id);
+  const modelUrl = project?.files?.model?.glb?.url;
+
+  return (
+    <main className="relative h-dvh w-full overflow-hidden bg-slate-950">
+      {!project ? (
+        <EmbedMessage text="This model is unavailable." />
+      ) : !modelUrl ? (
+        <EmbedMessage text="This model is still being processed." />
+      ) : (
+        <EmbedViewer
+          modelUrl={modelUrl}
+          environment={env === '1'}
+          autoRotate={autorotate === '1'}
+        />
+      )}
+
+      {project && (
+        <a
+          href={`/project/${project.id}`}
+          target="_blank"
+          rel="noopener noreferrer"
+          className="absolute bottom-2 right-3 text-xs text-slate-400 hover:text-white"
+        >
+          {project.title} · HardwareSphere ↗
+        </a>
+      )}
+    </main>
+  );
+}
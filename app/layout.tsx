@@ -5,6 +5,7 @@ import { Inconsolata, Raleway } from "next/font/google"; // Correctly imported
 import "./globals.css";
 
 import { ThemeProvider } from "@/components/theme-provider";
+import { WebVitals } from "@/components/web-vitals";
 
 // Configure Geist Sans (already correct)
 const geistSans = Geist({
@@ -48,6 +49,7 @@ export default function RootLayout({
       <body
         className={`${geistSans.variable} ${geistMono.variable} ${inconsolata.variable} ${raleway.variable} font-sans antialiased`}
       >
+        <WebVitals />
         <ThemeProvider
             attribute="class"
             defaultTheme="system"
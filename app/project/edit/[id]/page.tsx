@@ -3,7 +3,11 @@
 import { useState, useEffect, useRef, ReactElement } from "react";
 import { useParams, useRouter } from "next/navigation";
 import { useAuth } from "@/hooks/use-auth";
+import { resizeImageForUpload } from "@/lib/upload/resize-image";
+import { getProject, patchProject, type ProjectFileOp } from "@/lib/api";
+import { hashFile } from "@/lib/upload/hash-file";
 import AuthGuard from "@/components/auth/auth-guard";
+import RevisionHistory from "@/components/project/revision-history";
 import { Button } from "@/components/ui/button";
 import { Input } from "@/components/ui/input";
 import { Label } from "@/components/ui/label";
@@ -40,6 +44,7 @@ interface FileAttachment {
   filename: string;
   size: number;
   storagePath: string;
+  contentHash?: string;
 }
 
 interface FileSlot {
@@ -111,6 +116,8 @@ export default function ProjectEditPage() {
 
   // Use ref to prevent multiple fetches
   const fetchInProgressRef = useRef(false);
+  // Form values as loaded, so only changed fields are sent on save.
+  const savedFormRef = useRef<typeof formData | null>(null);
 
   const fileSlots: FileSlot[] = [
     {
@@ -167,20 +174,9 @@ export default function ProjectEditPage() {
     const fetchProjectData = async (): Promise<void> => {
       fetchInProgressRef.current = true;
       try {
-        // Include auth headers for private projects
-        const token = await user.getIdToken();
-        const res = await fetch(
-          `${process.env.NEXT_PUBLIC_API_URL}/api/projects/${projectId}`,
-          {
-            headers: {
-              Authorization: `Bearer ${token}`,
-              "Content-Type": "application/json",
-            },
-          }
-        );
-
-        if (!res.ok) throw new Error("Failed to fetch project data.");
-        const data: ProjectData = await res.json();
+        // Reuses the project page's cached copy when it is still fresh.
+        // The edit view also reads storage paths, which the shared type leaves optional.
+        const data = (await getProject(projectId)) as unknown as ProjectData;
 
         if (data.userId !== user.uid) {
           toast.error("You don't have permission to edit this project.");
@@ -188,13 +184,15 @@ export default function ProjectEditPage() {
           return;
         }
 
-        setFormData({
+        const loadedForm = {
           title: data.title,
           description: data.description,
           tags: data.tags || [],
           isPublic: data.visibility === "public",
           allowDownloads: data.allowDownloads,
-        });
+        };
+        savedFormRef.current = loadedForm;
+        setFormData(loadedForm);
 
         if (data.conversionStatus) {
           setConversionStatus(data.conversionStatus);
@@ -274,28 +272,16 @@ export default function ProjectEditPage() {
 
     const pollInterval = setInterval(async () => {
       try {
-        const token = await user?.getIdToken();
-        const res = await fetch(
-          `${process.env.NEXT_PUBLIC_API_URL}/api/projects/${projectId}`,
-          {
-            headers: {
-              Authorization: `Bearer ${token}`,
-              "Content-Type": "application/json",
-            },
-          }
-        );
-        if (res.ok) {
-          const data: ProjectData = await res.json();
-          if (data.conversionStatus) {
-            setConversionStatus(data.conversionStatus);
-            if (!data.conversionStatus.inProgress) {
-              clearInterval(pollInterval);
-              if (
-                data.conversionStatus.completed &&
-                data.conversionStatus.errors.length === 0
-              ) {
-                toast.success("3D model conversion completed!");
-              }
+        const data = (await getProject(projectId, { fresh: true })) as unknown as ProjectData;
+        if (data.conversionStatus) {
+          setConversionStatus(data.conversionStatus);
+          if (!data.conversionStatus.inProgress) {
+            clearInterval(pollInterval);
+            if (
+              data.conversionStatus.completed &&
+              data.conversionStatus.errors.length === 0
+            ) {
+              toast.success("3D model conversion completed!");
             }
           }
         }
@@ -366,60 +352,69 @@ export default function ProjectEditPage() {
     }));
   };
 
-  // --- Submit Handler: This correctly assembles the data for the backend ---
+  // --- Submit Handler: sends only what changed ---
+  const getChangedFields = () => {
+    const saved = savedFormRef.current;
+    const fields: Record<string, unknown> = {};
+    if (!saved || formData.title !== saved.title) fields.title = formData.title;
+    if (!saved || formData.description !== saved.description) fields.description = formData.description;
+    if (!saved || JSON.stringify(formData.tags) !== JSON.stringify(saved.tags)) fields.tags = formData.tags;
+    if (!saved || formData.isPublic !== saved.isPublic) fields.visibility = formData.isPublic ? "public" : "private";
+    if (!saved || formData.allowDownloads !== saved.allowDownloads) fields.allowDownloads = formData.allowDownloads;
+    return fields;
+  };
+
   const handleSubmit = async (e: React.FormEvent) => {
     e.preventDefault();
     setIsSaving(true);
 
     try {
-      const token = await user?.getIdToken();
-      if (!token) throw new Error("Authentication failed.");
+      if (!user) throw new Error("Authentication failed.");
 
       const data = new FormData();
-      data.append("title", formData.title);
-      data.append("description", formData.description);
-      data.append("tags", JSON.stringify(formData.tags));
-      data.append("isPublic", String(formData.isPublic));
-      data.append("allowDownloads", String(formData.allowDownloads));
-
-      // 1. Collect all storage paths for files that are marked for deletion.
-      const filesToDelete: string[] = [];
-      Object.entries(fileStates).forEach(([type, state]) => {
-        if (state.toDelete && state.existing?.storagePath) {
-          filesToDelete.push(state.existing.storagePath);
-        }
-      });
-      data.append("filesToDelete", JSON.stringify(filesToDelete));
+      const fields = getChangedFields();
+      const fileOps: ProjectFileOp[] = [];
+
+      for (const [type, state] of Object.entries(fileStates)) {
+        const existing = state.existing;
 
-      // 2. Append all new files with the correct field names for the backend middleware.
-      Object.entries(fileStates).forEach(([type, state]) => {
         if (state.new) {
-          if (type === "banner") {
-            data.append("bannerImage", state.new);
-          } else if (type === "model") {
-            data.append("modelFile", state.new); // Crucially uses 'modelFile'
-          } else {
-            data.append("projectFiles", state.new);
-          }
+          // 🚀 OPTIMIZATION: The banner is resized in the browser before it is appended.
+          const upload = type === "banner" ? await resizeImageForUpload(state.new, "banner") : state.new;
+
+          // Re-selecting the same file is a no-op; skip the upload entirely.
+          if (existing?.contentHash && existing.contentHash === (await hashFile(upload))) continue;
+
+          const file = type === "banner" ? "bannerImage" : type === "model" ? "modelFile" : "projectFiles";
+          fileOps.push(
+            existing?.storagePath
+              ? { op: "replace", target: existing.storagePath, file, name: upload.name }
+              : { op: "add", file, name: upload.name }
+          );
+          data.append(file, upload);
+        } else if (state.toDelete && existing?.storagePath) {
+          fileOps.push({ op: "remove", target: existing.storagePath });
         }
-      });
-
-      const response = await fetch(
-        `${process.env.NEXT_PUBLIC_API_URL}/api/projects/${projectId}`,
-        {
-          method: "PUT",
-          headers: { Authorization: `Bearer ${token}` },
-          body: data,
-        }
-      );
+      }
 
-      if (!response.ok) {
-        const err = await response.json();
-        throw new Error(err.message || "Failed to update project.");
+      if (Object.keys(fields).length === 0 && fileOps.length === 0) {
+        toast.info("No changes to save.");
+        router.push(`/project/${projectId}`);
+        return;
       }
 
+      data.append("fields", JSON.stringify(fields));
+      data.append("fileOps", JSON.stringify(fileOps));
+
+      // Invalidates every cached view of this project (project page, profile lists).
+      const result = await patchProject(projectId, data);
+      const reconverting = fileOps.some(op => op.op !== "remove" && op.file === "modelFile") &&
+        !result.skipped.some(name => fileStates.model?.new?.name === name);
+
       toast.success(
-        "Project updated successfully! Any model conversion will continue in the background."
+        reconverting
+          ? "Project updated successfully! The model conversion will continue in the background."
+          : "Project updated successfully!"
       );
       router.push(`/project/${projectId}`);
     } catch (error) {
@@ -773,6 +768,13 @@ export default function ProjectEditPage() {
               </Button>
             </div>
           </form>
+
+          <div className="mt-6">
+            <RevisionHistory
+              projectId={projectId}
+              onRestored={() => router.push(`/project/${projectId}`)}
+            />
+          </div>
         </div>
       </div>
     </AuthGuard>
@@ -0,0 +1,35 @@
+interface SparklineProps {
+  values: number[];
+  width?: number;
+  height?: number;
+  className?: string;
+  /** Accessible summary, e.g. "124 views in the last 7 days". */
+  label?: string;
+}
+
+/**
+ * Plain SVG line for small trend charts. No charting library: the data is
+ * already bucketed server-side, so this only scales points into the box.
+ */
+export default function Sparkline({ values, width = 240, height = 48, className, label }: SparklineProps) {
+  const max = Math.max(1, ...values);
+  const stepX = values.length > 1 ? width / (values.length - 1) : 0;
+  // Keep a pixel of padding so the stroke isn't clipped at the extremes.
+  const y = (value: number) => height - 1 - (value / max) * (height - 2);
+
+  const line = values.map((value, i) => `${i === 0 ? 'M' : 'L'}${(i * stepX).toFixed(1)},${y(value).toFixed(1)}`).join(' ');
+  const area = values.length > 1 ? `${line} L${width},${height} L0,${height} Z` : '';
+
+  return (
+    <svg
+      viewBox={`0 0 ${width} ${height}`}
+      preserveAspectRatio="none"
+      className={className}
+      role="img"
+      aria-label={label}
+    >
+      {area && <path d={area} className="fill-blue-500/10" />}
+      <path d={line} fill="none" className="stroke-blue-500" strokeWidth={1.5} vectorEffect="non-scaling-stroke" />
+    </svg>
+  );
+}
@@ -0,0 +1,71 @@
+'use client';
+
+import { useState } from 'react';
+import { Card, CardContent, CardDescription, CardHeader, CardTitle } from '@/components/ui/card';
+import { Button } from '@/components/ui/button';
+import { useApiQuery } from '@/hooks/use-api-query';
+import { viewAnalyticsQuery, type AnalyticsRange } from '@/lib/api';
+import Sparkline from './sparkline';
+
+const RANGES: { value: AnalyticsRange; label: string; description: string }[] = [
+  { value: '24h', label: '24h', description: 'the last 24 hours' },
+  { value: '7d', label: '7d', description: 'the last 7 days' },
+  { value: '30d', label: '30d', description: 'the last 30 days' },
+  { value: '90d', label: '90d', description: 'the last 90 days' },
+];
+
+const TOP_PROJECTS = 5;
+
+// Views across all of the signed-in user's projects. One request returns
+// every project's series, so the per-project sparklines cost nothing extra.
+export default function ViewAnalyticsCard() {
+  const [range, setRange] = useState<AnalyticsRange>('7d');
+  const { data, error, isLoading } = useApiQuery(viewAnalyticsQuery(range), { staleTime: 60_000 });
+  const description = RANGES.find(r => r.value === range)!.description;
+  const total = data?.totals.reduce((sum, value) => sum + value, 0) ?? 0;
+
+  return (
+    <Card className="md:col-span-2 lg:col-span-3">
+      <CardHeader className="flex flex-row items-start justify-between space-y-0">
+        <div>
+          <CardTitle className="text-sm font-medium">Project Views</CardTitle>
+          <CardDescription>
+            {data ? `${total.toLocaleString()} views in ${description}` : `Views in ${description}`}
+          </CardDescription>
+        </div>
+        <div className="flex gap-1">
+          {RANGES.map(r => (
+            <Button
+              key={r.value}
+              size="sm"
+              variant={r.value === range ? 'secondary' : 'ghost'}
+              onClick={() => setRange(r.value)}
+            >
+              {r.label}
+            </Button>
+          ))}
+        </div>
+      </CardHeader>
+      <CardContent>
+        {error ? (
+          <p className="text-sm text-gray-500">Analytics are unavailable right now.</p>
+        ) : isLoading || !data ? (
+          <div className="h-16 rounded bg-gray-100 animate-pulse" />
+        ) : (
+          <div className="space-y-4">
+            <Sparkline values={data.totals} height={64} className="w-full h-16" label={`${total} views in ${description}`} />
+            {data.projects.filter(p => p.total > 0).slice(0, TOP_PROJECTS).map(project => (
+              <div key={project.id} className="flex items-center gap-4">
+                <a href={`/project/${project.id}`} className="w-40 truncate text-sm hover:underline">
+                  {project.title}
+                </a>
+                <Sparkline values={project.series} height={24} className="flex-1 h-6" label={`${project.total} views`} />
+                <span className="w-12 text-right text-sm font-medium">{project.total.toLocaleString()}</span>
+              </div>
+            ))}
+          </div>
+        )}
+      </CardContent>
+    </Card>
+  );
+}
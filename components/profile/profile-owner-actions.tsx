@@ -0,0 +1,20 @@
+'use client';
+
+import { useRouter } from 'next/navigation';
+import { Button } from '@/components/ui/button';
+import { Edit } from 'lucide-react';
+import { useAuth } from '@/hooks/use-auth';
+
+// Owner-only controls in the server-rendered profile header.
+export default function ProfileOwnerActions({ profileId }: { profileId: string }) {
+  const router = useRouter();
+  const { user: loggedInUser } = useAuth();
+
+  if (loggedInUser?.uid !== profileId) return null;
+
+  return (
+    <div className="flex items-center gap-2 mt-4 md:mt-0">
+      <Button onClick={() => router.push('/dashboard/profile')} variant="outline"><Edit className="h-4 w-4 mr-2" /> Edit Profile</Button>
+    </div>
+  );
+}
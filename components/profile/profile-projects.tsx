@@ -0,0 +1,151 @@
+'use client';
+
+import { useState, useCallback } from 'react';
+import { useRouter } from 'next/navigation';
+import { Card, CardContent } from '@/components/ui/card';
+import { Button } from '@/components/ui/button';
+import { ProjectCard } from '@/components/project-card';
+import { VirtualGrid } from '@/components/virtual-grid';
+import { User, Pin, Grid3x3, LayoutGrid, PlusCircle, Loader2 } from 'lucide-react';
+import { useAuth } from '@/hooks/use-auth';
+import { useApiQuery } from '@/hooks/use-api-query';
+import { deleteProject, loadMoreProfileProjects, profileQuery, toggleProjectPin } from '@/lib/api';
+import { Toaster, toast } from 'sonner';
+import type { ProfileProject, PublicProfile } from '@/types/project';
+
+// Card chrome below the 16:9 thumbnail, and the compact row, in px.
+const CARD_BODY_HEIGHT = 170;
+const COMPACT_ROW_HEIGHT = 96;
+
+interface ProfileProjectsProps {
+  profileId: string;
+  username: string;
+  initialProfile: PublicProfile;
+}
+
+/**
+ * Interactive half of the profile page: layout toggle plus the owner's pin
+ * and delete actions. Starts from the server-rendered first page and, for
+ * the owner only, refetches with a token so private projects appear too.
+ * Further pages load as the virtualized grid nears its end.
+ */
+export default function ProfileProjects({ profileId, username, initialProfile }: ProfileProjectsProps) {
+  const router = useRouter();
+  const { user: loggedInUser, loading: authLoading } = useAuth();
+  const [layoutMode, setLayoutMode] = useState<'grid' | 'compact'>('grid');
+
+  const isOwnProfile = loggedInUser?.uid === profileId;
+
+  // Visitors seed the shared cache with the server render; the owner's view
+  // differs (private projects), so it waits for auth and fetches its own.
+  const { data } = useApiQuery(profileQuery(username), {
+    enabled: !authLoading,
+    initialData: isOwnProfile || authLoading ? undefined : initialProfile,
+  });
+  const profile = (isOwnProfile ? data : data ?? initialProfile) ?? initialProfile;
+  const { allProjects: projects, pinnedProjects, nextCursor, projectCount } = profile;
+
+  const handleEndReached = useCallback(() => {
+    if (!nextCursor) return;
+    loadMoreProfileProjects(username).catch(err => {
+      toast.error("Couldn't load more projects", { description: err.message });
+    });
+  }, [username, nextCursor]);
+
+  const handlePinToggle = async (projectId: string) => {
+    if (!loggedInUser) return;
+
+    const isCurrentlyPinned = pinnedProjects.some(p => p.id === projectId);
+    if (!isCurrentlyPinned && pinnedProjects.length >= 4) {
+      toast.error("Cannot Pin Project", { description: "You can only pin a maximum of 4 projects." });
+      return;
+    }
+
+    try {
+      await toggleProjectPin(projectId);
+      toast.success(isCurrentlyPinned ? "Project unpinned" : "Project pinned");
+    } catch (err: any) {
+      toast.error("Update Failed", { description: err.message });
+    }
+  };
+
+  const handleDeleteProject = async (projectId: string) => {
+    if (!loggedInUser) return;
+
+    toast.promise(
+      async () => {
+        await deleteProject(projectId);
+        router.refresh();
+      },
+      {
+        loading: 'Deleting project...',
+        success: 'Project deleted successfully!',
+        error: (err) => err.message,
+      }
+    );
+  };
+
+  const renderCard = (project: ProfileProject, compact: boolean) => (
+    <ProjectCard project={{...project, stats: {...project.stats, downloads: project.stats.downloads || 0}}} isOwnProfile={isOwnProfile} onPinToggle={handlePinToggle} onDelete={handleDeleteProject} compact={compact} />
+  );
+
+  return (
+    <div className="lg:col-span-8 xl:col-span-9 space-y-8">
+      <Toaster position="top-center" richColors />
+
+      {pinnedProjects.length > 0 && (
+        <section>
+          <h2 className="text-2xl font-bold mb-4 text-slate-900 dark:text-slate-100 flex items-center gap-2"><Pin className="h-5 w-5" /> Pinned Projects</h2>
+          <div className="grid grid-cols-1 md:grid-cols-2 gap-4">
+            {pinnedProjects.map((project) => <div key={project.id}>{renderCard(project, false)}</div>)}
+          </div>
+        </section>
+      )}
+
+      <section>
+        <div className="flex justify-between items-center mb-4">
+          <h2 className="text-2xl font-bold text-slate-900 dark:text-slate-100">All Projects {projectCount > 0 && `(${projectCount})`}</h2>
+          <div className="flex items-center gap-2">
+            {projects.length > 0 && (
+              <>
+                <Button size="sm" variant={layoutMode === 'grid' ? 'default' : 'outline'} onClick={() => setLayoutMode('grid')} className="h-8"><Grid3x3 className="h-4 w-4" /></Button>
+                <Button size="sm" variant={layoutMode === 'compact' ? 'default' : 'outline'} onClick={() => setLayoutMode('compact')} className="h-8"><LayoutGrid className="h-4 w-4" /></Button>
+              </>
+            )}
+            {isOwnProfile && <Button onClick={() => router.push('/project/create')}><PlusCircle className="h-4 w-4 mr-2" /> Create</Button>}
+          </div>
+        </div>
+
+        {projects.length > 0 ? (
+          <>
+            <VirtualGrid
+              // Remount on layout change so the measured column count resets.
+              key={layoutMode}
+              items={projects}
+              getKey={(project) => project.id}
+              minColumnWidth={layoutMode === 'compact' ? Number.MAX_SAFE_INTEGER : 280}
+              rowHeight={layoutMode === 'compact' ? COMPACT_ROW_HEIGHT : (w) => Math.round(w * 9 / 16) + CARD_BODY_HEIGHT}
+              gap={layoutMode === 'compact' ? 12 : 16}
+              onEndReached={handleEndReached}
+              renderItem={(project) => renderCard(project, layoutMode === 'compact')}
+            />
+            {nextCursor && (
+              <div className="flex justify-center py-4 text-slate-500">
+                <Loader2 className="h-5 w-5 animate-spin" />
+              </div>
+            )}
+          </>
+        ) : (
+          <Card className="border-2 border-dashed">
+            <CardContent className="flex flex-col items-center justify-center py-16">
+              <User className="h-12 w-12 text-slate-400 mb-4" />
+              <h3 className="text-lg font-medium text-slate-900 dark:text-slate-100">No Projects Yet</h3>
+              <p className="text-slate-600 dark:text-slate-400 text-center mt-2">Ready to showcase your work? Create your first project!</p>
+              {isOwnProfile && <Button className="mt-4" onClick={() => router.push('/project/create')}><PlusCircle className="h-4 w-4 mr-2" /> Create Your First Project</Button>}
+            </CardContent>
+          </Card>
+        )}
+      </section>
+    </div>
+  );
+}
@@ -0,0 +1,29 @@
+// --- Skeleton Loader for a smoother loading experience ---
+export default function ProfileSkeleton() {
+  return (
+    <div className="min-h-screen bg-slate-50 dark:bg-slate-900 animate-pulse">
+      <div className="h-48 md:h-64 bg-slate-200 dark:bg-slate-800"></div>
+      <div className="container mx-auto px-4 sm:px-6 lg:px-8 max-w-7xl">
+        <div className="relative -mt-16 md:-mt-20 mb-8">
+          <div className="flex flex-col md:flex-row md:items-end md:space-x-6">
+            <div className="h-32 w-32 md:h-40 md:w-40 rounded-full bg-slate-300 dark:bg-slate-700 border-4 border-white dark:border-slate-900"></div>
+            <div className="mt-4 md:mt-0 flex-grow">
+              <div className="h-10 w-48 bg-slate-300 dark:bg-slate-700 rounded-md"></div>
+              <div className="h-6 w-32 bg-slate-200 dark:bg-slate-700 rounded-md mt-2"></div>
+            </div>
+          </div>
+        </div>
+        <div className="grid grid-cols-1 lg:grid-cols-12 gap-8">
+          <div className="lg:col-span-4 xl:col-span-3 space-y-6">
+            <div className="h-32 bg-slate-200 dark:bg-slate-800 rounded-lg"></div>
+            <div className="h-24 bg-slate-200 dark:bg-slate-800 rounded-lg"></div>
+            <div className="h-24 bg-slate-200 dark:bg-slate-800 rounded-lg"></div>
+          </div>
+          <div className="lg:col-span-8 xl:col-span-9 space-y-8">
+            <div className="h-64 bg-slate-200 dark:bg-slate-800 rounded-lg"></div>
+          </div>
+        </div>
+      </div>
+    </div>
+  );
+}
@@ -1,6 +1,7 @@
 "use client";
 
 import Link from "next/link";
+import Image from "next/image";
 import { Card, CardContent, CardHeader } from "@/components/ui/card";
 import { Button } from "@/components/ui/button";
 import { Avatar, AvatarFallback, AvatarImage } from "@/components/ui/avatar";
@@ -28,6 +29,8 @@ import {
 import { formatDistanceToNow } from "date-fns";
 import { useState } from "react";
 import { useRouter } from "next/navigation"; // Import useRouter
+import { useProjectPrefetch } from "@/hooks/use-project-prefetch";
+import { resizedImageUrl } from "@/lib/image-loader";
 
 // --- Interface Definitions ---
 interface Project {
@@ -80,6 +83,8 @@ export function ProjectCard({
 }: ProjectCardProps) {
   const [isImageLoading, setImageLoading] = useState(true);
   const router = useRouter(); // Initialize router
+  // 🚀 OPTIMIZATION: Warm project data (and the model, on hover) before the click
+  const prefetch = useProjectPrefetch<HTMLDivElement>(project.id);
 
   const handleDelete = (e: React.MouseEvent) => {
     e.preventDefault();
@@ -99,7 +104,10 @@ export function ProjectCard({
   // --- COMPACT LAYOUT ---
   if (compact) {
     return (
-      <div className="group relative flex w-full items-center space-x-4 rounded-lg border bg-card p-3 transition-all hover:bg-muted dark:hover:bg-slate-800/60">
+      <div
+        {...prefetch}
+        className="group relative flex w-full items-center space-x-4 rounded-lg border bg-card p-3 transition-all hover:bg-muted dark:hover:bg-slate-800/60"
+      >
         <Link
           href={`/project/${project.id}`}
           className="flex-shrink-0"
@@ -107,10 +115,11 @@ export function ProjectCard({
         >
           <div className="h-16 w-16 rounded-md bg-muted flex items-center justify-center overflow-hidden">
             {project.files.thumbnail?.url ? (
-              <img
+              <Image
                 src={project.files.thumbnail.url}
                 alt={project.title}
-                loading="lazy"
+                width={64}
+                height={64}
                 className="h-full w-full object-cover"
               />
             ) : (
@@ -198,7 +207,7 @@ export function ProjectCard({
 
   // --- GRID LAYOUT (REVAMPED) ---
   return (
-    <div className="group relative h-full w-full">
+    <div {...prefetch} className="group relative h-full w-full">
       <div className="absolute top-3 right-3 z-20 flex gap-2 opacity-0 group-hover:opacity-100 transition-opacity duration-300">
         {isOwnProfile && onPinToggle && (
           <Button
@@ -255,16 +264,17 @@ export function ProjectCard({
           aria-label={project.title}
         >
           <CardHeader className="p-0 border-b dark:border-slate-800">
-            <div className="aspect-video bg-muted flex items-center justify-center overflow-hidden">
+            <div className="relative aspect-video bg-muted flex items-center justify-center overflow-hidden">
               {isImageLoading && (
                 <div className="w-full h-full bg-slate-200 dark:bg-slate-800 animate-pulse"></div>
               )}
               {project.files.thumbnail?.url ? (
-                <img
+                <Image
                   src={project.files.thumbnail.url}
                   alt={project.title}
-                  loading="lazy"
-                  className={`h-full w-full object-cover transition-all duration-500 group-hover:scale-105 ${
+                  fill
+                  sizes="(min-width: 1280px) 25vw, (min-width: 768px) 50vw, 100vw"
+                  className={`object-cover transition-all duration-500 group-hover:scale-105 ${
                     isImageLoading ? "opacity-0" : "opacity-100"
                   }`}
                   onLoad={() => setImageLoading(false)}
@@ -306,7 +316,7 @@ export function ProjectCard({
               onClick={handleAuthorClick}
             >
               <Avatar className="h-8 w-8">
-                <AvatarImage src={project.authorAvatar} />
+                <AvatarImage src={resizedImageUrl(project.authorAvatar, 32)} />
                 <AvatarFallback>{project.authorName?.[0]}</AvatarFallback>
               </Avatar>
               <div>
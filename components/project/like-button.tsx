@@ -0,0 +1,72 @@
+"use client";
+
+import { useEffect, useState } from "react";
+import { useRouter } from "next/navigation";
+import { Heart } from "lucide-react";
+import { toast } from "sonner";
+import { useAuth } from "@/hooks/use-auth";
+import { getProjectLiked, setProjectLiked } from "@/lib/api";
+import { cn } from "@/lib/utils";
+
+interface LikeButtonProps {
+  projectId: string;
+  initialLikes: number;
+}
+
+// Client island inside the server-rendered project page: the count renders
+// statically, and the viewer's own like state is fetched once auth loads.
+export default function LikeButton({ projectId, initialLikes }: LikeButtonProps) {
+  const router = useRouter();
+  const { user, loading: authLoading } = useAuth();
+  const [liked, setLiked] = useState(false);
+  const [likes, setLikes] = useState(initialLikes);
+  const [pending, setPending] = useState(false);
+
+  useEffect(() => {
+    if (authLoading || !user) return;
+    let cancelled = false;
+    getProjectLiked(projectId)
+      .then(({ liked }) => { if (!cancelled) setLiked(liked); })
+      .catch(() => {});
+    return () => { cancelled = true; };
+  }, [projectId, user, authLoading]);
+
+  const toggle = async () => {
+    if (!user) {
+      router.push('/login');
+      return;
+    }
+    if (pending) return;
+
+    const next = !liked;
+    setLiked(next);
+    setLikes(count => Math.max(0, count + (next ? 1 : -1)));
+    setPending(true);
+    try {
+      const { changed } = await setProjectLiked(projectId, next);
+      if (!changed) setLikes(count => Math.max(0, count + (next ? -1 : 1)));
+    } catch {
+      setLiked(!next);
+      setLikes(count => Math.max(0, count + (next ? -1 : 1)));
+      toast.error('Could not update like. Please try again.');
+    } finally {
+      setPending(false);
+    }
+  };
+
+  return (
+    <button
+      type="button"
+      onClick={toggle}
+      aria-pressed={liked}
+      aria-label={liked ? 'Unlike project' : 'Like project'}
+      className="flex items-center gap-2 hover:text-rose-600 dark:hover:text-rose-400 transition-colors"
+    >
+      <Heart className={cn("h-4 w-4", liked && "fill-rose-500 text-rose-500")} />
+      <span className="font-semibold text-slate-900 dark:text-slate-100">
+        {likes.toLocaleString()}
+      </span>
+      <span>likes</span>
+    </button>
+  );
+}
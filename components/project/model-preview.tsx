@@ -0,0 +1,48 @@
+// /components/project/model-preview.tsx
+
+'use client';
+
+import { useEffect, useMemo } from 'react';
+import { Canvas } from '@react-three/fiber';
+import { OrbitControls, Center } from '@react-three/drei';
+import * as THREE from 'three';
+import type { ModelPreviewData } from '@/lib/upload/model-preview';
+
+interface ModelPreviewProps {
+  preview: ModelPreviewData;
+}
+
+// Lightweight local preview: geometry arrives pre-parsed from the preview worker,
+// so this only builds a BufferGeometry and draws it.
+export default function ModelPreview({ preview }: ModelPreviewProps) {
+  const geometry = useMemo(() => {
+    const g = new THREE.BufferGeometry();
+    g.setAttribute('position', new THREE.BufferAttribute(preview.positions, 3));
+    g.setAttribute('normal', new THREE.BufferAttribute(preview.normals, 3));
+    return g;
+  }, [preview]);
+
+  useEffect(() => () => geometry.dispose(), [geometry]);
+
+  // Frame the camera on the model whatever units the file uses.
+  const maxDimension = Math.max(...preview.dimensions, 1e-6);
+  const distance = maxDimension * 2;
+
+  return (
+    <Canvas
+      key={maxDimension}
+      camera={{ position: [distance * 0.6, distance * 0.5, distance], fov: 45, near: maxDimension / 1000, far: maxDimension * 100 }}
+      dpr={[1, 2]}
+      frameloop="demand"
+    >
+      <hemisphereLight intensity={0.6} color="#ffffff" groundColor="#444444" />
+      <directionalLight position={[5, 10, 7]} intensity={1.2} />
+      <Center>
+        <mesh geometry={geometry}>
+          <meshStandardMaterial color="#94a3b8" metalness={0.1} roughness={0.7} side={THREE.DoubleSide} />
+        </mesh>
+      </Center>
+      <OrbitControls makeDefault enableDamping={false} />
+    </Canvas>
+  );
+}
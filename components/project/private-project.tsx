@@ -0,0 +1,34 @@
+"use client";
+
+import { Loader2 } from "lucide-react";
+import { useAuth } from "@/hooks/use-auth";
+import { useApiQuery } from "@/hooks/use-api-query";
+import { projectQuery } from "@/lib/api";
+import ProjectView from "./project-view";
+import ProjectNotFound from "./project-not-found";
+
+// Fallback for projects the server could not render anonymously: private
+// projects are only returned to their owner, so fetch again with a token.
+export default function PrivateProject({ projectId }: { projectId: string }) {
+  const { user: loggedInUser, loading: authLoading } = useAuth();
+  const { data: project, error, isLoading } = useApiQuery(projectQuery(projectId), {
+    enabled: !authLoading && !!loggedInUser,
+  });
+
+  if (authLoading || (loggedInUser && isLoading)) {
+    return (
+      <div className="flex flex-col items-center justify-center min-h-screen bg-gradient-to-br from-slate-50 to-slate-100 dark:from-slate-950 dark:to-slate-900">
+        <Loader2 className="w-8 h-8 animate-spin mb-4 text-blue-500" />
+        <p className="text-slate-600 dark:text-slate-400">
+          {authLoading ? "Checking authentication..." : "Loading project..."}
+        </p>
+      </div>
+    );
+  }
+
+  if (!project) {
+    return <ProjectNotFound message={error?.message} />;
+  }
+
+  return <ProjectView project={project} />;
+}
@@ -0,0 +1,52 @@
+"use client";
+
+import { useRouter } from "next/navigation";
+import { Button } from "@/components/ui/button";
+import { useAuth } from "@/hooks/use-auth";
+import { ChevronLeft, Edit } from "lucide-react";
+import ShareButton from "@/components/share-button";
+
+interface ProjectActionsProps {
+  projectId: string;
+  ownerId: string;
+  title: string;
+  description: string;
+  authorName: string;
+}
+
+// Header bar of the project page. The edit button is owner-only, so it is
+// resolved client-side once auth has loaded.
+export default function ProjectActions({ projectId, ownerId, title, description, authorName }: ProjectActionsProps) {
+  const router = useRouter();
+  const { user: loggedInUser } = useAuth();
+  const isOwner = loggedInUser?.uid === ownerId;
+
+  return (
+    <div className="flex items-center justify-between mb-6">
+      <Button 
+        variant="ghost" 
+        onClick={() => router.back()}
+        className="gap-2 text-slate-600 hover:text-slate-900 dark:text-slate-400 dark:hover:text-slate-100"
+      >
+        <ChevronLeft className="h-4 w-4" />
+        Back
+      </Button>
+      
+      <div className="flex gap-3">
+        <ShareButton 
+          title={title}
+          description={description}
+          authorName={authorName}
+          size="sm"
+          variant="outline"
+        />
+        {isOwner && (
+          <Button onClick={() => router.push(`/project/edit/${projectId}`)} size="sm" className="gap-2">
+            <Edit className="h-4 w-4" />
+            Edit Project
+          </Button>
+        )}
+      </div>
+    </div>
+  );
+}
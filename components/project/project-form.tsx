@@ -1,7 +1,8 @@
 'use client';
 
-import { useState, useRef } from 'react';
+import { useState, useRef, useEffect } from 'react';
 import { useRouter } from 'next/navigation';
+import dynamic from 'next/dynamic';
 import { Button } from '@/components/ui/button';
 import { Input } from '@/components/ui/input';
 import { Label } from '@/components/ui/label';
@@ -10,7 +11,21 @@ import { Card, CardContent, CardDescription, CardHeader, CardTitle } from '@/com
 import { Badge } from '@/components/ui/badge';
 import { Progress } from '@/components/ui/progress';
 import { Upload, X, File, Loader2, CheckCircle, FileImage, Trash2 } from 'lucide-react';
-import { useAuth } from '@/hooks/use-auth'; // Assuming this hook provides user authentication
+import { compressStlToGlb, type CompressedModel } from '@/lib/upload/compress-model';
+import { resizeImageForUpload } from '@/lib/upload/resize-image';
+import { createProject } from '@/lib/api';
+import {
+  parseModelPreview,
+  disposeModelPreviewWorker,
+  PREVIEWABLE_MODEL_EXTENSIONS,
+  type ModelPreviewData
+} from '@/lib/upload/model-preview';
+
+// 🚀 OPTIMIZATION: three.js is only loaded once there is a model to preview
+const ModelPreview = dynamic(() => import('./model-preview'), {
+  ssr: false,
+  loading: () => <div className="h-full w-full animate-pulse bg-gray-100 dark:bg-gray-900" />
+});
 
 // Define allowed file extensions for project files
 const ALLOWED_PROJECT_FILE_EXTENSIONS = [
@@ -35,12 +50,19 @@ interface ProjectFile {
   preview?: string; // Only used for image previews, though not strictly needed for project files here
 }
 
+interface LocalModelPreview {
+  file: File;
+  data?: ModelPreviewData;
+  error?: string;
+}
+
 interface ProjectFormData {
   title: string;
   description: string;
   tags: string[];
   isPublic: boolean;
   allowDownloads: boolean;
+  compressModel: boolean;
 }
 
 export default function ProjectForm() {
@@ -49,7 +71,8 @@ export default function ProjectForm() {
     description: '',
     tags: [],
     isPublic: true,
-    allowDownloads: true
+    allowDownloads: true,
+    compressModel: true
   });
   
   const [files, setFiles] = useState<ProjectFile[]>([]);
@@ -58,13 +81,37 @@ export default function ProjectForm() {
   const [currentTag, setCurrentTag] = useState('');
   const [isUploading, setIsUploading] = useState(false);
   const [uploadProgress, setUploadProgress] = useState(0);
+  const [uploadStage, setUploadStage] = useState('Uploading and processing files...');
+  const [modelPreview, setModelPreview] = useState<LocalModelPreview | null>(null);
   const [error, setError] = useState('');
   const fileInputRef = useRef<HTMLInputElement>(null); // Ref for file input
   const bannerInputRef = useRef<HTMLInputElement>(null); // Ref for banner input
   
-  const { user } = useAuth(); // Get authenticated user from your auth hook
   const router = useRouter();
 
+  // ✅ NEW: Parse the first model file in a worker and preview it before anything is uploaded
+  const previewFile = files.find(f => {
+    const extension = f.file.name.split('.').pop()?.toLowerCase() ?? '';
+    return f.type === 'model' && PREVIEWABLE_MODEL_EXTENSIONS.includes(extension);
+  })?.file ?? null;
+
+  useEffect(() => {
+    if (!previewFile) {
+      setModelPreview(null);
+      return;
+    }
+
+    let cancelled = false;
+    setModelPreview({ file: previewFile });
+    parseModelPreview(previewFile)
+      .then(data => { if (!cancelled) setModelPreview({ file: previewFile, data }); })
+      .catch(err => { if (!cancelled) setModelPreview({ file: previewFile, error: err.message }); });
+
+    return () => { cancelled = true; };
+  }, [previewFile]);
+
+  useEffect(() => disposeModelPreviewWorker, []);
+
   // Helper function to censor bad words in a string
   const censorText = (text: string): string => {
     let censored = text;
@@ -240,15 +287,37 @@ export default function ProjectForm() {
       uploadData.append('isPublic', formData.isPublic.toString());
       uploadData.append('allowDownloads', formData.allowDownloads.toString());
       
+      // 🚀 OPTIMIZATION: Draco-compress the primary STL in a worker before upload.
+      // The API treats the first STL as the model, validates the GLB and skips its own conversion.
+      const stlFiles = files.filter(f => f.file.name.toLowerCase().endsWith('.stl'));
+      const primaryStl = stlFiles[0]?.file;
+      let compressed: CompressedModel | null = null;
+
+      if (formData.compressModel && primaryStl) {
+        setUploadStage('Compressing 3D model...');
+        compressed = await compressStlToGlb(primaryStl);
+        setUploadStage('Uploading and processing files...');
+      }
+
+      // The raw STL is still needed when it is downloadable, or when the server would
+      // otherwise pick a different STL as the model.
+      const sendPrimaryStl = !compressed || formData.allowDownloads || stlFiles.length > 1;
+
       files.forEach((fileObj) => {
+        if (fileObj.file === primaryStl && !sendPrimaryStl) return;
         uploadData.append(`projectFiles`, fileObj.file); // Use a consistent name for backend
       });
 
-      if (bannerFile) {
-        uploadData.append('bannerImage', bannerFile); // Append banner file
+      if (compressed) {
+        uploadData.append('modelGlb', compressed.file);
+        uploadData.append('modelSourceName', primaryStl!.name);
+        uploadData.append('modelSourceSize', compressed.originalSize.toString());
       }
 
-      const token = await user?.getIdToken(); // Get auth token
+      if (bannerFile) {
+        // 🚀 OPTIMIZATION: Shrink to the stored banner size in the browser first
+        uploadData.append('bannerImage', await resizeImageForUpload(bannerFile, 'banner')); // Append banner file
+      }
 
       // Simulate upload progress (replace with actual upload progress listener if available)
       let currentProgress = 0;
@@ -262,23 +331,10 @@ export default function ProjectForm() {
       }, 200);
       
       // Upload to backend
-      const response = await fetch(`${process.env.NEXT_PUBLIC_API_URL}/api/projects`, {
-        method: 'POST',
-        headers: {
-          'Authorization': `Bearer ${token}`
-          // 'Content-Type': 'multipart/form-data' is NOT needed for FormData, browser sets it automatically
-        },
-        body: uploadData
+      // The shared client cache drops the owner's profile and dashboard data so they show the new project
+      const result = await createProject(uploadData).finally(() => {
+        clearInterval(interval); // Clear interval once the request is complete
       });
-
-      clearInterval(interval); // Clear interval once fetch is complete
-
-      if (!response.ok) {
-        const errorData = await response.json();
-        throw new Error(errorData.message || 'Failed to create project. Please try again.');
-      }
-
-      const result = await response.json();
       setUploadProgress(100);
       
       // Redirect to project view
@@ -468,6 +524,39 @@ export default function ProjectForm() {
                       ))}
                     </div>
                   )}
+
+                  {/* Local Model Preview */}
+                  {modelPreview && (
+                    <div className="mt-4 rounded-lg border border-gray-200 dark:border-gray-800 overflow-hidden">
+                      <div className="h-56 bg-gray-50 dark:bg-gray-900">
+                        {modelPreview.data ? (
+                          <ModelPreview preview={modelPreview.data} />
+                        ) : (
+                          <div className="flex h-full items-center justify-center text-sm text-gray-500 dark:text-gray-400">
+                            {modelPreview.error ? (
+                              <span className="text-red-600 dark:text-red-400 px-4 text-center">
+                                Could not preview {modelPreview.file.name}: {modelPreview.error}
+                              </span>
+                            ) : (
+                              <>
+                                <Loader2 className="mr-2 h-4 w-4 animate-spin" />
+                                Reading {modelPreview.file.name}...
+                              </>
+                            )}
+                          </div>
+                        )}
+                      </div>
+                      {modelPreview.data && (
+                        <div className="flex flex-wrap items-center justify-between gap-2 px-3 py-2 text-xs text-gray-600 dark:text-gray-400 bg-white dark:bg-gray-950">
+                          <span className="truncate font-medium text-gray-900 dark:text-gray-100">{modelPreview.file.name}</span>
+                          <span>
+                            {modelPreview.data.triangleCount.toLocaleString()} triangles ·{' '}
+                            {modelPreview.data.dimensions.map(d => parseFloat(d.toFixed(2))).join(' × ')} units
+                          </span>
+                        </div>
+                      )}
+                    </div>
+                  )}
                 </div>
 
                 {/* Banner Image Upload */}
@@ -556,6 +645,21 @@ export default function ProjectForm() {
                   <p className="text-sm text-gray-500 dark:text-gray-400">Users will be able to download the project files you upload.</p>
                 </Label>
               </div>
+
+              <div className="flex items-center space-x-3">
+                <input
+                  type="checkbox"
+                  id="compressModel"
+                  name="compressModel"
+                  checked={formData.compressModel}
+                  onChange={handleInputChange}
+                  className="h-4 w-4 text-blue-600 border-gray-300 rounded focus:ring-blue-500 dark:bg-gray-800 dark:border-gray-600 dark:checked:bg-blue-600 dark:checked:border-transparent"
+                />
+                <Label htmlFor="compressModel" className="text-base text-gray-900 dark:text-gray-100 cursor-pointer">
+                  Compress 3D model before uploading
+                  <p className="text-sm text-gray-500 dark:text-gray-400">Converts binary STLs to a much smaller Draco GLB in your browser so uploads finish faster.</p>
+                </Label>
+              </div>
             </div>
 
             {/* Upload Progress */}
@@ -564,7 +668,7 @@ export default function ProjectForm() {
                 <div className="flex items-center space-x-2">
                   <Loader2 className="h-5 w-5 animate-spin text-blue-600" />
                   <span className="text-base text-gray-600 dark:text-gray-400 font-medium">
-                    Uploading and processing files...
+                    {uploadStage}
                   </span>
                 </div>
                 <Progress value={uploadProgress} className="w-full h-2 bg-gray-200 dark:bg-gray-700" />
@@ -0,0 +1,28 @@
+"use client";
+
+import { useRouter } from "next/navigation";
+import { Button } from "@/components/ui/button";
+import { AlertTriangle, ChevronLeft } from "lucide-react";
+
+export default function ProjectNotFound({ message }: { message?: string }) {
+  const router = useRouter();
+
+  return (
+    <div className="flex flex-col items-center justify-center min-h-screen bg-gradient-to-br from-slate-50 to-slate-100 dark:from-slate-950 dark:to-slate-900">
+      <AlertTriangle className="w-12 h-12 text-red-500 mb-4" />
+      <h2 className="text-xl font-semibold mb-2 dark:text-white">
+        Project Not Found
+      </h2>
+      <p className="text-slate-600 dark:text-slate-400 mb-6 text-center max-w-md">
+        {message || "This project may be private or does not exist."}
+      </p>
+      <div className="flex gap-4">
+        <Button variant="outline" onClick={() => router.back()}>
+          <ChevronLeft className="w-4 h-4 mr-2" />
+          Go Back
+        </Button>
+        <Button onClick={() => router.push("/")}>Go Home</Button>
+      </div>
+    </div>
+  );
+}
@@ -0,0 +1,128 @@
+// Full project page layout. Deliberately free of hooks and server-only APIs:
+// the server page renders it directly, and PrivateProject renders the same
+// markup client-side once an owner's private project has been fetched.
+
+import { Card, CardContent, CardHeader, CardTitle } from "@/components/ui/card";
+import { Badge } from "@/components/ui/badge";
+import { Avatar, AvatarFallback, AvatarImage } from "@/components/ui/avatar";
+import { Eye, Calendar, Lock, ExternalLink } from "lucide-react";
+import { formatDistanceToNow } from "date-fns";
+import ProjectActions from "./project-actions";
+import LikeButton from "./like-button";
+import ProjectWorkspace from "./project-workspace";
+import { resizedImageUrl } from "@/lib/image-loader";
+import type { ProjectData } from "@/types/project";
+
+export default function ProjectView({ project }: { project: ProjectData }) {
+  return (
+    <div className="min-h-screen bg-gradient-to-br from-slate-50 to-slate-100 dark:from-slate-950 dark:to-slate-900">
+      <div className="container mx-auto p-4 md:p-8 max-w-7xl">
+        {/* Header with Navigation */}
+        <ProjectActions
+          projectId={project.id}
+          ownerId={project.userId}
+          title={project.title}
+          description={project.description}
+          authorName={project.authorName}
+        />
+
+        {/* Project Hero Section */}
+        <div className="mb-8 space-y-6">
+          {/* Title and Author */}
+          <div className="flex flex-col lg:flex-row lg:items-start lg:justify-between gap-6">
+            <div className="space-y-4">
+              <div className="flex items-center gap-3 flex-wrap">
+                <h1 className="text-3xl sm:text-4xl lg:text-5xl font-bold tracking-tight text-slate-900 dark:text-slate-50">
+                  {project.title}
+                </h1>
+                {project.visibility === "private" && (
+                  <Badge variant="secondary" className="gap-1 bg-amber-100 text-amber-800 dark:bg-amber-900/50 dark:text-amber-300">
+                    <Lock className="h-3 w-3" />
+                    Private
+                  </Badge>
+                )}
+              </div>
+
+              {/* Author Card */}
+              <a
+                href={`/user/${project.username}`}
+                className="inline-flex items-center gap-3 group hover:bg-white/60 dark:hover:bg-slate-800/60 rounded-lg p-3 -ml-3 transition-all duration-200"
+              >
+                <Avatar className="h-12 w-12 ring-2 ring-slate-200 dark:ring-slate-700">
+                  <AvatarImage src={resizedImageUrl(project.authorAvatar, 48)} />
+                  <AvatarFallback className="text-lg font-semibold bg-gradient-to-br from-blue-500 to-purple-600 text-white">
+                    {project.authorName?.[0]?.toUpperCase()}
+                  </AvatarFallback>
+                </Avatar>
+                <div>
+                  <div className="font-semibold text-slate-900 dark:text-slate-100 group-hover:text-blue-600 dark:group-hover:text-blue-400 transition-colors">
+                    {project.authorName}
+                  </div>
+                  <div className="text-sm text-slate-500 dark:text-slate-400">
+                    @{project.username}
+                  </div>
+                </div>
+                <ExternalLink className="h-4 w-4 text-slate-400 opacity-0 group-hover:opacity-100 transition-opacity" />
+              </a>
+            </div>
+
+            {/* Stats */}
+            <div className="flex flex-wrap gap-6 text-sm text-slate-600 dark:text-slate-400">
+              <div className="flex items-center gap-2">
+                <Eye className="h-4 w-4" />
+                <span className="font-semibold text-slate-900 dark:text-slate-100">
+                  {project.stats.views.toLocaleString()}
+                </span>
+                <span>views</span>
+              </div>
+              <LikeButton projectId={project.id} initialLikes={project.stats.likes} />
+              <div className="flex items-center gap-2">
+                <Calendar className="h-4 w-4" />
+                <span>{formatDistanceToNow(new Date(project.createdAt))} ago</span>
+              </div>
+            </div>
+          </div>
+
+          {/* Tags */}
+          {project.tags.length > 0 && (
+            <div className="flex flex-wrap gap-2">
+              {project.tags.map((tag, i) => (
+                <Badge 
+                  key={i} 
+                  className="bg-blue-50 text-blue-700 hover:bg-blue-100 dark:bg-blue-900/50 dark:text-blue-300 dark:hover:bg-blue-900/70 border-0 cursor-pointer transition-colors"
+                >
+                  {tag}
+                </Badge>
+              ))}
+            </div>
+          )}
+        </div>
+
+        {/* Viewer, file browser and project info (client island) */}
+        <ProjectWorkspace initialProject={project} />
+
+        {/* Description Section - Positioned under viewer with matching layout */}
+        {project.description && (
+          <div className="mt-8">
+            <div className="grid grid-cols-1 xl:grid-cols-4 gap-8">
+              <div className="xl:col-span-3">
+                <Card className="bg-white/90 dark:bg-slate-900/90 backdrop-blur-sm border-slate-200 dark:border-slate-800 shadow-lg">
+                  <CardHeader>
+                    <CardTitle className="text-xl text-slate-900 dark:text-slate-100">About This Project</CardTitle>
+                  </CardHeader>
+                  <CardContent>
+                    <p className="text-base leading-relaxed text-slate-700 dark:text-slate-300">
+                      {project.description}
+                    </p>
+                  </CardContent>
+                </Card>
+              </div>
+              {/* Empty space to match sidebar layout */}
+              <div className="xl:col-span-1"></div>
+            </div>
+          </div>
+        )}
+      </div>
+    </div>
+  );
+}
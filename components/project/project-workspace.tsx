@@ -0,0 +1,387 @@
+"use client";
+
+import { useEffect, useState, useMemo, useCallback, Suspense, startTransition, useDeferredValue } from "react";
+import dynamic from "next/dynamic";
+import { Card, CardContent, CardHeader, CardTitle } from "@/components/ui/card";
+import { Badge } from "@/components/ui/badge";
+import { Button } from "@/components/ui/button";
+import { useApiQuery } from "@/hooks/use-api-query";
+import { projectQuery, recordProjectView } from "@/lib/api";
+import {
+  Download,
+  FileText,
+  FileCode,
+  FileVideo,
+  File as FileIcon,
+  Box,
+  Loader2,
+  AlertTriangle,
+  List,
+} from "lucide-react";
+import { supportsOffscreenCanvas } from "@/lib/three/offscreen-support";
+import { getPrefetchedModelUrl } from "@/lib/model-prefetch";
+import { reportVital } from "@/lib/vitals";
+import { getProjectFiles, type FileAttachment, type ProjectData } from "@/types/project";
+
+// 🚀 OPTIMIZATION: Dynamic imports for better code splitting
+const ModelViewer = dynamic(() => import("@/components/three/model-viewer"), {
+  ssr: false,
+  loading: () => <ViewerSkeleton type="3D Model" />
+});
+
+// 🚀 OPTIMIZATION: Renders in a Web Worker so parsing/drawing never blocks the page
+const OffscreenModelViewer = dynamic(() => import("@/components/three/offscreen-model-viewer"), {
+  ssr: false,
+  loading: () => <ViewerSkeleton type="3D Model" />
+});
+
+const PDFViewer = dynamic(() => import("@/components/PDF/PDF-viewer"), {
+  ssr: false,
+  loading: () => <ViewerSkeleton type="PDF Document" />
+});
+
+const CodeViewer = dynamic(() => import("@/components/CODE/code-viewer"), {
+  ssr: false,
+  loading: () => <ViewerSkeleton type="Code File" />
+});
+
+const VideoPlayer = dynamic(() => import("@/components/MP4/video-player"), {
+  ssr: false,
+  loading: () => <ViewerSkeleton type="Video" />
+});
+
+// Signed file URLs from the API last 15 minutes; refresh well before that.
+// FIX: A refetch can itself return a payload from the API's 5-minute project
+// cache, so the threshold leaves room for that on top of a safety margin.
+const SIGNED_URL_REFRESH_MS = 8 * 60 * 1000;
+
+const fileKey = (file: FileAttachment) => `${file.type}:${file.filename}`;
+const reportModelFirstFrame = (ms: number) => reportVital('MODEL_TTFF', ms);
+
+// 🚀 OPTIMIZATION: Loading skeleton for better UX
+function ViewerSkeleton({ type }: { type: string }) {
+  return (
+    <div className="flex flex-col items-center justify-center h-full bg-gradient-to-br from-slate-50 to-slate-100 dark:from-slate-900 dark:to-slate-800 animate-pulse">
+      <div className="w-16 h-16 bg-slate-300 dark:bg-slate-700 rounded-lg mb-4"></div>
+      <p className="text-slate-500 dark:text-slate-400">Loading {type}...</p>
+    </div>
+  );
+}
+
+// 🚀 OPTIMIZATION: File preloader for better LCP (Firebase Storage safe)
+function FilePreloader({ files }: { files: Array<{ url: string; type: string; priority?: boolean }> }) {
+  useEffect(() => {
+    files.forEach((file) => {
+      if (file.priority && file.url) {
+        const isFirebaseStorage = file.url.includes('firebasestorage.app') || 
+                                file.url.includes('googleapis.com') ||
+                                file.url.includes('storage.googleapis.com');
+        
+        if (isFirebaseStorage) {
+          // Skip prefetching for Firebase Storage - signed URLs already optimized
+          return;
+        }
+        
+        // Only preload non-Firebase files
+        const link = document.createElement('link');
+        link.rel = 'preload';
+        link.href = file.url;
+        link.as = 'fetch';
+        link.crossOrigin = 'anonymous';
+        document.head.appendChild(link);
+      }
+    });
+  }, [files]);
+
+  return null;
+}
+
+const Placeholder = ({
+  text,
+  icon: Icon,
+}: {
+  text: string;
+  icon: React.ComponentType<React.SVGProps<SVGSVGElement>>;
+}) => (
+  <div className="flex flex-col items-center justify-center h-full bg-gradient-to-br from-slate-50 to-slate-100 dark:from-slate-900 dark:to-slate-800 p-8 text-center">
+    <Icon className="w-16 h-16 text-slate-400 dark:text-slate-600 mb-4" />
+    <p className="text-slate-600 dark:text-slate-400">{text}</p>
+  </div>
+);
+
+const getFileIcon = (type: string) => {
+  const className = "w-5 h-5 flex-shrink-0";
+  switch (type) {
+    case "model":
+      return <Box className={`${className} text-blue-500`} />;
+    case "code":
+      return <FileCode className={`${className} text-green-500`} />;
+    case "documentation":
+      return <FileText className={`${className} text-yellow-500`} />;
+    case "video":
+      return <FileVideo className={`${className} text-red-500`} />;
+    default:
+      return <FileIcon className={`${className} text-slate-500`} />;
+  }
+};
+
+const formatFileSize = (bytes: number): string => {
+  if (bytes === 0) return "0 Bytes";
+  const k = 1024;
+  const sizes = ["Bytes", "KB", "MB", "GB"];
+  const i = Math.floor(Math.log(bytes) / Math.log(k));
+  return parseFloat((bytes / Math.pow(k, i)).toFixed(2)) + " " + sizes[i];
+};
+
+// 🚀 OPTIMIZATION: Enhanced error boundary for Firebase Storage issues
+// Mounted per file (keyed by fileKey), so refreshed signed URLs re-render it in place.
+function FileViewer({ file }: { file: FileAttachment }) {
+  // The model is downloaded once; a refreshed URL for the same file must not
+  // restart the viewer. Other viewers may fetch lazily and get the new URL.
+  const [loadedModelUrl] = useState(file.url);
+
+  try {
+    switch (file.type) {
+      case "model": {
+        // 🚀 OPTIMIZATION: Bytes prefetched from a project card skip the download
+        const modelUrl = getPrefetchedModelUrl(loadedModelUrl) ?? loadedModelUrl;
+        return supportsOffscreenCanvas()
+          ? <OffscreenModelViewer modelUrl={modelUrl} onFirstFrame={reportModelFirstFrame} />
+          : <ModelViewer modelUrl={modelUrl} onFirstFrame={reportModelFirstFrame} />;
+      }
+      case "documentation":
+        return <PDFViewer fileUrl={file.url} />;
+      case "code":
+        return <CodeViewer fileUrl={file.url} />;
+      case "video":
+        return <VideoPlayer fileUrl={file.url} />;
+      default:
+        return <Placeholder text="Preview not available." icon={FileIcon} />;
+    }
+  } catch (error) {
+    console.error('Viewer error:', error);
+    return (
+      <div className="flex flex-col items-center justify-center h-full bg-gradient-to-br from-slate-50 to-slate-100 dark:from-slate-900 dark:to-slate-800 p-8 text-center">
+        <AlertTriangle className="w-12 h-12 text-red-500 mb-4" />
+        <h3 className="text-lg font-semibold mb-2">Unable to load file</h3>
+        <p className="text-slate-500 dark:text-slate-400 mb-4">
+          There was an issue loading this file. This might be a temporary issue.
+        </p>
+        <Button 
+          variant="outline" 
+          size="sm" 
+          onClick={() => window.location.reload()}
+        >
+          Try Again
+        </Button>
+      </div>
+    );
+  }
+}
+
+/**
+ * Interactive part of the project page: viewer, file browser, conversion
+ * polling and the view counter. Everything else on the page is server-rendered.
+ */
+export default function ProjectWorkspace({ initialProject }: { initialProject: ProjectData }) {
+  // Seeded with the server-rendered payload. The shared cache refreshes it once
+  // its signed URLs get old, and polls while a model is being converted.
+  const { data } = useApiQuery(projectQuery(initialProject.id), {
+    initialData: initialProject,
+    initialDataUpdatedAt: initialProject.fetchedAt,
+    staleTime: SIGNED_URL_REFRESH_MS,
+    refetchInterval: (current) => (current?.conversionStatus?.inProgress ? 5000 : false),
+  });
+  const project = data ?? initialProject;
+  // Selection is tracked by identity, not URL, so refreshed URLs keep it.
+  const [selectedFileKey, setSelectedFileKey] = useState<string | null>(null);
+
+  // 🚀 OPTIMIZATION: React 19 - Use deferred value for better INP
+  const deferredProject = useDeferredValue(project);
+  const projectId = project.id;
+  const conversionInProgress = !!project.conversionStatus?.inProgress;
+
+  // 🚀 OPTIMIZATION: Debounced view count to reduce API calls
+  useEffect(() => {
+    const timeoutId = setTimeout(() => {
+      recordProjectView(projectId).catch(console.error);
+    }, 2000); // Wait 2 seconds before counting view
+
+    return () => clearTimeout(timeoutId);
+  }, [projectId]);
+
+  // 🚀 OPTIMIZATION: Memoized file list with deferred project
+  const allFiles = useMemo(() => getProjectFiles(deferredProject), [deferredProject]);
+  const activeFile = allFiles.find(f => fileKey(f) === selectedFileKey) ?? allFiles[0] ?? null;
+
+  // 🚀 OPTIMIZATION: Memoized preload files for LCP
+  const preloadFiles = useMemo(() => {
+    const files: Array<{ url: string; type: string; priority?: boolean }> = [];
+    if (project.files.model?.glb) {
+      files.push({
+        url: project.files.model.glb.url,
+        type: 'model',
+        priority: true // Preload main 3D model
+      });
+    }
+    return files;
+  }, [project]);
+
+  // 🚀 OPTIMIZATION: React 19 - Optimized file selection
+  const handleFileSelect = useCallback((file: FileAttachment) => {
+    startTransition(() => {
+      setSelectedFileKey(fileKey(file));
+    });
+  }, []);
+
+  const handleDownload = useCallback(async (fileUrl: string, filename: string): Promise<void> => {
+    try {
+      const response = await fetch(fileUrl);
+      const blob = await response.blob();
+      const url = window.URL.createObjectURL(blob);
+      const a = document.createElement("a");
+      a.href = url;
+      a.download = filename;
+      document.body.appendChild(a);
+      a.click();
+      window.URL.revokeObjectURL(url);
+      document.body.removeChild(a);
+    } catch (error) {
+      console.error("Download failed:", error);
+    }
+  }, []);
+
+  // FIX: Plain JSX, not a component defined here - a component type created
+  // during render is new on every render, which would remount the viewer and
+  // tear down its worker and GL context each time the project data updates.
+  const viewer = conversionInProgress ? (
+    <div className="flex flex-col items-center justify-center h-full bg-gradient-to-br from-slate-50 to-slate-100 dark:from-slate-900 dark:to-slate-800 p-8 text-center">
+      <Loader2 className="w-12 h-12 text-blue-500 animate-spin mb-4" />
+      <h3 className="text-lg font-semibold mb-2">Model is being processed...</h3>
+      <p className="text-slate-500 dark:text-slate-400">
+        This may take a moment. The page will update automatically.
+      </p>
+    </div>
+  ) : !activeFile ? (
+    <Placeholder text="Select a file to view." icon={List} />
+  ) : (
+    <Suspense fallback={<ViewerSkeleton type={activeFile.type} />}>
+      <FileViewer key={fileKey(activeFile)} file={activeFile} />
+    </Suspense>
+  );
+
+  return (
+    <>
+      {/* 🚀 OPTIMIZATION: Preload critical files for better LCP */}
+      <FilePreloader files={preloadFiles} />
+
+      {/* Main Content Grid */}
+      <div className="grid grid-cols-1 xl:grid-cols-4 gap-8">
+        {/* Viewer - Main Content */}
+        <div className="xl:col-span-3">
+          <Card className="overflow-hidden shadow-xl bg-white dark:bg-slate-900 border-slate-200 dark:border-slate-800 h-[500px] lg:h-[600px]">
+            {viewer}
+          </Card>
+        </div>
+
+        {/* Sidebar */}
+        <div className="xl:col-span-1 space-y-6">
+          {/* Project Quick Info */}
+          <Card className="bg-white/90 dark:bg-slate-900/90 backdrop-blur-sm border-slate-200 dark:border-slate-800 shadow-lg">
+            <CardHeader>
+              <CardTitle className="text-lg">Project Info</CardTitle>
+            </CardHeader>
+            <CardContent className="space-y-4">
+              <div className="space-y-3 text-sm">
+                <div className="flex items-center justify-between">
+                  <span className="text-slate-600 dark:text-slate-400">Downloads</span>
+                  <span className={`font-medium ${project.allowDownloads ? 'text-green-600 dark:text-green-400' : 'text-slate-500'}`}>
+                    {project.allowDownloads ? 'Enabled' : 'Disabled'}
+                  </span>
+                </div>
+                <div className="flex items-center justify-between">
+                  <span className="text-slate-600 dark:text-slate-400">Files</span>
+                  <span className="font-medium text-slate-900 dark:text-slate-100">
+                    {allFiles.length}
+                  </span>
+                </div>
+                <div className="flex items-center justify-between">
+                  <span className="text-slate-600 dark:text-slate-400">Visibility</span>
+                  <Badge variant={project.visibility === 'private' ? 'secondary' : 'outline'} className="text-xs">
+                    {project.visibility || 'public'}
+                  </Badge>
+                </div>
+              </div>
+            </CardContent>
+          </Card>
+
+          {/* Files List */}
+          <Card className="bg-white/90 dark:bg-slate-900/90 backdrop-blur-sm border-slate-200 dark:border-slate-800 shadow-lg">
+            <CardHeader>
+              <CardTitle className="text-lg flex items-center gap-2">
+                <List className="h-5 w-5" />
+                Files ({allFiles.length})
+              </CardTitle>
+            </CardHeader>
+            <CardContent>
+              {allFiles.length === 0 ? (
+                <div className="text-center py-8 text-slate-500">
+                  <FileIcon className="h-12 w-12 mx-auto mb-3 opacity-50" />
+                  <p>No files available</p>
+                </div>
+              ) : (
+                <div className="space-y-2 max-h-[400px] overflow-y-auto">
+                  {allFiles.map((file, i) => (
+                    <div
+                      key={i}
+                      className={`group p-3 rounded-lg border transition-all duration-200 hover:shadow-md ${
+                        activeFile?.url === file.url
+                          ? "bg-blue-50 border-blue-200 dark:bg-blue-900/20 dark:border-blue-700"
+                          : "bg-slate-50 border-slate-200 hover:bg-slate-100 dark:bg-slate-800/50 dark:border-slate-700 dark:hover:bg-slate-800"
+                      }`}
+                    >
+                      <div className="flex items-center gap-3">
+                        <button
+                          onClick={() => handleFileSelect(file)}
+                          className="flex items-center gap-3 flex-grow text-left min-w-0"
+                        >
+                          {getFileIcon(file.type)}
+                          <div className="min-w-0 flex-1">
+                            <p className="text-sm font-medium leading-tight truncate text-slate-900 dark:text-slate-100">
+                              {file.filename}
+                            </p>
+                            <p className="text-xs text-slate-500 dark:text-slate-400">
+                              {formatFileSize(file.size)}
+                            </p>
+                          </div>
+                        </button>
+
+                        {project.allowDownloads && (
+                          <Button
+                            onClick={() => {
+                              if (file.type === "model" && project.files.model?.stl) {
+                                handleDownload(project.files.model.stl.url, project.files.model.stl.filename);
+                              } else {
+                                handleDownload(file.url, file.filename);
+                              }
+                            }}
+                            size="sm"
+                            variant="ghost"
+                            className="opacity-0 group-hover:opacity-100 transition-opacity flex-shrink-0 h-8 w-8 p-0"
+                            title={`Download ${file.filename}`}
+                          >
+                            <Download className="h-4 w-4" />
+                          </Button>
+                        )}
+                      </div>
+                    </div>
+                  ))}
+                </div>
+              )}
+            </CardContent>
+          </Card>
+        </div>
+      </div>
+    </>
+  );
+}
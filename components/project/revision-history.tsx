@@ -0,0 +1,98 @@
+"use client";
+
+import { useEffect, useState } from "react";
+import { formatDistanceToNow } from "date-fns";
+import { History, Loader2, RotateCcw } from "lucide-react";
+import { toast } from "sonner";
+import { Button } from "@/components/ui/button";
+import { Card, CardContent, CardDescription, CardHeader, CardTitle } from "@/components/ui/card";
+import { listProjectRevisions, restoreProjectRevision, type ProjectRevision } from "@/lib/api";
+
+const REASON_LABELS: Record<ProjectRevision["reason"], string> = {
+  update: "Before edit",
+  patch: "Before edit",
+  restore: "Before restore",
+};
+
+const formatBytes = (bytes: number) =>
+  bytes < 1024 * 1024 ? `${Math.max(1, Math.round(bytes / 1024))} KB` : `${(bytes / 1024 / 1024).toFixed(1)} MB`;
+
+interface RevisionHistoryProps {
+  projectId: string;
+  /** Called after a successful restore. */
+  onRestored: () => void;
+}
+
+// Lists the project's saved revisions on the edit page. Each entry is the
+// state before an edit; restoring one is itself recorded, so it can be undone.
+export default function RevisionHistory({ projectId, onRestored }: RevisionHistoryProps) {
+  const [revisions, setRevisions] = useState<ProjectRevision[] | null>(null);
+  const [restoringId, setRestoringId] = useState<string | null>(null);
+
+  useEffect(() => {
+    listProjectRevisions(projectId)
+      .then(({ revisions }) => setRevisions(revisions))
+      .catch(() => setRevisions([]));
+  }, [projectId]);
+
+  const restore = async (revision: ProjectRevision) => {
+    if (!window.confirm("Restore this revision? The current version is kept in history.")) return;
+    setRestoringId(revision.id);
+    try {
+      await restoreProjectRevision(projectId, revision.id);
+      toast.success("Revision restored.");
+      onRestored();
+    } catch (error) {
+      toast.error(error instanceof Error ? error.message : "Could not restore revision.");
+    } finally {
+      setRestoringId(null);
+    }
+  };
+
+  if (revisions && revisions.length === 0) return null;
+
+  return (
+    <Card>
+      <CardHeader>
+        <CardTitle className="flex items-center gap-2">
+          <History className="h-5 w-5" />
+          History
+        </CardTitle>
+        <CardDescription>Earlier versions of this project. Only changed file content is stored.</CardDescription>
+      </CardHeader>
+      <CardContent>
+        {!revisions ? (
+          <Loader2 className="h-5 w-5 animate-spin text-gray-400" />
+        ) : (
+          <ul className="divide-y">
+            {revisions.map(revision => (
+              <li key={revision.id} className="flex items-center justify-between gap-4 py-3">
+                <div className="min-w-0">
+                  <p className="truncate text-sm font-medium">{revision.title || "Untitled"}</p>
+                  <p className="text-xs text-gray-500">
+                    {REASON_LABELS[revision.reason]} · {formatDistanceToNow(new Date(revision.createdAt))} ago ·{" "}
+                    {revision.fileCount} files, {formatBytes(revision.newBytes)} stored
+                  </p>
+                </div>
+                <Button
+                  type="button"
+                  variant="outline"
+                  size="sm"
+                  disabled={restoringId !== null}
+                  onClick={() => restore(revision)}
+                >
+                  {restoringId === revision.id ? (
+                    <Loader2 className="mr-2 h-4 w-4 animate-spin" />
+                  ) : (
+                    <RotateCcw className="mr-2 h-4 w-4" />
+                  )}
+                  Restore
+                </Button>
+              </li>
+            ))}
+          </ul>
+        )}
+      </CardContent>
+    </Card>
+  );
+}
@@ -0,0 +1,20 @@
+// /components/three/leva-theme.ts
+
+// Shared Leva panel styling for every viewer flavour.
+export const LEVA_THEME = {
+  colors: {
+    elevation1: 'rgba(0, 0, 0, 0.5)',
+    elevation2: 'hsl(222.2 84% 4.9%)',
+    elevation3: 'hsl(217.2 32.6% 17.5%)',
+    accent1: 'hsl(210 40% 96.1%)',
+    highlight1: 'hsl(210 40% 98%)',
+    highlight2: 'hsl(217.2 32.6% 17.5%)',
+    highlight3: 'hsl(215 20.2% 65.1%)',
+    folderWidgetColor: 'hsl(210 40% 98%)',
+    folderTextColor: 'hsl(210 40% 98%)'
+  },
+  space: { rowGap: '6px' },
+  sizes: { rootWidth: '280px' },
+  fontSizes: { root: '12px' },
+  radii: { sm: '8px' }
+};
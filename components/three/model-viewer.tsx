@@ -9,6 +9,7 @@ import { Leva, useControls, folder, button } from 'leva';
 import { Loader2, AlertTriangle, Download, Maximize2, Minimize2 } from 'lucide-react';
 import { Button } from '@/components/ui/button';
 import * as THREE from 'three';
+import { LEVA_THEME } from './leva-theme';
 
 // --- Type Definitions ---
 interface ModelViewerProps {
@@ -16,6 +17,8 @@ interface ModelViewerProps {
   className?: string;
   enableDownload?: boolean;
   onDownload?: () => void;
+  /** Reports milliseconds from load start until the model is first drawn. */
+  onFirstFrame?: (ms: number) => void;
 }
 
 // --- UI Components ---
@@ -37,9 +40,10 @@ const ErrorFallback = ({ error }: { error: Error }) => (
 );
 
 // --- Core Model Rendering Logic ---
-const Model = memo(({ url, onResetView }: { url:string; onResetView: () => void; }) => {
+const Model = memo(({ url, onResetView, onFirstFrame }: { url:string; onResetView: () => void; onFirstFrame?: () => void; }) => {
   const { scene } = useGLTF(url);
   const groupRef = useRef<THREE.Group>(null!);
+  const hasRenderedRef = useRef(false);
   const originalMaterialsRef = useRef<Map<string, THREE.Material | THREE.Material[]>>(new Map());
 
   // Leva controls for interactivity
@@ -101,6 +105,11 @@ const Model = memo(({ url, onResetView }: { url:string; onResetView: () => void;
   }, [scene, wireframe, clipping, clippingPlanes]);
 
   useFrame((_, delta) => {
+    // Runs just before the draw that first includes the loaded scene.
+    if (!hasRenderedRef.current) {
+      hasRenderedRef.current = true;
+      onFirstFrame?.();
+    }
     if (groupRef.current && autoRotate) {
       groupRef.current.rotation.y += delta * rotationSpeed * 0.25;
     }
@@ -117,7 +126,7 @@ const Model = memo(({ url, onResetView }: { url:string; onResetView: () => void;
 Model.displayName = 'Model';
 
 // --- Main Viewer Component ---
-const ModelViewer = ({ modelUrl, className = "", enableDownload = false, onDownload }: ModelViewerProps) => {
+const ModelViewer = ({ modelUrl, className = "", enableDownload = false, onDownload, onFirstFrame }: ModelViewerProps) => {
   const [error, setError] = useState<Error | null>(null);
   const [isFullscreen, setIsFullscreen] = useState(false);
   const containerRef = useRef<HTMLDivElement>(null!);
@@ -128,6 +137,14 @@ const ModelViewer = ({ modelUrl, className = "", enableDownload = false, onDownl
     setError(error instanceof Error ? error : new Error('An unknown error occurred'));
   }, []);
 
+  // Load timing restarts with each model; the Canvas is keyed on modelUrl too.
+  const loadStartedAt = useMemo(() => performance.now(), [modelUrl]);
+  const onFirstFrameRef = useRef(onFirstFrame);
+  onFirstFrameRef.current = onFirstFrame;
+  const handleFirstFrame = useCallback(() => {
+    onFirstFrameRef.current?.(performance.now() - loadStartedAt);
+  }, [loadStartedAt]);
+
   const handleResetView = useCallback(() => {
     if (controlsRef.current) {
       controlsRef.current.reset();
@@ -188,7 +205,7 @@ const ModelViewer = ({ modelUrl, className = "", enableDownload = false, onDownl
             <Environment preset="city" />
 
             <Suspense fallback={<LoadingSpinner />}>
-              <Model url={modelUrl} onResetView={handleResetView} />
+              <Model url={modelUrl} onResetView={handleResetView} onFirstFrame={handleFirstFrame} />
             </Suspense>
 
             <OrbitControls 
@@ -221,23 +238,7 @@ const ModelViewer = ({ modelUrl, className = "", enableDownload = false, onDownl
           titleBar={false}
           oneLineLabels
           hideCopyButton
-          theme={{
-            colors: {
-              elevation1: 'rgba(0, 0, 0, 0.5)',
-              elevation2: 'hsl(222.2 84% 4.9%)',
-              elevation3: 'hsl(217.2 32.6% 17.5%)',
-              accent1: 'hsl(210 40% 96.1%)',
-              highlight1: 'hsl(210 40% 98%)',
-              highlight2: 'hsl(217.2 32.6% 17.5%)',
-              highlight3: 'hsl(215 20.2% 65.1%)',
-              folderWidgetColor: 'hsl(210 40% 98%)',
-              folderTextColor: 'hsl(210 40% 98%)'
-            },
-            space: { rowGap: '6px' },
-            sizes: { rootWidth: '280px' },
-            fontSizes: { root: '12px' },
-            radii: { sm: '8px' }
-          }}
+          theme={LEVA_THEME}
         />
       </div>
     </div>
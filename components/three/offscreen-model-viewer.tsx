@@ -0,0 +1,259 @@
+// /components/three/offscreen-model-viewer.tsx
+
+'use client';
+
+import { useEffect, useState, useRef, useCallback } from 'react';
+import { Leva, useControls, folder, button } from 'leva';
+import { Loader2, AlertTriangle, Download, Maximize2, Minimize2 } from 'lucide-react';
+import { Button } from '@/components/ui/button';
+import { serializeEvent } from '@/lib/three/viewer-protocol';
+import type { ElementRect, ViewerWorkerRequest, ViewerWorkerResponse } from '@/lib/three/viewer-protocol';
+import type { ClipAxis } from '@/lib/three/viewer-core';
+import { LEVA_THEME } from './leva-theme';
+
+// --- Type Definitions ---
+interface OffscreenModelViewerProps {
+  modelUrl: string;
+  className?: string;
+  enableDownload?: boolean;
+  onDownload?: () => void;
+  /** Reports milliseconds from load start until the model is first drawn. */
+  onFirstFrame?: (ms: number) => void;
+}
+
+const POINTER_EVENTS = ['pointerdown', 'pointermove', 'pointerup', 'pointercancel'] as const;
+const KEY_EVENTS = ['keydown', 'keyup'] as const;
+
+const getRect = (el: Element): ElementRect => {
+  const { left, top, width, height } = el.getBoundingClientRect();
+  return { left, top, width, height };
+};
+
+// --- UI Components ---
+const LoadingOverlay = ({ progress }: { progress: number | null }) => (
+  <div className="absolute inset-0 flex items-center justify-center pointer-events-none">
+    <div className="flex flex-col items-center justify-center gap-4 bg-white/10 dark:bg-black/20 backdrop-blur-md p-8 rounded-xl shadow-2xl border border-white/20 dark:border-black/30">
+      <Loader2 className="h-12 w-12 animate-spin text-sky-400" />
+      <p className="text-base font-medium text-slate-800 dark:text-slate-200">
+        Loading 3D Model{progress !== null ? ` ${Math.round(progress * 100)}%` : '...'}
+      </p>
+    </div>
+  </div>
+);
+
+const ErrorFallback = ({ message }: { message: string }) => (
+  <div className="flex flex-col items-center justify-center h-full p-4 text-center bg-red-500/10">
+    <AlertTriangle className="w-12 h-12 text-red-500 mb-4" />
+    <h3 className="font-semibold text-red-600 dark:text-red-400">Failed to Load Model</h3>
+    <p className="text-sm text-slate-600 dark:text-slate-400 mt-2 max-w-xs">{message}</p>
+  </div>
+);
+
+/**
+ * Drop-in alternative to ModelViewer that renders in a dedicated worker via
+ * OffscreenCanvas. Scene, controls and GLB parsing all live off the main
+ * thread; this component only forwards input, layout and Leva settings.
+ */
+const OffscreenModelViewer = ({ modelUrl, className = "", enableDownload = false, onDownload, onFirstFrame }: OffscreenModelViewerProps) => {
+  const [failure, setFailure] = useState<{ url: string; message: string } | null>(null);
+  const [isLoading, setIsLoading] = useState(true);
+  const [progress, setProgress] = useState<number | null>(null);
+  const [isFullscreen, setIsFullscreen] = useState(false);
+  const containerRef = useRef<HTMLDivElement>(null!);
+  const canvasHostRef = useRef<HTMLDivElement>(null);
+  const workerRef = useRef<Worker | null>(null);
+  const onFirstFrameRef = useRef(onFirstFrame);
+  onFirstFrameRef.current = onFirstFrame;
+
+  const send = useCallback((message: ViewerWorkerRequest, transfer: Transferable[] = []) => {
+    workerRef.current?.postMessage(message, transfer);
+  }, []);
+
+  // Leva controls for interactivity (same panel as the main-thread viewer)
+  const options = useControls('Model Controls', {
+    'Scene': folder({
+      autoRotate: { value: false, label: 'Auto Rotate' },
+      rotationSpeed: { value: 0.5, min: 0.1, max: 5, step: 0.1, label: 'Speed', render: (get) => get('Model Controls.autoRotate') },
+    }),
+    'Appearance': folder({
+      wireframe: { value: false, label: 'Wireframe' },
+    }),
+    'Clipping': folder({
+      clipping: { value: false, label: 'Enable' },
+      clipAxis: { value: 'X', options: ['X', 'Y', 'Z'], label: 'Axis', render: (get) => get('Model Controls.clipping') },
+      clipPosition: { value: 0, min: -10, max: 10, step: 0.01, label: 'Position', render: (get) => get('Model Controls.clipping') },
+    }),
+    'Actions': folder({
+      resetView: button(() => send({ type: 'reset' })),
+    })
+  });
+  const optionsRef = useRef(options);
+  optionsRef.current = options;
+
+  // Errors belong to the model that produced them; switching files clears them.
+  const error = failure?.url === modelUrl ? failure.message : null;
+
+  // --- Worker lifecycle: one worker and one canvas per model ---
+  useEffect(() => {
+    const host = canvasHostRef.current;
+    if (!host) return;
+
+    // transferControlToOffscreen() is one-shot, so the canvas is created here
+    // rather than rendered by React; a re-run (new model, Strict Mode) gets a fresh one.
+    const canvas = document.createElement('canvas');
+    canvas.className = 'block w-full h-full touch-none outline-none';
+    canvas.tabIndex = 0;
+    host.appendChild(canvas);
+
+    setIsLoading(true);
+    setProgress(null);
+
+    const worker = new Worker(new URL('../../lib/three/viewer.worker.ts', import.meta.url), { type: 'module' });
+    workerRef.current = worker;
+
+    worker.onmessage = (e: MessageEvent<ViewerWorkerResponse>) => {
+      const message = e.data;
+      switch (message.type) {
+        case 'progress':
+          setProgress(message.progress.total ? message.progress.loaded / message.progress.total : null);
+          break;
+        case 'loaded':
+          setIsLoading(false);
+          break;
+        case 'first-frame':
+          onFirstFrameRef.current?.(message.ms);
+          break;
+        case 'error':
+          console.error('Offscreen viewer error:', message.message);
+          setFailure({ url: modelUrl, message: message.message });
+          setIsLoading(false);
+          break;
+      }
+    };
+    worker.onerror = (event) => {
+      console.error('Offscreen viewer worker crashed:', event);
+      setFailure({ url: modelUrl, message: event.message || 'The 3D viewer stopped unexpectedly.' });
+      setIsLoading(false);
+    };
+
+    const offscreen = canvas.transferControlToOffscreen();
+    const pixelRatio = () => Math.min(window.devicePixelRatio || 1, 2);
+    send({ type: 'init', canvas: offscreen, rect: getRect(canvas), pixelRatio: pixelRatio(), environment: true }, [offscreen]);
+
+    const { autoRotate, rotationSpeed, wireframe, clipping, clipAxis, clipPosition } = optionsRef.current;
+    send({ type: 'options', options: { autoRotate, rotationSpeed, wireframe, clipping, clipAxis: clipAxis as ClipAxis, clipPosition } });
+    send({ type: 'load', url: modelUrl });
+
+    // --- Input forwarding ---
+    const forward = (event: Event) => send({ type: 'event', event: serializeEvent(event) });
+    const onPointerDown = (event: PointerEvent) => {
+      canvas.setPointerCapture(event.pointerId);
+      forward(event);
+    };
+    const onPointerUp = (event: PointerEvent) => {
+      if (canvas.hasPointerCapture(event.pointerId)) canvas.releasePointerCapture(event.pointerId);
+      forward(event);
+    };
+    const onPreventedEvent = (event: Event) => {
+      event.preventDefault();
+      forward(event);
+    };
+
+    canvas.addEventListener('pointerdown', onPointerDown);
+    canvas.addEventListener('pointerup', onPointerUp);
+    POINTER_EVENTS.filter(t => t !== 'pointerdown' && t !== 'pointerup')
+      .forEach(type => canvas.addEventListener(type, forward));
+    canvas.addEventListener('wheel', onPreventedEvent, { passive: false });
+    canvas.addEventListener('contextmenu', onPreventedEvent);
+    // FIX: Keys only while the canvas has focus (it is focusable and takes
+    // focus on click), so typing in page inputs never reaches the controls.
+    KEY_EVENTS.forEach(type => canvas.addEventListener(type, forward));
+
+    // --- Layout forwarding ---
+    const resizeObserver = new ResizeObserver(() => {
+      send({ type: 'resize', rect: getRect(canvas), pixelRatio: pixelRatio() });
+    });
+    resizeObserver.observe(host);
+
+    return () => {
+      resizeObserver.disconnect();
+      canvas.removeEventListener('pointerdown', onPointerDown);
+      canvas.removeEventListener('pointerup', onPointerUp);
+      POINTER_EVENTS.filter(t => t !== 'pointerdown' && t !== 'pointerup')
+        .forEach(type => canvas.removeEventListener(type, forward));
+      canvas.removeEventListener('wheel', onPreventedEvent);
+      canvas.removeEventListener('contextmenu', onPreventedEvent);
+      KEY_EVENTS.forEach(type => canvas.removeEventListener(type, forward));
+
+      send({ type: 'dispose' });
+      // Give the worker a moment to release its GL context before killing it.
+      setTimeout(() => worker.terminate(), 1000);
+      workerRef.current = null;
+      canvas.remove();
+    };
+  }, [modelUrl, send]);
+
+  // Push Leva changes to the worker without re-rendering anything here.
+  const { autoRotate, rotationSpeed, wireframe, clipping, clipAxis, clipPosition } = options;
+  useEffect(() => {
+    send({
+      type: 'options',
+      options: { autoRotate, rotationSpeed, wireframe, clipping, clipAxis: clipAxis as ClipAxis, clipPosition },
+    });
+  }, [send, autoRotate, rotationSpeed, wireframe, clipping, clipAxis, clipPosition]);
+
+  const toggleFullscreen = useCallback(() => {
+    if (!containerRef.current) return;
+    if (!document.fullscreenElement) {
+      containerRef.current.requestFullscreen().catch(err => console.error(err));
+    } else {
+      document.exitFullscreen();
+    }
+  }, []);
+
+  useEffect(() => {
+    const handler = () => setIsFullscreen(!!document.fullscreenElement);
+    document.addEventListener('fullscreenchange', handler);
+    return () => document.removeEventListener('fullscreenchange', handler);
+  }, []);
+
+  return (
+    <div
+      ref={containerRef}
+      className={`relative w-full h-full ${className} ${isFullscreen ? 'fixed inset-0 z-50 bg-slate-950' : 'bg-slate-100 dark:bg-slate-900 rounded-lg border border-slate-200 dark:border-slate-800 overflow-hidden'}`}
+    >
+      <div className="relative w-full h-full">
+        <div ref={canvasHostRef} className={error ? 'hidden' : 'w-full h-full'} />
+        {error ? (
+          <ErrorFallback message={error} />
+        ) : (
+          isLoading && <LoadingOverlay progress={progress} />
+        )}
+      </div>
+
+      <div className="absolute top-3 right-3 flex gap-2 z-10">
+        {enableDownload && onDownload && (
+          <Button onClick={onDownload} size="icon" variant="ghost" className="h-8 w-8 text-slate-700 dark:text-white/70 hover:text-slate-900 dark:hover:text-white hover:bg-black/10 dark:hover:bg-white/20" title="Download model">
+            <Download className="h-4 w-4" />
+          </Button>
+        )}
+        <Button onClick={toggleFullscreen} size="icon" variant="ghost" className="h-8 w-8 text-slate-700 dark:text-white/70 hover:text-slate-900 dark:hover:text-white hover:bg-black/10 dark:hover:bg-white/20" title={isFullscreen ? "Exit fullscreen" : "Enter fullscreen"}>
+          {isFullscreen ? <Minimize2 className="h-4 w-4" /> : <Maximize2 className="h-4 w-4" />}
+        </Button>
+      </div>
+
+      <div className="absolute bottom-3 left-3 z-10">
+        <Leva
+          fill
+          flat
+          titleBar={false}
+          oneLineLabels
+          hideCopyButton
+          theme={LEVA_THEME}
+        />
+      </div>
+    </div>
+  );
+};
+
+export default OffscreenModelViewer;
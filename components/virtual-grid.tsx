@@ -0,0 +1,120 @@
+'use client';
+
+import { useEffect, useLayoutEffect, useRef, useState, type ReactNode } from 'react';
+
+interface VirtualGridProps<T> {
+  items: T[];
+  getKey: (item: T) => string;
+  renderItem: (item: T) => ReactNode;
+  /** Columns are as many as fit at this width, at least one. */
+  minColumnWidth: number;
+  /** Fixed row height, or derived from the current column width. */
+  rowHeight: number | ((columnWidth: number) => number);
+  gap?: number;
+  /** Extra rows rendered above and below the viewport. */
+  overscan?: number;
+  /** Called when the last rendered row comes within overscan of the viewport. */
+  onEndReached?: () => void;
+}
+
+const useIsomorphicLayoutEffect = typeof window === 'undefined' ? useEffect : useLayoutEffect;
+
+/**
+ * Grid that only mounts the rows intersecting the window viewport. The page
+ * keeps its normal scroll; the container reserves the full height and rows
+ * are absolutely positioned inside it.
+ */
+export function VirtualGrid<T>({
+  items,
+  getKey,
+  renderItem,
+  minColumnWidth,
+  rowHeight,
+  gap = 16,
+  overscan = 2,
+  onEndReached,
+}: VirtualGridProps<T>) {
+  const containerRef = useRef<HTMLDivElement>(null);
+  const [width, setWidth] = useState(0);
+  // Visible window in container coordinates; before the first measure we
+  // assume a typical viewport so the server render has content.
+  const [viewport, setViewport] = useState({ top: 0, bottom: 1000 });
+
+  useIsomorphicLayoutEffect(() => {
+    const el = containerRef.current;
+    if (!el) return;
+
+    let frame = 0;
+    const measure = () => {
+      frame = 0;
+      const rect = el.getBoundingClientRect();
+      setWidth(rect.width);
+      setViewport(prev => {
+        const top = -rect.top;
+        const bottom = top + window.innerHeight;
+        return prev.top === top && prev.bottom === bottom ? prev : { top, bottom };
+      });
+    };
+    const schedule = () => {
+      if (!frame) frame = requestAnimationFrame(measure);
+    };
+
+    measure();
+    const resizeObserver = new ResizeObserver(schedule);
+    resizeObserver.observe(el);
+    window.addEventListener('scroll', schedule, { passive: true });
+    window.addEventListener('resize', schedule);
+
+    return () => {
+      cancelAnimationFrame(frame);
+      resizeObserver.disconnect();
+      window.removeEventListener('scroll', schedule);
+      window.removeEventListener('resize', schedule);
+    };
+  }, []);
+
+  const columns = Math.max(1, Math.floor((width + gap) / (minColumnWidth + gap)));
+  const columnWidth = width ? (width - gap * (columns - 1)) / columns : minColumnWidth;
+  const height = typeof rowHeight === 'function' ? rowHeight(columnWidth) : rowHeight;
+  const stride = height + gap;
+  const rowCount = Math.ceil(items.length / columns);
+
+  const firstRow = Math.max(0, Math.floor(viewport.top / stride) - overscan);
+  const lastRow = Math.min(rowCount - 1, Math.ceil(viewport.bottom / stride) + overscan);
+
+  const reachedEnd = rowCount > 0 && lastRow >= rowCount - 1;
+  const onEndReachedRef = useRef(onEndReached);
+  onEndReachedRef.current = onEndReached;
+  useEffect(() => {
+    if (reachedEnd) onEndReachedRef.current?.();
+  }, [reachedEnd, items.length]);
+
+  const rows: ReactNode[] = [];
+  for (let row = firstRow; row <= lastRow; row++) {
+    const rowItems = items.slice(row * columns, row * columns + columns);
+    rows.push(
+      <div
+        key={row}
+        className="absolute left-0 right-0 grid"
+        style={{
+          top: row * stride,
+          height,
+          gap,
+          gridTemplateColumns: `repeat(${columns}, minmax(0, 1fr))`,
+        }}
+      >
+        {rowItems.map(item => (
+          <div key={getKey(item)} className="min-w-0 h-full">
+            {renderItem(item)}
+          </div>
+        ))}
+      </div>
+    );
+  }
+
+  return (
+    <div ref={containerRef} className="relative w-full" style={{ height: Math.max(0, rowCount * stride - gap) }}>
+      {rows}
+    </div>
+  );
+}
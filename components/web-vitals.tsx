@@ -0,0 +1,26 @@
+'use client';
+
+import { useEffect, useRef } from 'react';
+import { useReportWebVitals } from 'next/web-vitals';
+import { reportVital, type VitalName } from '@/lib/vitals';
+
+const REPORTED = new Set<VitalName>(['LCP', 'INP', 'CLS', 'TTFB']);
+
+/**
+ * Forwards Core Web Vitals to the API. Renders nothing. These metrics
+ * describe the document load, so they are attributed to the landing page
+ * even when they are finalized after a client-side navigation.
+ */
+export function WebVitals() {
+  const landingPath = useRef<string | undefined>(undefined);
+  useEffect(() => {
+    landingPath.current = window.location.pathname;
+  }, []);
+
+  useReportWebVitals((metric) => {
+    if (REPORTED.has(metric.name as VitalName)) {
+      reportVital(metric.name as VitalName, metric.value, landingPath.current);
+    }
+  });
+  return null;
+}
@@ -4,11 +4,15 @@ const rateLimit = require('express-rate-limit');
 const corsMiddleware = require('./middleware/cors'); // Assuming this handles your CORS configuration
 const { verifyFirebaseToken } = require('./middleware/auth'); // Correct destructuring import
 const projectRoutes = require('./routes/projects');
+const imageRoutes = require('./routes/images');
+const vitalsRoutes = require('./routes/vitals');
 const redisClient = require('./config/redis'); // Ensure this points to your Redis config
+const cacheWarmer = require('./services/cache-warmer');
 
 // Import routes
 const authRoutes = require('./routes/auth'); // Contains auth-related endpoints
 const userRoutes = require('./routes/users');
+const adminRoutes = require('./routes/admin');
 
 // Initialize Express app
 const app = express();
@@ -28,17 +32,37 @@ app.use(helmet());
 // Handles Cross-Origin Resource Sharing. Place before route handlers.
 app.use(corsMiddleware); // Ensure your corsMiddleware is correctly configured
 
-// 3. Rate Limiting
+// 3. Image variants and metrics
+// Mounted ahead of the API limiter: a single page requests dozens of images,
+// so they get a separate, much larger budget.
+const imageLimiter = rateLimit({
+  windowMs: 15 * 60 * 1000, // 15 minutes
+  max: 2000,
+  message: "Too many image requests from this IP, please try again after 15 minutes"
+});
+app.use('/api/images', imageLimiter, imageRoutes);
+
+// Every page view sends a metrics beacon, so these get their own budget too.
+const vitalsLimiter = rateLimit({
+  windowMs: 15 * 60 * 1000, // 15 minutes
+  max: 300,
+  message: "Too many metric reports from this IP, please try again after 15 minutes"
+});
+app.use('/api/vitals', vitalsLimiter, vitalsRoutes);
+
+// 4. Rate Limiting
 // Protects against brute-force attacks and abuse.
 const apiLimiter = rateLimit({
   windowMs: 15 * 60 * 1000, // 15 minutes
   max: 100, // Limit each IP to 100 requests per windowMs
-  message: "Too many requests from this IP, please try again after 15 minutes"
+  message: "Too many requests from this IP, please try again after 15 minutes",
+  // Startup cache warming replays hundreds of requests from loopback
+  skip: (req) => cacheWarmer.isWarmRequest(req)
 });
 // Apply the rate limiter globally or to specific routes/groups
 app.use(apiLimiter); // Applied globally here. Consider applying only to /api routes.
 
-// 4. Body Parsers
+// 5. Body Parsers
 // Parses incoming request bodies (JSON and URL-encoded data).
 app.use(express.json({ limit: '100mb' })); // For parsing application/json
 app.use(express.urlencoded({ extended: true, limit: '100mb' })); // For parsing application/x-www-form-urlencoded
@@ -50,8 +74,16 @@ app.use(express.urlencoded({ extended: true, limit: '100mb' })); // For parsing
 // =====================================================================
 
 // Health check endpoint (should typically be public)
+// Healthy as soon as it listens; cache warm-up progress is reported
+// alongside so deploys can wait for it if they choose. Scheduler and upload
+// internals are at /api/admin/status.
 app.get('/health', (req, res) => {
-  res.json({ status: 'OK', timestamp: new Date().toISOString() });
+  res.json({
+    status: 'OK',
+    timestamp: new Date().toISOString(),
+    redis: redisClient.isConnected ? 'connected' : 'disconnected',
+    cacheWarmup: cacheWarmer.status
+  });
 });
 
 // Example of another public route if you had one
@@ -81,6 +113,9 @@ app.use('/api/projects', projectRoutes);
 // This allows public access to user profiles while protecting sensitive endpoints.
 app.use('/api/users', userRoutes);
 
+// 4. Admin Routes (profiling and diagnostics, ADMIN_UIDS only)
+app.use('/api/admin', adminRoutes);
+
 // 2. Example of another authenticated route group
 // If you had other API routes that all require authentication, you would put
 // `verifyFirebaseToken` here for that specific group.
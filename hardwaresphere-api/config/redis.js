@@ -1,12 +1,110 @@
 const { createClient } = require("redis");
 
+// Every command goes through run(): it is skipped outright while Redis is
+// down or the circuit is open, and otherwise raced against a timeout, so a
+// degraded Redis costs callers at most COMMAND_TIMEOUT_MS before they take
+// their fallback path - and nothing at all once the breaker has tripped.
+//
+// Regular commands share one connection (node-redis pipelines concurrent
+// commands on it). A subscribed connection can't run anything else, so
+// pub/sub gets a dedicated connection, opened on first use.
+
+const COMMAND_TIMEOUT_MS = parseInt(process.env.REDIS_COMMAND_TIMEOUT_MS, 10) || 500;
+// Bulk writes and read-and-delete takes: giving up on these early risks
+// abandoning a result that was in fact applied.
+const SLOW_COMMAND_TIMEOUT_MS = 10000;
+const CONNECT_TIMEOUT_MS = 5000;
+const MAX_RECONNECT_DELAY_MS = 10000;
+
+// Consecutive failures that open the circuit, and how long it stays open
+// before one probe command is let through (doubling while probes fail).
+const BREAKER_THRESHOLD = 5;
+const BREAKER_COOLDOWN_MS = 2000;
+const BREAKER_MAX_COOLDOWN_MS = 60000;
+
+class CircuitBreaker {
+  constructor() {
+    this.state = "closed";
+    this.failures = 0;
+    this.cooldown = BREAKER_COOLDOWN_MS;
+    this.openUntil = 0;
+  }
+
+  /** Whether a command may be sent now. In half-open, admits a single probe. */
+  allowRequest() {
+    if (this.state === "closed") return true;
+    if (this.state === "open" && Date.now() >= this.openUntil) {
+      this.state = "half-open";
+      return true;
+    }
+    return false;
+  }
+
+  success() {
+    if (this.state !== "closed") console.log("✅ Redis circuit closed");
+    this.state = "closed";
+    this.failures = 0;
+    this.cooldown = BREAKER_COOLDOWN_MS;
+  }
+
+  failure() {
+    this.failures++;
+    if (this.state === "half-open") {
+      this.cooldown = Math.min(this.cooldown * 2, BREAKER_MAX_COOLDOWN_MS);
+      this.open();
+    } else if (this.state === "closed" && this.failures >= BREAKER_THRESHOLD) {
+      this.open();
+    }
+  }
+
+  open() {
+    this.state = "open";
+    this.openUntil = Date.now() + this.cooldown;
+    console.warn(`⚠️ Redis circuit open for ${this.cooldown}ms after ${this.failures} failures`);
+  }
+}
+
+// Compare-and-set on the owner, so an instance whose lease lapsed can't
+// extend or delete one another instance has since taken.
+const ACQUIRE_LEASE_SCRIPT = `
+if redis.call("GET", KEYS[1]) == ARGV[1] then
+  return redis.call("PEXPIRE", KEYS[1], ARGV[2])
+end
+if redis.call("SET", KEYS[1], ARGV[1], "NX", "PX", ARGV[2]) then return 1 end
+return 0`;
+
+const RELEASE_LEASE_SCRIPT = `
+if redis.call("GET", KEYS[1]) == ARGV[1] then return redis.call("DEL", KEYS[1]) end
+return 0`;
+
+/** Exponential backoff with jitter, so instances don't reconnect in lockstep. */
+const reconnectStrategy = (retries) => {
+  const ceiling = Math.min(MAX_RECONNECT_DELAY_MS, 100 * 2 ** retries);
+  return Math.round(ceiling / 2 + Math.random() * (ceiling / 2));
+};
+
+const withTimeout = (promise, ms) => {
+  let timer;
+  const timeout = new Promise((_, reject) => {
+    timer = setTimeout(() => reject(new Error(`timed out after ${ms}ms`)), ms);
+  });
+  return Promise.race([promise, timeout]).finally(() => clearTimeout(timer));
+};
+
 class RedisClient {
   constructor() {
     this.client = null;
-    this.isConnected = false;
+    this.ready = false;
+    this.breaker = new CircuitBreaker();
+    this.subscriber = null;
     this.isDevelopment = process.env.NODE_ENV === "development";
   }
 
+  /** Connected and not short-circuited. */
+  get isConnected() {
+    return this.ready && this.breaker.state !== "open";
+  }
+
   async connect() {
     // Skip Redis in development if no REDIS_URL is provided
     if (this.isDevelopment && !process.env.REDIS_URL) {
@@ -17,72 +115,321 @@ class RedisClient {
     try {
       this.client = createClient({
         url: process.env.REDIS_URL || "redis://localhost:6379",
+        socket: { connectTimeout: CONNECT_TIMEOUT_MS, reconnectStrategy },
+        // Fail commands immediately while disconnected instead of queueing them.
+        disableOfflineQueue: true,
       });
 
       this.client.on("error", (err) => {
-        console.error("Redis Client Error:", err);
-        this.isConnected = false;
+        console.error("Redis Client Error:", err.message);
+        this.ready = false;
       });
 
-      this.client.on("connect", () => {
+      this.client.on("ready", () => {
         console.log("✅ Redis connected successfully");
-        this.isConnected = true;
+        this.ready = true;
+        this.breaker.success();
+      });
+
+      this.client.on("reconnecting", () => {
+        this.ready = false;
       });
 
-      await this.client.connect();
+      // Initial connect retries in the background too; don't hold up startup.
+      const connecting = this.client.connect();
+      connecting.catch(() => {});
+      await withTimeout(connecting, CONNECT_TIMEOUT_MS);
       return this.client;
     } catch (error) {
-      console.error("❌ Redis connection failed:", error);
-      this.isConnected = false;
+      console.error("❌ Redis connection failed (retrying in background):", error.message);
+      this.ready = false;
       return null;
     }
   }
 
-  async get(key) {
-    if (!this.isConnected) return null; // Gracefully fallback
+  /**
+   * Sends one command (or MULTI) through the breaker and timeout.
+   * @param {string} label - for logs
+   * @param {*} fallback - returned when Redis is unavailable or the command fails
+   * @param {() => Promise<*>} command
+   * @param {number} [timeoutMs] - for commands known to be slow
+   */
+  async run(label, fallback, command, timeoutMs = COMMAND_TIMEOUT_MS) {
+    if (!this.ready || !this.breaker.allowRequest()) return fallback;
     try {
-      const value = await this.client.get(key);
-      return value ? JSON.parse(value) : null;
+      const result = await withTimeout(command(), timeoutMs);
+      this.breaker.success();
+      return result;
     } catch (error) {
-      console.error("Redis GET error:", error);
-      return null;
+      this.breaker.failure();
+      console.error(`Redis ${label} error:`, error.message);
+      return fallback;
     }
   }
 
-  async set(key, value, ttlSeconds = 300) {
-    if (!this.isConnected) return false; // Gracefully fallback
+  // --- Dedicated connections ---
+
+  async openDuplicate(name) {
+    const connection = this.client.duplicate();
+    connection.on("error", (err) => console.error(`Redis ${name} connection error:`, err.message));
+    await connection.connect();
+    return connection;
+  }
+
+  /** Connection reserved for subscriptions; a subscribed connection can't run other commands. */
+  async getSubscriber() {
+    if (!this.client) return null;
+    if (!this.subscriber) {
+      this.subscriber = this.openDuplicate("subscriber").catch((error) => {
+        this.subscriber = null;
+        throw error;
+      });
+    }
+    return this.subscriber;
+  }
+
+  async subscribe(channel, listener) {
     try {
-      await this.client.setEx(key, ttlSeconds, JSON.stringify(value));
+      const subscriber = await this.getSubscriber();
+      if (!subscriber) return false;
+      await subscriber.subscribe(channel, listener);
       return true;
     } catch (error) {
-      console.error("Redis SET error:", error);
+      console.error("Redis SUBSCRIBE error:", error.message);
       return false;
     }
   }
 
+  async publish(channel, message) {
+    return this.run("PUBLISH", false, async () => {
+      await this.client.publish(channel, typeof message === "string" ? message : JSON.stringify(message));
+      return true;
+    });
+  }
+
+  // --- Strings ---
+
+  async get(key) {
+    return this.run("GET", null, async () => {
+      const value = await this.client.get(key);
+      return value ? JSON.parse(value) : null;
+    });
+  }
+
+  async set(key, value, ttlSeconds = 300) {
+    return this.run("SET", false, async () => {
+      await this.client.setEx(key, ttlSeconds, JSON.stringify(value));
+      return true;
+    });
+  }
+
+  /** GET without JSON decoding, for values that are sent on as they are. */
+  async getRaw(key) {
+    return this.run("GET", null, () => this.client.get(key));
+  }
+
+  /** SET EX of a string that is already JSON (or otherwise final). */
+  async setRaw(key, value, ttlSeconds = 300) {
+    return this.run("SET", false, async () => {
+      await this.client.setEx(key, ttlSeconds, value);
+      return true;
+    });
+  }
+
+  /** SET NX EX: true only for the caller that created the key (a simple lock). */
+  async setIfAbsent(key, value, ttlSeconds) {
+    return this.run("SET NX", false, async () => {
+      const result = await this.client.set(key, JSON.stringify(value), { NX: true, EX: ttlSeconds });
+      return result === "OK";
+    });
+  }
+
   async del(key) {
-    if (!this.isConnected) return false;
-    try {
+    return this.run("DEL", false, async () => {
       await this.client.del(key);
       return true;
-    } catch (error) {
-      console.error("Redis DEL error:", error);
-      return false;
-    }
+    });
+  }
+
+  // --- Leases (leader election) ---
+
+  /**
+   * Takes `key` for `owner`, or extends it if `owner` already holds it.
+   * @returns {Promise<boolean>} whether `owner` holds the lease afterwards
+   */
+  async acquireLease(key, owner, ttlMs) {
+    return this.run("LEASE", false, async () => {
+      const held = await this.client.eval(ACQUIRE_LEASE_SCRIPT, { keys: [key], arguments: [owner, String(ttlMs)] });
+      return held === 1;
+    });
+  }
+
+  /** Deletes `key` only if `owner` still holds it. */
+  async releaseLease(key, owner) {
+    return this.run("LEASE RELEASE", false, async () => {
+      await this.client.eval(RELEASE_LEASE_SCRIPT, { keys: [key], arguments: [owner] });
+      return true;
+    });
+  }
+
+  // --- Hashes and sets (used for aggregated counters) ---
+
+  /**
+   * Increments several hash fields at once and refreshes the key's TTL.
+   * @param {string} key
+   * @param {Object<string, number>} increments - field -> amount
+   * @param {number} ttlSeconds
+   */
+  async hIncrByMany(key, increments, ttlSeconds) {
+    return this.run("HINCRBY", false, async () => {
+      const multi = this.client.multi();
+      Object.entries(increments).forEach(([field, amount]) => multi.hIncrBy(key, field, amount));
+      if (ttlSeconds) multi.expire(key, ttlSeconds);
+      await multi.exec();
+      return true;
+    });
+  }
+
+  /**
+   * Increments fields across several hashes in one round trip.
+   * @param {Array<{ key: string, field: string, amount: number, ttlSeconds?: number }>} increments
+   */
+  async hIncrByBatch(increments) {
+    return this.run("HINCRBY batch", false, async () => {
+      const multi = this.client.multi();
+      increments.forEach(({ key, field, amount, ttlSeconds }) => {
+        multi.hIncrBy(key, field, amount);
+        if (ttlSeconds) multi.expire(key, ttlSeconds);
+      });
+      await multi.exec();
+      return true;
+    });
+  }
+
+  /** HGETALL for several keys in one round trip; null when Redis is unavailable. */
+  async hGetAllMany(keys) {
+    if (keys.length === 0) return this.isConnected ? [] : null;
+    return this.run("HGETALL batch", null, () => {
+      const multi = this.client.multi();
+      keys.forEach(key => multi.hGetAll(key));
+      return multi.exec();
+    });
+  }
+
+  async hGet(key, field) {
+    // undefined = unknown, null = absent
+    return this.run("HGET", undefined, () => this.client.hGet(key, field));
+  }
+
+  /** Sets one field, or many when `fieldOrValues` is an object. */
+  async hSet(key, fieldOrValues, value) {
+    if (typeof fieldOrValues === "object" && Object.keys(fieldOrValues).length === 0) return this.isConnected;
+    return this.run("HSET", false, async () => {
+      if (typeof fieldOrValues === "object") {
+        await this.client.hSet(key, fieldOrValues);
+      } else {
+        await this.client.hSet(key, fieldOrValues, value);
+      }
+      return true;
+    });
+  }
+
+  async hDel(key, field) {
+    return this.run("HDEL", false, async () => {
+      await this.client.hDel(key, field);
+      return true;
+    });
+  }
+
+  async hGetAll(key) {
+    return this.run("HGETALL", null, () => this.client.hGetAll(key));
+  }
+
+  /** Reads and deletes a hash in one step, so each increment is consumed once. */
+  async hTakeAll(key) {
+    return this.run("HGETALL+DEL", null, async () => {
+      const [values] = await this.client.multi().hGetAll(key).del(key).exec();
+      return values;
+    }, SLOW_COMMAND_TIMEOUT_MS);
+  }
+
+  async sAdd(key, members, ttlSeconds) {
+    return this.run("SADD", false, async () => {
+      const multi = this.client.multi().sAdd(key, members);
+      if (ttlSeconds) multi.expire(key, ttlSeconds);
+      await multi.exec();
+      return true;
+    });
+  }
+
+  async sMembers(key) {
+    return this.run("SMEMBERS", [], () => this.client.sMembers(key));
+  }
+
+  async sRem(key, members) {
+    return this.run("SREM", false, async () => {
+      await this.client.sRem(key, members);
+      return true;
+    });
+  }
+
+  /** Membership of several values at once; null when Redis is unavailable. */
+  async sMIsMember(key, members) {
+    return this.run("SMISMEMBER", null, async () => {
+      const result = await this.client.smIsMember(key, members);
+      return result.map(Boolean);
+    });
+  }
+
+  /** Reads and deletes a set in one step. */
+  async sTakeAll(key) {
+    return this.run("SMEMBERS+DEL", [], async () => {
+      const [members] = await this.client.multi().sMembers(key).del(key).exec();
+      return members;
+    }, SLOW_COMMAND_TIMEOUT_MS);
+  }
+
+  // --- Sorted sets (hot-key tracking) ---
+
+  /** ZINCRBY for several members in one round trip. */
+  async zIncrByMany(key, increments) {
+    return this.run("ZINCRBY", false, async () => {
+      const multi = this.client.multi();
+      Object.entries(increments).forEach(([member, amount]) => multi.zIncrBy(key, amount, member));
+      await multi.exec();
+      return true;
+    });
+  }
+
+  /** Highest-scored members first. */
+  async zTop(key, count) {
+    return this.run("ZRANGE", [], () => this.client.zRange(key, 0, count - 1, { REV: true }));
+  }
+
+  /**
+   * Multiplies every score by `factor`, drops members that fall below
+   * `minScore` and keeps at most `maxMembers`.
+   */
+  async zDecay(key, factor, minScore, maxMembers) {
+    return this.run("ZDECAY", false, async () => {
+      await this.client.multi()
+        // node-redis v5 takes weights with the keys; a WEIGHTS option is ignored
+        .zUnionStore(key, [{ key, weight: factor }])
+        .zRemRangeByScore(key, "-inf", `(${minScore}`)
+        .zRemRangeByRank(key, 0, -(maxMembers + 1))
+        .exec();
+      return true;
+    }, SLOW_COMMAND_TIMEOUT_MS);
   }
 
   async flushPattern(pattern) {
-    if (!this.isConnected) return false;
-    try {
+    return this.run("FLUSH", false, async () => {
       const keys = await this.client.keys(pattern);
       if (keys.length > 0) {
         await this.client.del(keys);
       }
       return true;
-    } catch (error) {
-      console.error("Redis FLUSH error:", error);
-      return false;
-    }
+    }, SLOW_COMMAND_TIMEOUT_MS);
   }
 }
 
@@ -46,8 +46,18 @@ const optionalVerifyFirebaseToken = async (req, res, next) => {
   next();
 };
 
+// --- Operator-only endpoints: run after verifyFirebaseToken ---
+// Admins are listed by Firebase uid in ADMIN_UIDS (comma separated).
+const requireAdmin = (req, res, next) => {
+  const adminUids = (process.env.ADMIN_UIDS || '').split(',').map(uid => uid.trim()).filter(Boolean);
+  if (!req.user || !adminUids.includes(req.user.uid)) {
+    return res.status(403).json({ error: 'Admin access required' });
+  }
+  next();
+};
 
 module.exports = { 
   verifyFirebaseToken,
-  optionalVerifyFirebaseToken // <-- Export the new function
+  optionalVerifyFirebaseToken, // <-- Export the new function
+  requireAdmin
 };
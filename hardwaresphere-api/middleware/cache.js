@@ -1,9 +1,30 @@
 const redisClient = require('../config/redis');
+const cacheWarmer = require('../services/cache-warmer');
 
 // Generic cache middleware
-const cache = (keyGenerator, ttlSeconds = 300) => {
+// options.skip(req)               -> bypass the cache entirely for this request
+// options.shouldCache(data, req)  -> only store responses that are safe to share
+// options.warm                    -> count anonymous hits so the path is re-cached on startup
+//
+// Entries are stored as the JSON text that was sent and replayed verbatim,
+// so a hit costs no parse or stringify. On a miss, a route with a response
+// schema (middleware/serialize.js) is serialized once for both.
+const cache = (keyGenerator, ttlSeconds = 300, options = {}) => {
+  const { skip, shouldCache, warm } = options;
+
   return async (req, res, next) => {
     try {
+      if (skip && skip(req)) {
+        return next();
+      }
+
+      // 🚀 OPTIMIZATION: Only anonymous, shareable responses can be replayed by the warmer
+      // FIX: Record the path without its query string - the cache keys ignore it,
+      // so ?x=1..N variants would otherwise flood the hot set with duplicates.
+      const countHit = warm && !req.headers.authorization && !cacheWarmer.isWarmRequest(req)
+        ? () => cacheWarmer.record(req.baseUrl + req.path)
+        : () => {};
+
       // Generate cache key
       const cacheKey = typeof keyGenerator === 'function' 
         ? keyGenerator(req) 
@@ -12,11 +33,13 @@ const cache = (keyGenerator, ttlSeconds = 300) => {
       console.log(`🔍 Checking cache for key: ${cacheKey}`);
 
       // Try to get from cache
-      const cachedData = await redisClient.get(cacheKey);
+      const cachedBody = await redisClient.getRaw(cacheKey);
       
-      if (cachedData) {
+      if (cachedBody) {
         console.log(`✅ Cache HIT for key: ${cacheKey}`);
-        return res.json(cachedData);
+        countHit();
+        // 🚀 OPTIMIZATION: Send the stored JSON text as-is
+        return res.type('json').send(cachedBody);
       }
 
       console.log(`❌ Cache MISS for key: ${cacheKey}`);
@@ -24,13 +47,19 @@ const cache = (keyGenerator, ttlSeconds = 300) => {
       // Store original res.json to intercept response
       const originalJson = res.json;
       res.json = function(data) {
+        // Never cache error payloads or responses the route marks as private.
+        if (this.statusCode >= 400 || (shouldCache && !shouldCache(data, req))) {
+          return originalJson.call(this, data);
+        }
+
         // Cache the response data
-        redisClient.set(cacheKey, data, ttlSeconds)
+        countHit();
+        const body = this.serialize ? this.serialize(data) : JSON.stringify(data);
+        redisClient.setRaw(cacheKey, body, ttlSeconds)
           .then(() => console.log(`💾 Cached data for key: ${cacheKey}`))
           .catch(err => console.error('Cache SET error:', err));
         
-        // Call original res.json
-        return originalJson.call(this, data);
+        return this.type('json').send(body);
       };
 
       next();
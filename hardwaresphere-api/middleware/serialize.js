@@ -0,0 +1,29 @@
+const { compile } = require('../services/json-serializer');
+
+// Declares a route's response schema. Successful res.json() payloads are
+// written by a serializer compiled from it once, at startup (see
+// services/json-serializer.js), so only declared fields are sent. Error
+// payloads keep the generic path.
+//
+// Put it before the route's cache middleware: a cache miss then serializes
+// once and caches the very string it sends.
+const serializeWith = (schema) => {
+  const serialize = compile(schema);
+
+  return (req, res, next) => {
+    const originalJson = res.json;
+    res.serialize = serialize;
+    res.json = function(data) {
+      if (this.statusCode >= 400) {
+        return originalJson.call(this, data);
+      }
+      if (!this.get('Content-Type')) {
+        this.set('Content-Type', 'application/json');
+      }
+      return this.send(serialize(data));
+    };
+    next();
+  };
+};
+
+module.exports = { serializeWith };
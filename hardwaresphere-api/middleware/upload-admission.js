@@ -0,0 +1,159 @@
+const fs = require('fs').promises;
+
+// Admission control for multipart uploads, decided from Content-Length before
+// multer writes a byte to disk.
+//
+// An upload is admitted when this instance has a free slot, its in-flight
+// bytes stay under budget and the disk keeps MIN_FREE_DISK_MB after every
+// admitted upload lands. Otherwise it waits in a short FIFO queue; when the
+// queue is full or the wait runs out it gets a 503 with Retry-After instead
+// of competing for the disk. Requests that can never fit are refused outright.
+//
+// Each user may have MAX_UPLOADS_PER_USER uploads admitted or queued at once,
+// so one client can't take every slot. Slots are held until the response is
+// sent, which covers writing to disk and the upload to Storage.
+
+const MB = 1024 * 1024;
+const UPLOAD_ROOT = 'uploads/';
+const MAX_CONCURRENT_UPLOADS = parseInt(process.env.MAX_CONCURRENT_UPLOADS, 10) || 8;
+const MAX_UPLOADS_PER_USER = parseInt(process.env.MAX_UPLOADS_PER_USER, 10) || 2;
+const MAX_IN_FLIGHT_BYTES = (parseInt(process.env.MAX_IN_FLIGHT_UPLOAD_MB, 10) || 1024) * MB;
+const MIN_FREE_DISK_BYTES = (parseInt(process.env.MIN_FREE_DISK_MB, 10) || 2048) * MB;
+const MAX_REQUEST_BYTES = 20 * 100 * MB; // multer's file count x file size limits
+const SMALL_REQUEST_BYTES = MB; // field-only edits; not worth a slot
+const MAX_QUEUE_LENGTH = 20;
+const QUEUE_TIMEOUT_MS = 15000;
+const RETRY_AFTER_SECONDS = 10;
+
+const active = { count: 0, bytes: 0 };
+const perUser = new Map(); // uid (or IP) -> uploads admitted or queued
+const queue = [];
+const rejected = { tooLarge: 0, perUser: 0, diskFull: 0, busy: 0 };
+let diskFreeBytes = Infinity;
+
+async function refreshDiskFree() {
+  try {
+    await fs.mkdir(UPLOAD_ROOT, { recursive: true });
+    const stats = await fs.statfs(UPLOAD_ROOT);
+    diskFreeBytes = stats.bavail * stats.bsize;
+  } catch (error) {
+    console.warn('⚠️ Could not read free disk space:', error.message);
+  }
+}
+
+// In-flight uploads may not have reached the disk yet, so their full size is
+// counted against free space until they finish.
+const hasRoomOnDisk = (size) => diskFreeBytes - active.bytes - size >= MIN_FREE_DISK_BYTES;
+
+const hasCapacity = (size) =>
+  active.count < MAX_CONCURRENT_UPLOADS &&
+  (active.count === 0 || active.bytes + size <= MAX_IN_FLIGHT_BYTES) &&
+  hasRoomOnDisk(size);
+
+const reject = (res, status, code, error) => {
+  // The body was never read; don't keep the connection alive to drain it.
+  res.set('Connection', 'close');
+  if (status === 429 || status === 503) res.set('Retry-After', String(RETRY_AFTER_SECONDS));
+  return res.status(status).json({ error, code });
+};
+
+function releaseUser(uid) {
+  const count = (perUser.get(uid) || 1) - 1;
+  if (count > 0) perUser.set(uid, count);
+  else perUser.delete(uid);
+}
+
+function begin(entry) {
+  active.count++;
+  active.bytes += entry.size;
+  entry.res.once('close', () => {
+    active.count--;
+    active.bytes -= entry.size;
+    releaseUser(entry.uid);
+    refreshDiskFree().then(admitQueued);
+  });
+  entry.next();
+}
+
+// FIFO: a large upload at the head is not overtaken by smaller ones behind it.
+function admitQueued() {
+  while (queue.length > 0 && hasCapacity(queue[0].size)) {
+    const entry = queue.shift();
+    clearTimeout(entry.timer);
+    begin(entry);
+  }
+}
+
+const admitUpload = async (req, res, next) => {
+  const header = req.get('content-length');
+  if (header === undefined) {
+    return reject(res, 411, 'LENGTH_REQUIRED', 'Uploads must declare a Content-Length.');
+  }
+
+  // FIX: A malformed length must not pass as 0 bytes and skip the budgets
+  if (!/^\d+$/.test(header.trim())) {
+    return reject(res, 400, 'INVALID_CONTENT_LENGTH', 'Invalid Content-Length.');
+  }
+  const size = Number(header);
+  if (size < SMALL_REQUEST_BYTES) return next();
+
+  if (size > MAX_REQUEST_BYTES) {
+    rejected.tooLarge++;
+    return reject(res, 413, 'UPLOAD_TOO_LARGE', `Upload too large. Maximum is ${MAX_REQUEST_BYTES / MB}MB per request.`);
+  }
+
+  const uid = req.user?.uid || req.ip;
+  if ((perUser.get(uid) || 0) >= MAX_UPLOADS_PER_USER) {
+    rejected.perUser++;
+    return reject(res, 429, 'TOO_MANY_UPLOADS', `Only ${MAX_UPLOADS_PER_USER} uploads at a time. Please wait for one to finish.`);
+  }
+
+  await refreshDiskFree();
+  if (diskFreeBytes - size < MIN_FREE_DISK_BYTES) {
+    rejected.diskFull++;
+    console.warn(`⚠️ Upload refused: ${Math.round(diskFreeBytes / MB)}MB free on disk`);
+    return reject(res, 507, 'STORAGE_FULL', 'Server storage full. Please try again later.');
+  }
+
+  const entry = { uid, size, res, next };
+  perUser.set(uid, (perUser.get(uid) || 0) + 1);
+
+  if (queue.length === 0 && hasCapacity(size)) return begin(entry);
+
+  if (queue.length >= MAX_QUEUE_LENGTH) {
+    releaseUser(uid);
+    rejected.busy++;
+    return reject(res, 503, 'UPLOADS_BUSY', 'The server is busy with other uploads. Please try again shortly.');
+  }
+
+  console.log(`⏳ Upload queued (${Math.round(size / MB)}MB, ${queue.length + 1} waiting)`);
+  const leaveQueue = () => {
+    const index = queue.indexOf(entry);
+    if (index === -1) return false;
+    queue.splice(index, 1);
+    clearTimeout(entry.timer);
+    releaseUser(uid);
+    return true;
+  };
+  entry.timer = setTimeout(() => {
+    if (!leaveQueue()) return;
+    rejected.busy++;
+    reject(res, 503, 'UPLOADS_BUSY', 'The server is busy with other uploads. Please try again shortly.');
+  }, QUEUE_TIMEOUT_MS);
+  // Client gave up while waiting
+  res.once('close', leaveQueue);
+  queue.push(entry);
+};
+
+const getUploadAdmissionStats = () => ({
+  active: active.count,
+  queued: queue.length,
+  inFlightMB: Math.round(active.bytes / MB),
+  diskFreeMB: Number.isFinite(diskFreeBytes) ? Math.round(diskFreeBytes / MB) : null,
+  rejected
+});
+
+module.exports = {
+  admitUpload,
+  getUploadAdmissionStats
+};
@@ -1,12 +1,18 @@
 const multer = require('multer');
 const path = require('path');
 const fs = require('fs').promises;
+const { admitUpload } = require('./upload-admission');
+const { validatingDiskStorage } = require('./validating-storage');
 
 // Track uploaded temp files for cleanup safety net
 const tempFileTracker = new Set();
 
+const MAX_FILE_SIZE = 100 * 1024 * 1024; // 100MB max file size
+
 // IMPROVED: Better temp file organization
-const storage = multer.diskStorage({
+// ✅ NEW: Content is checked against the extension while it streams to disk
+const storage = validatingDiskStorage({
+  maxFileSize: MAX_FILE_SIZE,
   destination: async (req, file, cb) => {
     try {
       // Create organized temp directory structure
@@ -77,7 +83,7 @@ const fileFilter = (req, file, cb) => {
 const upload = multer({
   storage: storage,
   limits: {
-    fileSize: 100 * 1024 * 1024, // 100MB max file size
+    fileSize: MAX_FILE_SIZE,
     files: 20 // Max 20 files per request
   },
   fileFilter: fileFilter
@@ -261,8 +267,7 @@ async function emergencyCleanupOldTempFiles() {
   }
 }
 
-// Schedule periodic cleanup (every 30 minutes)
-setInterval(emergencyCleanupOldTempFiles, 30 * 60 * 1000);
+// Periodic cleanup is a scheduler job (see server.js)
 
 // Cleanup on process exit
 process.on('SIGTERM', async () => {
@@ -311,6 +316,15 @@ const handleUploadError = async (err, req, res, next) => {
     });
   }
   
+  if (err && err.code === 'INVALID_FILE_CONTENT') {
+    // Don't read the rest of a body that was rejected a few KB in
+    res.set('Connection', 'close');
+    return res.status(400).json({ 
+      error: err.message,
+      code: 'INVALID_FILE_CONTENT'
+    });
+  }
+  
   if (err && err.message && err.message.includes('ENOSPC')) {
     return res.status(507).json({ 
       error: 'Server storage full. Please try again later.',
@@ -333,16 +347,19 @@ const getTempFileStats = () => {
 module.exports = {
   // For project creation (multiple project files + optional banner)
   uploadProject: [
+    admitUpload, // ✅ NEW: Refuse or queue uploads the disk can't take
     trackTempFiles,
     upload.fields([
       { name: 'projectFiles', maxCount: 15 },
-      { name: 'bannerImage', maxCount: 1 }
+      { name: 'bannerImage', maxCount: 1 },
+      { name: 'modelGlb', maxCount: 1 } // Draco GLB converted in the browser
     ]),
     addToTempTracker
   ],
   
   // For updating a project
   uploadProjectUpdate: [
+    admitUpload,
     trackTempFiles,
     upload.fields([
       { name: 'modelFile', maxCount: 1 },
@@ -354,6 +371,7 @@ module.exports = {
   
   // For single file uploads
   uploadSingle: [
+    admitUpload,
     trackTempFiles,
     upload.single('file'),
     addToTempTracker
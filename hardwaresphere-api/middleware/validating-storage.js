@@ -0,0 +1,227 @@
+const fs = require('fs');
+const path = require('path');
+const { Transform } = require('stream');
+
+// multer storage engine that behaves like diskStorage, but checks each file's
+// content against its extension while it streams in. The first bytes must
+// carry the format's signature, and formats that declare their own size (binary
+// STL via its triangle count, GLB via its header) must match it exactly, so a
+// renamed binary or a truncated model is refused after a few KB rather than
+// after the whole file reached disk, Storage and the converter.
+//
+// On a mismatch the partial file is deleted and multer fails the request with
+// an error whose code is INVALID_FILE_CONTENT (status 400).
+
+const ascii = (text) => Buffer.from(text, 'latin1');
+const startsWith = (head, bytes, offset = 0) =>
+  head.length >= offset + bytes.length && head.subarray(offset, offset + bytes.length).equals(bytes);
+
+const SIGNATURES = {
+  png: ascii('\x89PNG\r\n\x1a\n'),
+  jpeg: Buffer.from([0xff, 0xd8, 0xff]),
+  riff: ascii('RIFF'),
+  pdf: ascii('%PDF-'),
+  zip: ascii('PK\x03\x04'),
+  ole: Buffer.from([0xd0, 0xcf, 0x11, 0xe0, 0xa1, 0xb1, 0x1a, 0xe1]),
+  ebml: Buffer.from([0x1a, 0x45, 0xdf, 0xa3]),
+  gltf: ascii('glTF')
+};
+// Top-level boxes an MP4/MOV can open with
+const ISO_MEDIA_BOXES = ['ftyp', 'moov', 'mdat', 'free', 'wide', 'skip', 'pnot'];
+
+const TEXT_HEAD_BYTES = 8192;
+const STL_HEADER_BYTES = 84;
+const STL_TRIANGLE_BYTES = 50;
+
+const isText = (head) => startsWith(head, Buffer.from([0xff, 0xfe])) || startsWith(head, Buffer.from([0xfe, 0xff])) || !head.includes(0);
+
+// Binary STL headers may start with "solid" too; ASCII ones are text and get
+// to a facet (or end) within the first few hundred bytes.
+const isAsciiStl = (head) => {
+  const text = head.toString('latin1').trimStart();
+  return text.startsWith('solid') && isText(head) && /\b(facet|endsolid)\b/.test(text);
+};
+
+// Each rule sees the first `headBytes` of the file (or all of it, if shorter)
+// and returns an error message, or { expectedSize } when the format fixes it.
+const signature = (bytes, offset = 0) => ({
+  headBytes: offset + bytes.length,
+  inspect: (head) => (startsWith(head, bytes, offset) ? {} : 'does not start with the expected file signature')
+});
+
+const text = {
+  headBytes: TEXT_HEAD_BYTES,
+  inspect: (head) => (isText(head) ? {} : 'is not a text file')
+};
+
+const RULES = {
+  '.stl': {
+    headBytes: 512,
+    inspect(head, maxFileSize) {
+      if (isAsciiStl(head)) return {};
+      if (head.length < STL_HEADER_BYTES) return 'is too short to be an STL file';
+      const triangles = head.readUInt32LE(80);
+      const expectedSize = STL_HEADER_BYTES + triangles * STL_TRIANGLE_BYTES;
+      if (triangles === 0) return 'declares no triangles';
+      if (expectedSize > maxFileSize) return `declares ${triangles} triangles, more than fit in the upload limit`;
+      return { expectedSize };
+    }
+  },
+  '.glb': {
+    headBytes: 12,
+    inspect(head, maxFileSize) {
+      if (!startsWith(head, SIGNATURES.gltf) || head.length < 12) return 'is not a binary glTF file';
+      if (head.readUInt32LE(4) !== 2) return `uses unsupported glTF version ${head.readUInt32LE(4)}`;
+      const expectedSize = head.readUInt32LE(8);
+      if (expectedSize > maxFileSize) return 'declares a size over the upload limit';
+      return { expectedSize };
+    }
+  },
+  '.gltf': {
+    headBytes: TEXT_HEAD_BYTES,
+    inspect: (head) => (isText(head) && head.toString('utf8').trimStart().startsWith('{') ? {} : 'is not a glTF JSON file')
+  },
+  '.obj': text,
+  '.png': signature(SIGNATURES.png),
+  '.jpg': signature(SIGNATURES.jpeg),
+  '.jpeg': signature(SIGNATURES.jpeg),
+  '.webp': {
+    headBytes: 12,
+    inspect: (head) => (startsWith(head, SIGNATURES.riff) && startsWith(head, ascii('WEBP'), 8) ? {} : 'is not a WebP image')
+  },
+  '.pdf': signature(SIGNATURES.pdf),
+  '.doc': signature(SIGNATURES.ole),
+  '.docx': signature(SIGNATURES.zip),
+  '.mp4': {
+    headBytes: 8,
+    inspect: (head) => (ISO_MEDIA_BOXES.includes(head.toString('latin1', 4, 8)) ? {} : 'is not an MP4/MOV video')
+  },
+  '.avi': {
+    headBytes: 12,
+    inspect: (head) => (startsWith(head, SIGNATURES.riff) && startsWith(head, ascii('AVI '), 8) ? {} : 'is not an AVI video')
+  },
+  '.webm': signature(SIGNATURES.ebml)
+};
+RULES['.mov'] = RULES['.mp4'];
+// Documentation and code files are plain text
+['.txt', '.md', '.py', '.cpp', '.c', '.java', '.js', '.ts', '.tsx', '.jsx', '.html', '.css', '.m', '.h', '.hpp',
+  '.cs', '.php', '.rb', '.go', '.rs', '.swift', '.kt', '.scala', '.r', '.matlab', '.sh', '.bat', '.ps1']
+  .forEach(ext => { RULES[ext] = text; });
+
+const invalidContent = (originalname, reason) => Object.assign(
+  new Error(`${originalname} ${reason}.`),
+  { code: 'INVALID_FILE_CONTENT', status: 400 }
+);
+
+/** Passes bytes through once the head matches the rule, and enforces a declared size. */
+class ContentCheck extends Transform {
+  constructor(rule, originalname, maxFileSize) {
+    super();
+    this.rule = rule;
+    this.originalname = originalname;
+    this.maxFileSize = maxFileSize;
+    this.head = [];
+    this.bytes = 0;
+    this.expectedSize = null;
+  }
+
+  /** Bytes are held back until the head is complete, so nothing invalid reaches disk. */
+  inspectHead() {
+    const head = Buffer.concat(this.head);
+    this.head = null;
+    const result = this.rule.inspect(head, this.maxFileSize);
+    if (typeof result === 'string') return { error: invalidContent(this.originalname, result) };
+    this.expectedSize = result.expectedSize ?? null;
+    return { head };
+  }
+
+  checkSize(final) {
+    if (this.expectedSize === null) return null;
+    if (this.bytes > this.expectedSize || (final && this.bytes !== this.expectedSize)) {
+      return invalidContent(this.originalname, `is ${this.bytes} bytes but its header declares ${this.expectedSize}`);
+    }
+    return null;
+  }
+
+  _transform(chunk, encoding, callback) {
+    this.bytes += chunk.length;
+    if (!this.head) return callback(this.checkSize(false), chunk);
+
+    this.head.push(chunk);
+    if (this.bytes < this.rule.headBytes) return callback();
+    const { error, head } = this.inspectHead();
+    if (error) return callback(error);
+    callback(this.checkSize(false), head);
+  }
+
+  _flush(callback) {
+    if (this.head) {
+      const { error, head } = this.inspectHead();
+      if (error) return callback(error);
+      this.push(head);
+    }
+    callback(this.checkSize(true));
+  }
+}
+
+class ValidatingDiskStorage {
+  /**
+   * @param {Object} options - as multer.diskStorage, plus maxFileSize (bytes)
+   */
+  constructor({ destination, filename, maxFileSize }) {
+    this.getDestination = destination;
+    this.getFilename = filename;
+    this.maxFileSize = maxFileSize;
+  }
+
+  _handleFile(req, file, cb) {
+    this.getDestination(req, file, (err, destination) => {
+      if (err) return cb(err);
+      this.getFilename(req, file, (err, filename) => {
+        if (err) return cb(err);
+
+        const finalPath = path.join(destination, filename);
+        const rule = RULES[path.extname(file.originalname).toLowerCase()];
+        const check = rule ? new ContentCheck(rule, file.originalname, this.maxFileSize) : null;
+        const outStream = fs.createWriteStream(finalPath);
+
+        let failed = false;
+        const fail = (error) => {
+          if (failed) return;
+          failed = true;
+          // Stop writing; the rest of the part is discarded, not stored
+          file.stream.unpipe();
+          file.stream.resume();
+          outStream.destroy();
+          if (error.code === 'INVALID_FILE_CONTENT') console.warn(`🚫 Upload rejected: ${error.message}`);
+          fs.unlink(finalPath, () => cb(error));
+        };
+
+        outStream.on('error', fail);
+        outStream.on('finish', () => {
+          if (failed) return;
+          cb(null, { destination, filename, path: finalPath, size: outStream.bytesWritten });
+        });
+
+        if (check) {
+          check.on('error', fail);
+          file.stream.pipe(check).pipe(outStream);
+        } else {
+          file.stream.pipe(outStream);
+        }
+      });
+    });
+  }
+
+  _removeFile(req, file, cb) {
+    delete file.destination;
+    delete file.filename;
+    const filePath = file.path;
+    delete file.path;
+    fs.unlink(filePath, cb);
+  }
+}
+
+module.exports = {
+  validatingDiskStorage: (options) => new ValidatingDiskStorage(options)
+};
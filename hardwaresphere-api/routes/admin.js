@@ -0,0 +1,76 @@
+const express = require('express');
+const { verifyFirebaseToken, requireAdmin } = require('../middleware/auth');
+const profilerService = require('../services/profiler-service');
+const conversionService = require('../services/conversion-service');
+const cacheWarmer = require('../services/cache-warmer');
+const scheduler = require('../services/scheduler');
+const { getUploadAdmissionStats } = require('../middleware/upload-admission');
+
+const router = express.Router();
+
+// Operators only. Captures land in PROFILE_DIR on this instance; download them
+// from here and open them in Chrome DevTools (Performance / Memory tabs).
+router.use(verifyFirebaseToken, requireAdmin);
+
+// --- Instance internals kept off the public /health: maintenance jobs and upload admission ---
+router.get('/status', (req, res) => {
+  res.json({
+    cacheWarmup: cacheWarmer.status,
+    scheduler: scheduler.getStatus(),
+    uploads: getUploadAdmissionStats()
+  });
+});
+
+const sendCapture = (label, capture) => async (req, res) => {
+  try {
+    res.status(201).json(await capture(req));
+  } catch (error) {
+    console.error(`Error capturing ${label}:`, error);
+    res.status(error.status || 500).json({ error: error.status ? error.message : `Failed to capture ${label}` });
+  }
+};
+
+// --- CPU profile over ?seconds= (default 10, max 120) ---
+router.post('/profiles/cpu', sendCapture('CPU profile', (req) => profilerService.captureCpuProfile(req.query.seconds)));
+
+// --- Sampled allocations over ?seconds= (default 30); cheap enough for busy instances ---
+router.post('/profiles/heap-sampling', sendCapture('heap sampling profile', (req) => profilerService.captureHeapSampling(req.query.seconds)));
+
+// --- Full heap snapshot; the process stops serving until it is written ---
+router.post('/profiles/heap-snapshot', sendCapture('heap snapshot', () => profilerService.captureHeapSnapshot()));
+
+router.get('/profiles', async (req, res) => {
+  try {
+    res.json({ ...profilerService.getStatus(), profiles: await profilerService.list() });
+  } catch (error) {
+    console.error('Error listing profiles:', error);
+    res.status(500).json({ error: 'Failed to list profiles' });
+  }
+});
+
+router.get('/profiles/:name', (req, res) => {
+  const filePath = profilerService.resolve(req.params.name);
+  if (!filePath) return res.status(404).json({ error: 'Profile not found' });
+  res.download(filePath, (error) => {
+    if (error && !res.headersSent) {
+      res.status(error.code === 'ENOENT' ? 404 : 500).json({ error: 'Profile not found' });
+    }
+  });
+});
+
+router.delete('/profiles/:name', async (req, res) => {
+  try {
+    await profilerService.remove(req.params.name);
+    res.status(204).end();
+  } catch (error) {
+    console.error('Error deleting profile:', error);
+    res.status(error.status || 500).json({ error: error.status ? error.message : 'Failed to delete profile' });
+  }
+});
+
+// --- Peak RSS of recent STL → GLB conversions on this instance ---
+router.get('/conversions', (req, res) => {
+  res.json({ conversions: conversionService.getRecentConversions() });
+});
+
+module.exports = router;
@@ -4,7 +4,11 @@ const { verifyFirebaseToken } = require('../middleware/auth');
 
 // 🚀 NEW: Import Redis caching
 const { cache } = require('../middleware/cache');
+const { serializeWith } = require('../middleware/serialize');
+const { currentUserSchema } = require('../schemas/responses');
 const redisClient = require('../config/redis');
+const revalidationService = require('../services/revalidation-service');
+const statsService = require('../services/stats-service');
 
 const router = express.Router();
 
@@ -12,7 +16,7 @@ const router = express.Router();
 const cacheCurrentUser = cache((req) => `user:${req.user.uid}:auth`, 120);
 
 // Get current user info (WITH CACHING)
-router.get('/me', verifyFirebaseToken, cacheCurrentUser, async (req, res) => {
+router.get('/me', verifyFirebaseToken, serializeWith(currentUserSchema), cacheCurrentUser, async (req, res) => {
   try {
     const userDoc = await firestore 
       .collection('users')
@@ -23,9 +27,12 @@ router.get('/me', verifyFirebaseToken, cacheCurrentUser, async (req, res) => {
       return res.status(404).json({ error: 'User not found' });
     }
 
+    // FIX: users/<uid>.stats is never updated; the live totals are in the shards
+    const userData = userDoc.data();
     res.json({
       id: req.user.uid,
-      ...userDoc.data()
+      ...userData,
+      stats: await statsService.getUserStats(req.user.uid, userData)
     });
   } catch (error) {
     console.error('Error fetching user:', error);
@@ -59,8 +66,9 @@ router.put('/me', verifyFirebaseToken, async (req, res) => {
     const userDoc = await firestore.collection('users').doc(req.user.uid).get();
     const username = userDoc.data()?.username;
     if (username) {
-      await redisClient.del(`user:${username}:profile`);
+      await redisClient.del(`user:${username.toLowerCase()}:profile`);
       console.log(`💾 Cache invalidated for user profile: ${username}`);
+      await revalidationService.revalidateUser(username);
     }
 
     res.json({ message: 'Profile updated successfully' });
@@ -0,0 +1,42 @@
+const express = require('express');
+const imageService = require('../services/image-service');
+const { ImageError } = require('../services/image-service');
+
+const router = express.Router();
+
+// --- Resized image variant (used by the frontend's next/image loader) ---
+// GET /api/images?src=<signed storage url>&w=<width>&q=<quality>
+router.get('/', async (req, res) => {
+  try {
+    const { src, w, q } = req.query;
+    if (typeof src !== 'string') {
+      return res.status(400).json({ error: 'src is required' });
+    }
+
+    const width = imageService.parseWidth(w);
+    const quality = imageService.parseQuality(q);
+    const { filePath, maxAge } = await imageService.getVariant(src, width, quality);
+
+    res.set({
+      'Content-Type': 'image/webp',
+      'Cache-Control': `public, max-age=${maxAge}, immutable`,
+      // Helmet defaults to same-origin, which would block <img> on the frontend's origin.
+      'Cross-Origin-Resource-Policy': 'cross-origin'
+    });
+    res.sendFile(filePath, (error) => {
+      if (error && !res.headersSent) {
+        console.error(`Error sending image variant ${filePath}:`, error.message);
+        res.status(500).json({ error: 'Failed to send image' });
+      }
+    });
+
+  } catch (error) {
+    if (error instanceof ImageError) {
+      return res.status(error.status).json({ error: error.message });
+    }
+    console.error('Error resizing image:', error);
+    res.status(500).json({ error: 'Failed to resize image' });
+  }
+});
+
+module.exports = router;
@@ -2,22 +2,31 @@ const express = require('express');
 const { verifyFirebaseToken, optionalVerifyFirebaseToken } = require('../middleware/auth');
 const { uploadProject, uploadProjectUpdate, handleUploadError } = require('../middleware/upload');
 const projectService = require('../services/project-service');
-const { admin } = require('../config/firebase');
+const statsService = require('../services/stats-service');
+const likeService = require('../services/like-service');
+const analyticsService = require('../services/analytics-service');
 
 // 🚀 NEW: Import Redis caching
 const { cache } = require('../middleware/cache');
+const { serializeWith } = require('../middleware/serialize');
+const { projectSchema } = require('../schemas/responses');
 const redisClient = require('../config/redis');
 
 const router = express.Router();
 
 // 🚀 NEW: Cache middleware for individual projects (5 minutes)
-const cacheProject = cache((req) => `project:${req.params.id}`, 300);
+// FIX: Private projects are never stored - a cache HIT is served before the
+// permission check below runs, so a cached private project would leak.
+const cacheProject = cache((req) => `project:${req.params.id}`, 300, {
+  shouldCache: (data) => data?.visibility !== 'private',
+  warm: true
+});
 
 // 🚀 NEW: Cache middleware for user projects (2 minutes) 
 const cacheUserProjects = cache((req) => `user:${req.user.uid}:projects`, 120);
 
 // --- Get a single project by ID (WITH CACHING) ---
-router.get('/:id', optionalVerifyFirebaseToken, cacheProject, async (req, res) => {
+router.get('/:id', optionalVerifyFirebaseToken, serializeWith(projectSchema), cacheProject, async (req, res) => {
   try {
     console.log('Server time upon request:', new Date().toISOString());
 
@@ -86,6 +95,26 @@ router.put('/:id', verifyFirebaseToken, uploadProjectUpdate, handleUploadError,
   }
 });
 
+// --- Partial update: changed fields and file operations only ---
+// Body (multipart): fields = JSON of changed values, fileOps = JSON array of
+// add/remove/replace operations, plus the uploads those operations name.
+router.patch('/:id', verifyFirebaseToken, uploadProjectUpdate, handleUploadError, async (req, res) => {
+  try {
+    const updatedProject = await projectService.patchProject(req.params.id, req.user.uid, req.body, req.files);
+
+    await redisClient.del(`project:${req.params.id}`);
+    await redisClient.del(`user:${req.user.uid}:projects`);
+
+    res.status(200).json(updatedProject);
+  } catch (error) {
+    if (error.status) {
+      return res.status(error.status).json({ error: error.message });
+    }
+    console.error(`Error patching project ${req.params.id}:`, error);
+    res.status(500).json({ error: 'Failed to update project', message: error.message });
+  }
+});
+
 // --- Delete project (WITH CACHE INVALIDATION) ---
 router.delete('/:id', verifyFirebaseToken, async (req, res) => {
   try {
@@ -103,6 +132,61 @@ router.delete('/:id', verifyFirebaseToken, async (req, res) => {
   }
 });
 
+// --- Revision history (owner only, NO CACHING) ---
+router.get('/:id/revisions', verifyFirebaseToken, async (req, res) => {
+  try {
+    res.json({ revisions: await projectService.listRevisions(req.params.id, req.user.uid) });
+  } catch (error) {
+    if (error.status) {
+      return res.status(error.status).json({ error: error.message });
+    }
+    console.error(`Error listing revisions for ${req.params.id}:`, error);
+    res.status(500).json({ error: 'Failed to list revisions' });
+  }
+});
+
+router.post('/:id/revisions/:revisionId/restore', verifyFirebaseToken, async (req, res) => {
+  try {
+    const restoredProject = await projectService.restoreRevision(req.params.id, req.user.uid, req.params.revisionId);
+    await redisClient.del(`project:${req.params.id}`);
+    await redisClient.del(`user:${req.user.uid}:projects`);
+    res.json(restoredProject);
+  } catch (error) {
+    if (error.status) {
+      return res.status(error.status).json({ error: error.message });
+    }
+    console.error(`Error restoring project ${req.params.id} to ${req.params.revisionId}:`, error);
+    res.status(500).json({ error: 'Failed to restore revision', message: error.message });
+  }
+});
+
+// --- Likes (NO CACHING - per-user state) ---
+// 🚀 OPTIMIZATION: Membership answered from a Redis set; counts are sharded
+// and folded into stats.likes by like-service's periodic aggregation.
+router.get('/:id/like', verifyFirebaseToken, async (req, res) => {
+  try {
+    res.json({ liked: await likeService.isLiked(req.user.uid, req.params.id) });
+  } catch (error) {
+    console.error(`Error reading like for ${req.params.id}:`, error);
+    res.status(500).json({ error: 'Failed to read like status' });
+  }
+});
+
+const setLiked = (liked) => async (req, res) => {
+  try {
+    res.json(await likeService.setLiked(req.user.uid, req.params.id, liked));
+  } catch (error) {
+    if (error.status) {
+      return res.status(error.status).json({ error: error.message });
+    }
+    console.error(`Error ${liked ? 'liking' : 'unliking'} project ${req.params.id}:`, error);
+    res.status(500).json({ error: 'Failed to update like' });
+  }
+};
+
+router.post('/:id/like', verifyFirebaseToken, setLiked(true));
+router.delete('/:id/like', verifyFirebaseToken, setLiked(false));
+
 // --- Increment view count (WITH CACHE INVALIDATION) ---
 router.post('/:id/view', async (req, res) => {
   try {
@@ -118,9 +202,9 @@ router.post('/:id/view', async (req, res) => {
     const recentView = await redisClient.get(viewKey);
     
     if (!recentView) {
-      // Count the view and set 1-hour cooldown
-      const projectRef = admin.firestore().collection('projects').doc(projectId);
-      await projectRef.update({ 'stats.views': admin.firestore.FieldValue.increment(1) });
+      // 🚀 OPTIMIZATION: Buffered in Redis and flushed in batches by stats-service
+      await statsService.recordView(projectId);
+      await analyticsService.recordView(projectId);
       
       // Set 1-hour cooldown (3600 seconds)
       await redisClient.set(viewKey, 'viewed', 3600);
@@ -9,7 +9,13 @@ const fs = require('fs').promises;
 const sharp = require('sharp');
 // 🚀 NEW: Import Redis caching
 const { cache } = require('../middleware/cache');
+const { serializeWith } = require('../middleware/serialize');
+const { profileSchema, projectsPageSchema } = require('../schemas/responses');
 const redisClient = require('../config/redis');
+const revalidationService = require('../services/revalidation-service');
+const usernameIndex = require('../services/username-index');
+const statsService = require('../services/stats-service');
+const analyticsService = require('../services/analytics-service');
 
 const router = express.Router();
 // Use memory storage to handle file buffers directly
@@ -27,6 +33,11 @@ async function compressUserImage(inputPath, originalName, type) {
   // Different sizes for different image types
   const maxWidth = type === 'avatar' ? 400 : 1920; // Avatar: 400px, Background: 1920px
   const quality = type === 'avatar' ? 85 : 75; // Higher quality for avatars
+
+  // ✅ NEW: Already resized to WebP in the browser - nothing left to do
+  if (await fileService.isAlreadyWebOptimized(inputPath, maxWidth)) {
+    return inputPath;
+  }
   
   try {
     await sharp(inputPath)
@@ -70,7 +81,12 @@ async function generateSignedUrl(filePath) {
 }
 
 // 🚀 NEW: Cache middleware for user profiles (10 minutes)
-const cacheUserProfile = cache((req) => `user:${req.params.username}:profile`, 600);
+// FIX: Signed-in viewers bypass it - the owner's response includes private
+// projects and must never be replayed to anonymous visitors.
+const cacheUserProfile = cache((req) => `user:${req.params.username.toLowerCase()}:profile`, 600, {
+  skip: (req) => !!req.user,
+  warm: true
+});
 
 const parseUsername = (input, hostname) => {
   if (!input) return '';
@@ -87,53 +103,108 @@ const parseUsername = (input, hostname) => {
   }
 };
 
-// Get public user profile by username (WITH CACHING)
-router.get('/:username', optionalVerifyFirebaseToken, cacheUserProfile, async (req, res) => {
-  try {
-    const username = req.params.username;
-    const userQuery = await firestore.collection('users').where('username', '==', username).limit(1).get();
-    if (userQuery.empty) return res.status(404).json({ error: 'User not found' });
+// 🚀 OPTIMIZATION: Profiles list projects a page at a time. The first page
+// ships with the profile; the rest come from GET /:username/projects.
+const PROFILE_PAGE_SIZE = 24;
+const MAX_PROFILE_PAGE_SIZE = 48;
+
+// Only what a project card renders - full project documents are much larger.
+async function toProjectSummary(doc) {
+  const project = doc.data();
+  const thumbnail = project.files?.thumbnail;
+  return {
+    id: doc.id,
+    title: project.title,
+    files: thumbnail
+      ? { thumbnail: { url: thumbnail.storagePath ? await generateSignedUrl(thumbnail.storagePath) : thumbnail.url } }
+      : {},
+    stats: project.stats || { views: 0, likes: 0, downloads: 0 },
+    isPinned: project.isPinned === true,
+    visibility: project.visibility,
+    createdAt: project.createdAt
+  };
+}
 
-    const userDoc = userQuery.docs[0];
-    const userData = userDoc.data();
-    
-    let projectsQuery = firestore.collection('projects').where('userId', '==', userDoc.id);
-    
-    const isOwner = req.user && req.user.uid === userDoc.id;
-    if (!isOwner) {
-      projectsQuery = projectsQuery.where('visibility', '==', 'public');
+// Case-insensitive, through the username index
+async function findUserByUsername(username) {
+  return usernameIndex.findUser(username);
+}
+
+function userProjectsQuery(userId, isOwner) {
+  let projectsQuery = firestore.collection('projects').where('userId', '==', userId);
+  if (!isOwner) {
+    projectsQuery = projectsQuery.where('visibility', '==', 'public');
+  }
+  return projectsQuery;
+}
+
+/**
+ * One page of a user's projects, newest first. The cursor is the id of the
+ * last project on the previous page.
+ */
+async function getProjectsPage(userId, isOwner, { cursor, limit = PROFILE_PAGE_SIZE } = {}) {
+  let pageQuery = userProjectsQuery(userId, isOwner).orderBy('createdAt', 'desc');
+
+  if (cursor) {
+    const cursorDoc = await firestore.collection('projects').doc(cursor).get();
+    if (!cursorDoc.exists || cursorDoc.data().userId !== userId) {
+      const error = new Error('Invalid cursor');
+      error.status = 400;
+      throw error;
     }
+    pageQuery = pageQuery.startAfter(cursorDoc);
+  }
 
-    const allProjectsSnapshot = await projectsQuery.orderBy('createdAt', 'desc').get();
-    const allProjects = allProjectsSnapshot.docs.map(doc => ({ id: doc.id, ...doc.data() }));
-
-    // Generate signed URLs for thumbnails
-    const projectsWithSignedUrls = await Promise.all(
-      allProjects.map(async (project) => {
-        if (project.files?.thumbnail?.storagePath) {
-          const thumbnailUrl = await generateSignedUrl(project.files.thumbnail.storagePath);
-          return {
-            ...project,
-            files: {
-              ...project.files,
-              thumbnail: {
-                ...project.files.thumbnail,
-                url: thumbnailUrl
-              }
-            }
-          };
-        }
-        return project;
-      })
-    );
+  // One extra document tells us whether another page exists.
+  const snapshot = await pageQuery.limit(limit + 1).get();
+  const docs = snapshot.docs.slice(0, limit);
+  const projects = await Promise.all(docs.map(toProjectSummary));
+
+  return {
+    projects,
+    nextCursor: snapshot.docs.length > limit ? docs[docs.length - 1].id : null
+  };
+}
+
+// 🚀 OPTIMIZATION: View series for all of the user's projects in one call,
+// read from pre-aggregated Redis buckets (short cache - minute data moves)
+const cacheUserAnalytics = cache((req) => `user:${req.user.uid}:analytics:views:${req.query.range || '7d'}`, 60);
+
+router.get('/me/analytics/views', verifyFirebaseToken, cacheUserAnalytics, async (req, res) => {
+  const range = req.query.range || '7d';
+  if (!analyticsService.ranges.includes(range)) {
+    return res.status(400).json({ error: `range must be one of ${analyticsService.ranges.join(', ')}` });
+  }
 
-    const pinnedProjects = projectsWithSignedUrls.filter(p => p.isPinned);
-    const otherProjects = projectsWithSignedUrls.filter(p => !p.isPinned);
+  try {
+    const result = await analyticsService.getUserViewSeries(req.user.uid, range);
+    if (!result) return res.status(503).json({ error: 'Analytics are temporarily unavailable' });
+    res.json(result);
+  } catch (error) {
+    console.error('Error fetching view analytics:', error);
+    res.status(500).json({ error: 'Internal server error' });
+  }
+});
 
+// Get public user profile by username (WITH CACHING)
+router.get('/:username', optionalVerifyFirebaseToken, serializeWith(profileSchema), cacheUserProfile, async (req, res) => {
+  try {
+    const userDoc = await findUserByUsername(req.params.username);
+    if (!userDoc) return res.status(404).json({ error: 'User not found' });
 
+    const userData = userDoc.data();
+    const isOwner = !!(req.user && req.user.uid === userDoc.id);
 
+    const [firstPage, pinnedSnapshot, countSnapshot, stats] = await Promise.all([
+      getProjectsPage(userDoc.id, isOwner),
+      userProjectsQuery(userDoc.id, isOwner).where('isPinned', '==', true).limit(4).get(),
+      userProjectsQuery(userDoc.id, isOwner).count().get(),
+      statsService.getUserStats(userDoc.id, userData)
+    ]);
+
+    const pinnedProjects = await Promise.all(pinnedSnapshot.docs.map(toProjectSummary));
+    const projectCount = countSnapshot.data().count;
 
-    // LEFT OF HERE, NEEDS FIXING
     const publicProfile = {
       id: userDoc.id,
       displayName: userData.displayName,
@@ -145,10 +216,13 @@ router.get('/:username', optionalVerifyFirebaseToken, cacheUserProfile, async (r
       linkedin: userData.linkedin,
       skills: userData.skills || [],
       location: userData.location || '',
-      stats: userData.stats || { totalProjects: 0, totalViews: 0, totalLikes: 0 },
+      // FIX: The shard totals count private projects too; others only see the visible ones
+      stats: isOwner ? stats : { ...stats, totalProjects: projectCount },
       createdAt: userData.createdAt?.toDate?.() || userData.createdAt,
       pinnedProjects,
-      otherProjects
+      projects: firstPage.projects,
+      nextCursor: firstPage.nextCursor,
+      projectCount
     };
     res.json(publicProfile);
     
@@ -158,6 +232,26 @@ router.get('/:username', optionalVerifyFirebaseToken, cacheUserProfile, async (r
   }
 });
 
+// Further pages of a user's projects (NO CACHING - cursors make keys unbounded)
+router.get('/:username/projects', optionalVerifyFirebaseToken, serializeWith(projectsPageSchema), async (req, res) => {
+  try {
+    const userDoc = await findUserByUsername(req.params.username);
+    if (!userDoc) return res.status(404).json({ error: 'User not found' });
+
+    const isOwner = !!(req.user && req.user.uid === userDoc.id);
+    const limit = Math.min(Math.max(parseInt(req.query.limit, 10) || PROFILE_PAGE_SIZE, 1), MAX_PROFILE_PAGE_SIZE);
+    const cursor = typeof req.query.cursor === 'string' && req.query.cursor ? req.query.cursor : null;
+
+    res.json(await getProjectsPage(userDoc.id, isOwner, { cursor, limit }));
+  } catch (error) {
+    if (error.status === 400) {
+      return res.status(400).json({ error: error.message });
+    }
+    console.error('Error fetching user projects page:', error);
+    res.status(500).json({ error: 'Internal server error' });
+  }
+});
+
 // --- Update current user profile endpoint (WITH CACHE INVALIDATION) ---
 router.put(
   '/me',
@@ -178,17 +272,18 @@ router.put(
       
       const updateData = { updatedAt: admin.firestore.FieldValue.serverTimestamp() };
 
-      // --- Username Validation ---
-      if (username) {
-        const currentUsername = currentUserData?.username;
-        if (username !== currentUsername) {
-          const usernameQuery = await firestore.collection('users').where('username', '==', username).limit(1).get();
-          if (!usernameQuery.empty) {
-            return res.status(400).json({ error: 'Username is already taken. Please choose another.' });
-          }
-          updateData.username = username;
+      // --- Validation (before any upload) ---
+      if (skills !== undefined) {
+        try {
+          updateData.skills = JSON.parse(skills);
+        } catch (e) {
+          return res.status(400).json({ error: 'Invalid format for skills. Expected a JSON array.' });
         }
       }
+      const renaming = !!username && username !== oldUsername;
+      if (renaming) {
+        await usernameIndex.assertClaimable(uid, username);
+      }
 
       // --- File Upload Logic with Compression, Cache Busting, and Cleanup ---
       const uploadFile = async (file, type) => {
@@ -217,7 +312,7 @@ router.put(
           
           // Clean up temp files
           await fs.unlink(tempPath);
-          await fs.unlink(compressedPath);
+          if (compressedPath !== tempPath) await fs.unlink(compressedPath);
           
           // Delete old image if it exists
           if (currentStoragePath) {
@@ -274,27 +369,28 @@ router.put(
       if (location !== undefined) updateData.location = location;
       if (github !== undefined) updateData.github = parseUsername(github, 'github.com');
       if (linkedin !== undefined) updateData.linkedin = parseUsername(linkedin, 'linkedin.com');
-      
-      if (skills !== undefined) {
-        try {
-          updateData.skills = JSON.parse(skills);
-        } catch (e) {
-          return res.status(400).json({ error: 'Invalid format for skills. Expected a JSON array.' });
-        }
-      }
 
       // --- Atomically Update Firestore ---
       await userRef.set(updateData, { merge: true });
 
+      // --- Username Claim ---
+      // 🚀 OPTIMIZATION: Reserved transactionally in usernames/, so two users
+      // racing for the same name can't both get it. Writes users/<uid>.username.
+      // FIX: Claimed last, so a failed upload or write doesn't leave the name
+      // reserved for a profile that never changed.
+      if (renaming) {
+        await usernameIndex.claim(uid, username);
+      }
+
       // 🚀 NEW: Invalidate user profile cache
       if (oldUsername) {
-        await redisClient.del(`user:${oldUsername}:profile`);
+        await redisClient.del(`user:${oldUsername.toLowerCase()}:profile`);
         console.log(`💾 Cache invalidated for user profile: ${oldUsername}`);
       }
       
       // If username changed, also invalidate the new username cache (just in case)
-      if (username && username !== oldUsername) {
-        await redisClient.del(`user:${username}:profile`);
+      if (renaming) {
+        await redisClient.del(`user:${username.toLowerCase()}:profile`);
         console.log(`💾 Cache invalidated for new username: ${username}`);
       }
 
@@ -302,12 +398,18 @@ router.put(
       await redisClient.del(`user:${uid}:projects`);
       console.log(`💾 Cache invalidated for user projects: ${uid}`);
 
+      // ✅ NEW: Regenerate the static profile page (old and new URL on rename)
+      await revalidationService.revalidateUser(oldUsername, username);
+
       const updatedUserDoc = await userRef.get();
       res.json({
         message: 'Profile updated successfully',
         updatedProfile: updatedUserDoc.data(),
       });
     } catch (error) {
+      if (error.status === 400 || error.status === 409) {
+        return res.status(error.status).json({ error: error.message });
+      }
       console.error(`Error updating profile for user ${uid}:`, error);
       res.status(500).json({ error: 'An unexpected error occurred while updating the profile.' });
     }
@@ -317,21 +419,13 @@ router.put(
 // Check if a username is available (NO CACHING - real-time check needed)
 router.post('/username-check', verifyFirebaseToken, async (req, res) => {
   const { username } = req.body;
-  if (!username || username.length < 3) {
+  if (typeof username !== 'string' || username.trim().length < 3) {
     return res.status(400).json({ error: 'Username must be at least 3 characters long.' });
   }
 
   try {
-    const userQuery = await firestore.collection('users').where('username', '==', username).limit(1).get();
-    if (userQuery.empty) {
-      res.json({ available: true });
-    } else {
-      if (userQuery.docs[0].id === req.user.uid) {
-        res.json({ available: true, isCurrentUser: true });
-      } else {
-        res.json({ available: false });
-      }
-    }
+    // 🚀 OPTIMIZATION: Bloom filter + Redis index; most keystrokes never reach Firestore
+    res.json(await usernameIndex.check(username, req.user.uid));
   } catch (error) {
     console.error('Error checking username:', error);
     res.status(500).json({ error: 'Internal server error' });
@@ -367,7 +461,7 @@ router.post('/projects/:projectId/toggle-pin', verifyFirebaseToken, async (req,
 
     // 🚀 NEW: Invalidate user profile cache (pinned projects changed)
     if (username) {
-      await redisClient.del(`user:${username}:profile`);
+      await redisClient.del(`user:${username.toLowerCase()}:profile`);
       console.log(`💾 Cache invalidated for pin toggle - user profile: ${username}`);
     }
     
@@ -375,6 +469,8 @@ router.post('/projects/:projectId/toggle-pin', verifyFirebaseToken, async (req,
     await redisClient.del(`user:${uid}:projects`);
     console.log(`💾 Cache invalidated for pin toggle - user projects: ${uid}`);
 
+    await revalidationService.revalidateUser(username);
+
     res.json({ success: true, message: 'Pin status updated.' });
   } catch (error) {
     console.error('Error toggling pin:', error);
@@ -0,0 +1,43 @@
+const express = require('express');
+const { verifyFirebaseToken, requireAdmin } = require('../middleware/auth');
+const vitalsService = require('../services/vitals-service');
+
+const router = express.Router();
+
+// Beacons are sent as text/plain to avoid a CORS preflight.
+const parseBeacon = express.text({ type: 'text/plain', limit: '16kb' });
+
+// --- Ingest a batch of real-user metrics (sendBeacon from lib/vitals.ts) ---
+router.post('/', parseBeacon, async (req, res) => {
+  try {
+    let payload = req.body;
+    if (typeof payload === 'string') {
+      try {
+        payload = JSON.parse(payload);
+      } catch {
+        return res.status(400).json({ error: 'Invalid JSON' });
+      }
+    }
+
+    await vitalsService.record(payload?.metrics);
+    // Beacons ignore the response; 204 keeps it as small as possible.
+    res.status(204).end();
+
+  } catch (error) {
+    console.error('Error recording web vitals:', error);
+    res.status(500).json({ error: 'Failed to record metrics' });
+  }
+});
+
+// --- Percentiles per route, with regressions flagged (operators only) ---
+router.get('/summary', verifyFirebaseToken, requireAdmin, async (req, res) => {
+  try {
+    const days = Math.min(Math.max(parseInt(req.query.days, 10) || 7, 1), 30);
+    res.json(await vitalsService.getSummary(days));
+  } catch (error) {
+    console.error('Error building web vitals summary:', error);
+    res.status(500).json({ error: 'Failed to build summary' });
+  }
+});
+
+module.exports = router;
@@ -0,0 +1,163 @@
+// Response schemas for the hottest read endpoints. Each is compiled into a
+// dedicated serializer by middleware/serialize.js; only the fields declared
+// here are sent, so a field the frontend needs must be added here too
+// (types/project.ts and types/user.ts describe what it reads).
+//
+// Kept out of the route files so scripts/bench-serializer.js can load them
+// without Firebase.
+
+const string = { type: 'string' };
+const integer = { type: 'integer' };
+const boolean = { type: 'boolean' };
+// Firestore timestamps, sent as { _seconds, _nanoseconds } like JSON.stringify does
+const timestamp = {
+  type: 'object',
+  properties: { _seconds: integer, _nanoseconds: integer }
+};
+
+const fileEntrySchema = {
+  type: 'object',
+  properties: {
+    url: string,
+    filename: string,
+    size: { type: 'number' },
+    type: string,
+    storagePath: string, // the edit page addresses files by it
+    contentHash: string
+  }
+};
+
+// GET /api/projects/:id
+const projectSchema = {
+  type: 'object',
+  properties: {
+    id: string,
+    title: string,
+    description: string,
+    tags: { type: 'array', items: string },
+    category: string,
+    userId: string,
+    username: string,
+    authorName: string,
+    authorAvatar: string,
+    visibility: string,
+    allowDownloads: boolean,
+    isPinned: boolean,
+    files: {
+      type: 'object',
+      properties: {
+        model: {
+          type: 'object',
+          properties: { glb: fileEntrySchema, stl: fileEntrySchema }
+        },
+        thumbnail: fileEntrySchema,
+        attachments: { type: 'array', items: fileEntrySchema }
+      }
+    },
+    stats: {
+      type: 'object',
+      properties: { views: integer, likes: integer, downloads: integer }
+    },
+    conversionStatus: {
+      type: 'object',
+      properties: {
+        stlFiles: integer,
+        convertedFiles: integer,
+        inProgress: boolean,
+        completed: boolean,
+        errors: { type: 'array', items: {} },
+        progress: { type: 'number' },
+        currentFile: string
+      }
+    },
+    createdAt: string,
+    updatedAt: string
+  }
+};
+
+const userStatsSchema = {
+  type: 'object',
+  properties: { totalProjects: integer, totalViews: integer, totalLikes: integer }
+};
+
+const projectSummarySchema = {
+  type: 'object',
+  properties: {
+    id: string,
+    title: string,
+    files: {
+      type: 'object',
+      properties: {
+        thumbnail: { type: 'object', properties: { url: string } }
+      }
+    },
+    stats: {
+      type: 'object',
+      properties: { views: integer, likes: integer, downloads: integer }
+    },
+    isPinned: boolean,
+    visibility: string,
+    createdAt: timestamp
+  }
+};
+
+// GET /api/users/:username/projects
+const projectsPageSchema = {
+  type: 'object',
+  properties: {
+    projects: { type: 'array', items: projectSummarySchema },
+    nextCursor: { type: ['string', 'null'] }
+  }
+};
+
+// GET /api/users/:username
+const profileSchema = {
+  type: 'object',
+  properties: {
+    id: string,
+    displayName: string,
+    username: string,
+    bio: string,
+    avatar: string,
+    backgroundImage: string,
+    github: string,
+    linkedin: string,
+    skills: { type: 'array', items: string },
+    location: string,
+    stats: userStatsSchema,
+    createdAt: string,
+    pinnedProjects: { type: 'array', items: projectSummarySchema },
+    projects: { type: 'array', items: projectSummarySchema },
+    nextCursor: { type: ['string', 'null'] },
+    projectCount: integer
+  }
+};
+
+// GET /api/auth/me - the user document minus storage paths and bookkeeping
+const currentUserSchema = {
+  type: 'object',
+  properties: {
+    id: string,
+    email: string,
+    displayName: string,
+    username: string,
+    bio: string,
+    avatar: string,
+    backgroundImage: string,
+    github: string,
+    linkedin: string,
+    location: string,
+    skills: { type: 'array', items: string },
+    stats: userStatsSchema,
+    createdAt: timestamp,
+    updatedAt: timestamp,
+    lastUsernameChange: timestamp
+  }
+};
+
+module.exports = {
+  projectSchema,
+  projectsPageSchema,
+  profileSchema,
+  currentUserSchema
+};
@@ -0,0 +1,156 @@
+// scripts/bench-serializer.js
+//
+// Compares the compiled response serializers (schemas/responses.js) with
+// JSON.stringify on payloads shaped like the real endpoints:
+//
+//   npm run bench:serialize
+//   npm run bench:serialize -- 48   # projects per profile page (default 24)
+
+const { compile } = require('../services/json-serializer');
+const { projectSchema, profileSchema, currentUserSchema } = require('../schemas/responses');
+
+const PAGE_SIZE = parseInt(process.argv[2], 10) || 24;
+const DURATION_MS = 1000;
+
+// Stand-in for a Firestore Timestamp: same own fields, so the same JSON.
+class Timestamp {
+  constructor(date) {
+    this._seconds = Math.floor(date.getTime() / 1000);
+    this._nanoseconds = 0;
+  }
+}
+
+const words = 'motor driver stm32 pcb enclosure bracket gear servo arduino sensor mount bearing'.split(' ');
+const signedUrl = (path) =>
+  `https://storage.googleapis.com/hardwaresphere.appspot.com/${path}?GoogleAccessId=api%40hardwaresphere.iam.gserviceaccount.com&Expires=1760000000&Signature=${'a1B2c3D4'.repeat(40)}`;
+
+const fileEntry = (userId, projectId, name, type) => ({
+  filename: name,
+  size: 1024 * 1024 + name.length,
+  type,
+  storagePath: `projects/${userId}/${projectId}/attachments/${name}`,
+  contentHash: 'f'.repeat(64),
+  uploadedAt: new Date().toISOString(),
+  url: signedUrl(`projects/${userId}/${projectId}/attachments/${name}`)
+});
+
+function project(i) {
+  const userId = 'Xq8fZ2lQeWbYh7TnK3pR9sVd1uA4';
+  const id = `proj${i}aB3dE5fG7hJ9kL`;
+  const description = `A ${words[i % words.length]} assembly with ${words.join(', ')}. `.repeat(6);
+  return {
+    id,
+    userId,
+    username: 'maker_jane',
+    authorName: 'Jane Maker',
+    authorAvatar: signedUrl(`avatars/${userId}.webp`),
+    title: `${words[i % words.length]} controller rev ${i}`,
+    description,
+    tags: words.slice(0, 6),
+    category: 'electronics',
+    visibility: 'public',
+    allowDownloads: true,
+    isPinned: i < 4,
+    // Internal fields the schemas drop
+    searchTerms: description.toLowerCase().split(/\W+/).flatMap(w => [w, w.slice(0, 3), w.slice(0, 5)]),
+    statsShardedAt: new Timestamp(new Date()),
+    files: {
+      model: {
+        stl: fileEntry(userId, id, 'controller.stl', 'model'),
+        glb: { ...fileEntry(userId, id, 'controller.glb', 'model'), conversionStats: { originalSize: 9e6, convertedSize: 1e6, triangleCount: 182000 } }
+      },
+      thumbnail: fileEntry(userId, id, 'banner.webp', 'image'),
+      attachments: Array.from({ length: 12 }, (_, n) => fileEntry(userId, id, `part-${n}.step`, 'model'))
+    },
+    stats: { views: 1234 + i, likes: 56, downloads: 7 },
+    conversionStatus: { stlFiles: 1, convertedFiles: 1, inProgress: false, completed: true, errors: [], startedAt: new Timestamp(new Date()), completedAt: new Timestamp(new Date()) },
+    createdAt: new Date(Date.now() - i * 86400000),
+    updatedAt: new Date()
+  };
+}
+
+// What toProjectSummary returns
+const summary = (p) => ({
+  id: p.id,
+  title: p.title,
+  files: { thumbnail: { url: p.files.thumbnail.url } },
+  stats: p.stats,
+  isPinned: p.isPinned,
+  visibility: p.visibility,
+  createdAt: new Timestamp(p.createdAt)
+});
+
+const projects = Array.from({ length: PAGE_SIZE }, (_, i) => project(i));
+const payloads = {
+  'GET /api/projects/:id': [projectSchema, projects[0]],
+  'GET /api/users/:username': [profileSchema, {
+    id: projects[0].userId,
+    displayName: 'Jane Maker',
+    username: 'maker_jane',
+    bio: 'Embedded engineer. '.repeat(10),
+    avatar: signedUrl('avatars/jane.webp'),
+    backgroundImage: signedUrl('backgrounds/jane.webp'),
+    github: 'janemaker',
+    linkedin: 'jane-maker',
+    skills: words,
+    location: 'Berlin',
+    stats: { totalProjects: 180, totalViews: 120000, totalLikes: 5400 },
+    createdAt: new Date('2024-01-01'),
+    pinnedProjects: projects.slice(0, 4).map(summary),
+    projects: projects.map(summary),
+    nextCursor: projects[PAGE_SIZE - 1].id,
+    projectCount: 180
+  }],
+  'GET /api/auth/me': [currentUserSchema, {
+    id: projects[0].userId,
+    email: 'jane@example.com',
+    displayName: 'Jane Maker',
+    username: 'maker_jane',
+    bio: 'Embedded engineer.',
+    avatar: signedUrl('avatars/jane.webp'),
+    avatarStoragePath: 'avatars/jane.webp',
+    skills: words,
+    stats: { totalProjects: 180, totalViews: 120000, totalLikes: 5400 },
+    statsShardedAt: new Timestamp(new Date()),
+    createdAt: new Timestamp(new Date('2024-01-01')),
+    updatedAt: new Timestamp(new Date())
+  }]
+};
+
+function opsPerSecond(fn, value) {
+  for (let i = 0; i < 200; i++) fn(value); // warm up the JIT
+  let ops = 0;
+  const start = process.hrtime.bigint();
+  const end = start + BigInt(DURATION_MS) * 1000000n;
+  let now = start;
+  while (now < end) {
+    for (let i = 0; i < 50; i++) fn(value);
+    ops += 50;
+    now = process.hrtime.bigint();
+  }
+  return ops / (Number(now - start) / 1e9);
+}
+
+const format = (n) => Math.round(n).toLocaleString('en-US').padStart(10);
+
+console.log(`📏 Serializer benchmark (${PAGE_SIZE} projects per profile page)\n`);
+for (const [route, [schema, value]] of Object.entries(payloads)) {
+  const serialize = compile(schema);
+  const generic = JSON.stringify(value);
+  const compiled = serialize(value);
+  JSON.parse(compiled); // must be valid JSON
+
+  const baseline = opsPerSecond(JSON.stringify, value);
+  const fast = opsPerSecond(serialize, value);
+  // Cache miss: the cache middleware used to stringify once to send and once
+  // to store; now one serialized string does both.
+  const missBefore = opsPerSecond((v) => { JSON.stringify(v); return JSON.stringify(v); }, value);
+  // Cache hit: the stored JSON used to be parsed and re-stringified; now it is sent as-is.
+  const hitBefore = opsPerSecond((text) => JSON.stringify(JSON.parse(text)), generic);
+
+  console.log(route);
+  console.log(`  JSON.stringify ${format(baseline)} ops/s  ${format(generic.length)} bytes`);
+  console.log(`  compiled       ${format(fast)} ops/s  ${format(compiled.length)} bytes  (${(fast / baseline).toFixed(2)}x)`);
+  console.log(`  cache miss     ${format(missBefore)} -> ${format(fast)} ops/s  (${(fast / missBefore).toFixed(2)}x)`);
+  console.log(`  cache hit      ${format(hitBefore)} ops/s of parse + stringify, now none\n`);
+}
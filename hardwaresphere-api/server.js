@@ -1,17 +1,61 @@
 const app = require('./app');
 const redisClient = require('./config/redis')
+const usernameIndex = require('./services/username-index');
+const statsService = require('./services/stats-service');
+const likeService = require('./services/like-service');
+const cacheWarmer = require('./services/cache-warmer');
+const scheduler = require('./services/scheduler');
+const { emergencyCleanupOldTempFiles } = require('./middleware/upload');
 
 const PORT = process.env.PORT || 3001;
 
+const VIEW_FLUSH_INTERVAL_MS = parseInt(process.env.VIEW_FLUSH_INTERVAL_MS, 10) || 30000;
+const LIKE_AGGREGATE_INTERVAL_MS = parseInt(process.env.LIKE_AGGREGATE_INTERVAL_MS, 10) || 30000;
+
+// Maintenance jobs. 'cluster' jobs run on the elected leader only; temp files
+// and in-memory hit counts are per machine, so those run on every instance.
+function registerJobs() {
+  scheduler
+    .register('temp-cleanup', { cron: '*/30 * * * *', scope: 'instance', jitterMs: 60000 },
+      emergencyCleanupOldTempFiles)
+    .register('view-flush', { everyMs: VIEW_FLUSH_INTERVAL_MS, jitterMs: 5000 },
+      () => statsService.flushViews())
+    .register('username-sync', { everyMs: 60000, jitterMs: 10000 },
+      () => usernameIndex.syncNewProfiles())
+    .register('stats-backfill', { everyMs: 60000, jitterMs: 10000 },
+      () => statsService.backfillUserStats())
+    .register('like-aggregation', { everyMs: LIKE_AGGREGATE_INTERVAL_MS, jitterMs: 5000 },
+      () => likeService.aggregateDirty())
+    .register('hot-key-flush', { everyMs: 10000, scope: 'instance', jitterMs: 2000 },
+      () => cacheWarmer.flushHits())
+    .register('hot-key-decay', { cron: '0 * * * *', jitterMs: 60000 },
+      () => cacheWarmer.decay())
+    // Tops up hot entries that expired; the startup warm-up is per instance (below)
+    .register('cache-warm', { cron: '*/10 * * * *', jitterMs: 30000 },
+      () => cacheWarmer.warm(PORT));
+}
+
 async function startServer() {
   try {
     // Connect to Redis first
     await redisClient.connect();
+
+    // Loads in the background; username checks use Firestore until it's ready
+    usernameIndex.start();
+
+    registerJobs();
     
     // Start Express server
     app.listen(PORT, '0.0.0.0', () => {
       console.log(`🚀 Server running on port ${PORT}`);
       console.log(`📊 Redis status: ${redisClient.isConnected ? 'Connected' : 'Disconnected'}`);
+
+      // Jobs start once requests can be served (cache warming calls this server)
+      scheduler.start().catch(error => console.error('❌ Scheduler start failed:', error.message));
+
+      // FIX: Every new instance warms itself - as a cluster job only the leader
+      // would, leaving freshly deployed followers cold until the next run.
+      cacheWarmer.warm(PORT).catch(error => console.error('❌ Cache warm-up failed:', error.message));
     });
   } catch (error) {
     console.error('❌ Server startup failed:', error);
@@ -19,4 +63,7 @@ async function startServer() {
   }
 }
 
+// Hand leadership over now rather than when the lease expires
+['SIGTERM', 'SIGINT'].forEach(signal => process.on(signal, () => scheduler.stop()));
+
 startServer();
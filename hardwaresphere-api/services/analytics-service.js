@@ -0,0 +1,100 @@
+// Per-project view time series for dashboard charts.
+//
+// Each counted view increments one bucket at every resolution in a single
+// round trip, so the coarser series are rolled up as they are written and
+// reads never touch raw events. Buckets are grouped into one hash per span,
+// and retention is just the span key's TTL:
+//
+//   va:<projectId>:minute:<span>   one hour of minute buckets,  kept 2 days
+//   va:<projectId>:hour:<span>     one day of hour buckets,     kept 35 days
+//   va:<projectId>:day:<span>      30 days of day buckets,      kept 400 days
+//
+// Fields are absolute bucket numbers (epoch seconds / step).
+
+const { firestore } = require('../config/firebase');
+const redisClient = require('../config/redis');
+
+const RESOLUTIONS = {
+  minute: { step: 60, span: 60 * 60, ttl: 2 * 24 * 60 * 60 },
+  hour: { step: 60 * 60, span: 24 * 60 * 60, ttl: 35 * 24 * 60 * 60 },
+  day: { step: 24 * 60 * 60, span: 30 * 24 * 60 * 60, ttl: 400 * 24 * 60 * 60 }
+};
+
+// Chart ranges and the resolution each is drawn at.
+const RANGES = {
+  '1h': { resolution: 'minute', points: 60 },
+  '24h': { resolution: 'hour', points: 24 },
+  '7d': { resolution: 'hour', points: 168 },
+  '30d': { resolution: 'day', points: 30 },
+  '90d': { resolution: 'day', points: 90 }
+};
+
+const spanKey = (projectId, resolution, bucket) => {
+  const { step, span } = RESOLUTIONS[resolution];
+  return `va:${projectId}:${resolution}:${Math.floor((bucket * step) / span)}`;
+};
+
+class AnalyticsService {
+  constructor() {
+    this.ranges = Object.keys(RANGES);
+  }
+
+  async recordView(projectId, at = Date.now()) {
+    const seconds = Math.floor(at / 1000);
+    return redisClient.hIncrByBatch(Object.entries(RESOLUTIONS).map(([resolution, { step, ttl }]) => {
+      const bucket = Math.floor(seconds / step);
+      return { key: spanKey(projectId, resolution, bucket), field: String(bucket), amount: 1, ttlSeconds: ttl };
+    }));
+  }
+
+  /**
+   * View series for every project a user owns, in one Redis round trip.
+   * @param {string} userId
+   * @param {string} range - one of RANGES
+   * @returns {Promise<Object|null>} null when Redis is unavailable
+   */
+  async getUserViewSeries(userId, range) {
+    const { resolution, points } = RANGES[range];
+    const { step } = RESOLUTIONS[resolution];
+    const endBucket = Math.floor(Date.now() / 1000 / step);
+    const startBucket = endBucket - points + 1;
+
+    const projectsSnapshot = await firestore.collection('projects').where('userId', '==', userId).select('title').get();
+    const projects = projectsSnapshot.docs.map(doc => ({ id: doc.id, title: doc.get('title') || 'Untitled' }));
+
+    // Span keys covering [startBucket, endBucket] for each project.
+    const spanKeys = (projectId) => {
+      const keys = new Set();
+      for (let bucket = startBucket; bucket <= endBucket; bucket++) keys.add(spanKey(projectId, resolution, bucket));
+      return [...keys];
+    };
+    const keysByProject = projects.map(project => spanKeys(project.id));
+    const hashes = await redisClient.hGetAllMany(keysByProject.flat());
+    if (!hashes) return null;
+
+    const totals = new Array(points).fill(0);
+    let offset = 0;
+    const series = projects.map((project, i) => {
+      const values = new Array(points).fill(0);
+      keysByProject[i].forEach(() => {
+        Object.entries(hashes[offset++] || {}).forEach(([field, count]) => {
+          const index = Number(field) - startBucket;
+          if (index >= 0 && index < points) values[index] += Number(count);
+        });
+      });
+      values.forEach((value, j) => { totals[j] += value; });
+      return { ...project, total: values.reduce((sum, value) => sum + value, 0), series: values };
+    });
+
+    return {
+      range,
+      resolution,
+      step,
+      start: startBucket * step * 1000,
+      totals,
+      projects: series.sort((a, b) => b.total - a.total)
+    };
+  }
+}
+
+module.exports = new AnalyticsService();
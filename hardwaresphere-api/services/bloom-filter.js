@@ -0,0 +1,59 @@
+// Fixed-size Bloom filter for strings. Answers "definitely not present" or
+// "possibly present"; it never forgets, so removals must be confirmed
+// elsewhere (see username-index.js).
+
+class BloomFilter {
+  /**
+   * @param {number} expectedItems - Items the filter is sized for
+   * @param {number} falsePositiveRate - Target rate at that size, e.g. 0.01
+   */
+  constructor(expectedItems, falsePositiveRate = 0.01) {
+    const n = Math.max(1, expectedItems);
+    // Standard sizing: m = -n ln p / (ln 2)^2, k = m/n ln 2
+    this.size = Math.ceil((-n * Math.log(falsePositiveRate)) / (Math.LN2 * Math.LN2));
+    this.hashCount = Math.max(1, Math.round((this.size / n) * Math.LN2));
+    this.bits = new Uint8Array(Math.ceil(this.size / 8));
+    this.count = 0;
+  }
+
+  // Two independent 32-bit hashes (FNV-1a and a Murmur-style mix); the k
+  // probe positions are derived from them by double hashing.
+  hashes(value) {
+    let h1 = 0x811c9dc5;
+    let h2 = 0x9747b28c;
+    for (let i = 0; i < value.length; i++) {
+      const c = value.charCodeAt(i);
+      h1 = Math.imul(h1 ^ c, 0x01000193);
+      h2 = Math.imul(h2 ^ c, 0x5bd1e995);
+      h2 ^= h2 >>> 15;
+    }
+    return [h1 >>> 0, (h2 | 1) >>> 0]; // step is never 0, so the k probes differ
+  }
+
+  *positions(value) {
+    const [h1, h2] = this.hashes(value);
+    for (let i = 0; i < this.hashCount; i++) {
+      yield (h1 + i * h2) % this.size;
+    }
+  }
+
+  add(value) {
+    let added = false;
+    for (const bit of this.positions(value)) {
+      const mask = 1 << (bit & 7);
+      if ((this.bits[bit >> 3] & mask) === 0) added = true;
+      this.bits[bit >> 3] |= mask;
+    }
+    // Re-adding a name (re-seeding, sync overlap) sets no new bit
+    if (added) this.count++;
+  }
+
+  mightContain(value) {
+    for (const bit of this.positions(value)) {
+      if ((this.bits[bit >> 3] & (1 << (bit & 7))) === 0) return false;
+    }
+    return true;
+  }
+}
+
+module.exports = BloomFilter;
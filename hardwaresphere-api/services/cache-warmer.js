@@ -0,0 +1,102 @@
+// Refills the response cache for the hottest public pages after a restart,
+// deploy or Redis flush, before real traffic finds it cold.
+//
+//   cache:hot   Redis sorted set  request path -> decayed hit count
+//
+// The cache middleware reports anonymous lookups of warmable routes here;
+// counts are batched in memory and written every few seconds. Scores halve
+// every hour, so "hot" follows recent traffic. The scheduler drives the
+// periodic work; each instance also warms once as it starts (see server.js).
+//
+// Warming replays the top paths against this instance over loopback, so the
+// normal route handler and cache middleware (including shouldCache) produce
+// exactly what a real request would have cached.
+
+const crypto = require('crypto');
+const redisClient = require('../config/redis');
+
+const HOT_KEY = 'cache:hot';
+const TOP_N = parseInt(process.env.CACHE_WARM_TOP_N, 10) || 200;
+const CONCURRENCY = parseInt(process.env.CACHE_WARM_CONCURRENCY, 10) || 8;
+const DECAY_INTERVAL_MS = 60 * 60 * 1000;
+const MAX_TRACKED = 5000;
+const REQUEST_TIMEOUT_MS = 15000;
+
+class CacheWarmer {
+  constructor() {
+    this.pending = new Map();
+    // Marks warm-up requests: they skip hit counting and the rate limiter.
+    // Random per process, so it can't be forged from outside.
+    this.token = crypto.randomBytes(16).toString('hex');
+    this.status = { state: 'idle', total: 0, warmed: 0, failed: 0 };
+  }
+
+  isWarmRequest(req) {
+    return req.get('x-cache-warm') === this.token;
+  }
+
+  record(path) {
+    this.pending.set(path, (this.pending.get(path) || 0) + 1);
+  }
+
+  async flushHits() {
+    if (this.pending.size === 0) return;
+    const increments = Object.fromEntries(this.pending);
+    this.pending.clear();
+    await redisClient.zIncrByMany(HOT_KEY, increments);
+  }
+
+  /** Halves all scores; the hourly key guards against a run repeated by a new leader. */
+  async decay() {
+    const hour = Math.floor(Date.now() / DECAY_INTERVAL_MS);
+    if (await redisClient.setIfAbsent(`${HOT_KEY}:decayed:${hour}`, 1, DECAY_INTERVAL_MS / 1000 * 2)) {
+      await redisClient.zDecay(HOT_KEY, 0.5, 1, MAX_TRACKED);
+    }
+  }
+
+  /**
+   * Requests the hottest paths from this server with bounded concurrency.
+   * @param {number} port - the port this instance is listening on
+   */
+  async warm(port) {
+    // The startup warm-up and the scheduled top-up can overlap on the leader
+    if (this.status.state === 'warming') return;
+    const paths = await redisClient.zTop(HOT_KEY, TOP_N);
+    const startedAt = Date.now();
+    this.status = { state: 'warming', total: paths.length, warmed: 0, failed: 0, startedAt: new Date(startedAt).toISOString() };
+    if (paths.length === 0) {
+      this.status.state = 'done';
+      return;
+    }
+
+    let next = 0;
+    const worker = async () => {
+      while (next < paths.length) {
+        const path = paths[next++];
+        try {
+          const response = await fetch(`http://127.0.0.1:${port}${path}`, {
+            headers: { 'x-cache-warm': this.token },
+            signal: AbortSignal.timeout(REQUEST_TIMEOUT_MS)
+          });
+          await response.body?.cancel();
+          if (response.ok) this.status.warmed++;
+          else this.status.failed++;
+        } catch {
+          this.status.failed++;
+        }
+      }
+    };
+    try {
+      await Promise.all(Array.from({ length: Math.min(CONCURRENCY, paths.length) }, worker));
+    } catch (error) {
+      this.status.state = 'failed';
+      throw error;
+    }
+
+    this.status.state = 'done';
+    this.status.durationMs = Date.now() - startedAt;
+    console.log(`🔥 Cache warmed: ${this.status.warmed}/${paths.length} paths in ${this.status.durationMs}ms (${this.status.failed} failed)`);
+  }
+}
+
+module.exports = new CacheWarmer();
@@ -0,0 +1,63 @@
+// Content-defined chunking (gear hash, as in FastCDC).
+//
+// Boundaries fall where a rolling hash of the last 32 bytes matches a mask,
+// so they depend on content rather than offset: inserting or removing bytes
+// in one part of a model only changes the chunks around the edit, and every
+// other chunk keeps its hash and is deduplicated against earlier revisions.
+
+const crypto = require('crypto');
+
+const MIN_SIZE = 64 * 1024;
+const AVG_BITS = 18; // 256KB average
+const MAX_SIZE = 1024 * 1024;
+// FIX: The top bits: with `hash << 1`, bit k only depends on the last k + 1
+// bytes, so a low-bit mask would look at just 18 of them. Changing the mask
+// moves boundaries; existing manifests stay valid, they just share fewer
+// chunks with new ones.
+const MASK = (((1 << AVG_BITS) - 1) << (32 - AVG_BITS)) >>> 0;
+
+// Must never change: boundaries, and therefore stored chunk hashes, derive from it.
+const GEAR = new Uint32Array(256);
+for (let i = 0; i < 256; i++) {
+  GEAR[i] = crypto.createHash('sha256').update(`gear:${i}`).digest().readUInt32BE(0);
+}
+
+/**
+ * Splits a byte stream into chunks.
+ * @param {AsyncIterable<Buffer>} stream
+ * @yields {{ hash: string, data: Buffer }} sha256 of each chunk and its bytes
+ */
+async function* chunkStream(stream) {
+  let pending = [];
+  let pendingSize = 0;
+  let hash = 0;
+
+  const emit = (buffers, size) => {
+    const data = buffers.length === 1 ? buffers[0] : Buffer.concat(buffers, size);
+    return { hash: crypto.createHash('sha256').update(data).digest('hex'), data };
+  };
+
+  for await (const input of stream) {
+    let start = 0;
+    for (let i = 0; i < input.length; i++) {
+      hash = ((hash << 1) + GEAR[input[i]]) >>> 0;
+      const size = pendingSize + (i - start + 1);
+      if ((size >= MIN_SIZE && (hash & MASK) === 0) || size >= MAX_SIZE) {
+        pending.push(input.subarray(start, i + 1));
+        yield emit(pending, size);
+        pending = [];
+        pendingSize = 0;
+        hash = 0;
+        start = i + 1;
+      }
+    }
+    if (start < input.length) {
+      pending.push(input.subarray(start));
+      pendingSize += input.length - start;
+    }
+  }
+
+  if (pendingSize > 0) yield emit(pending, pendingSize);
+}
+
+module.exports = { chunkStream, MAX_SIZE };
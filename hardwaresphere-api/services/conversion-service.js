@@ -4,10 +4,59 @@ const { NodeIO, Document } = require('@gltf-transform/core');
 const { KHRDracoMeshCompression } = require('@gltf-transform/extensions');
 const { draco } = require('@gltf-transform/functions');
 const draco3d = require('draco3dgltf');
+const { Worker } = require('worker_threads');
+
+// 🚀 OPTIMIZATION: Peak memory per conversion, to size instances and spot
+// leaks. RSS is process-wide, so it includes whatever else was running.
+const RSS_SAMPLE_INTERVAL_MS = 100;
+const RECENT_CONVERSIONS = 50;
+
+// Client-converted GLBs are Draco-compressed, so far smaller than the STL
+const MAX_CLIENT_GLB_BYTES = 50 * 1024 * 1024;
+const GLB_VALIDATION_TIMEOUT_MS = 30000;
+
+/**
+ * Tracks peak RSS from a timer plus explicit samples between phases: parsing
+ * and Draco encoding block the event loop, so the timer alone would miss them.
+ */
+function trackPeakRss() {
+  const startRss = process.memoryUsage.rss();
+  let peak = startRss;
+  const phases = {};
+  const sample = () => {
+    peak = Math.max(peak, process.memoryUsage.rss());
+  };
+  const timer = setInterval(sample, RSS_SAMPLE_INTERVAL_MS).unref();
+  return {
+    mark(phase) {
+      sample();
+      phases[phase] = peak;
+    },
+    stop() {
+      clearInterval(timer);
+      sample();
+      return { startRss, peakRss: peak, rssGrowth: peak - startRss, phases };
+    }
+  };
+}
 
 class ConversionService {
+  constructor() {
+    this.recentConversions = [];
+  }
+
+  recordConversion(entry) {
+    this.recentConversions.push(entry);
+    if (this.recentConversions.length > RECENT_CONVERSIONS) this.recentConversions.shift();
+  }
+
+  /** Newest first, for GET /api/admin/conversions. */
+  getRecentConversions() {
+    return [...this.recentConversions].reverse();
+  }
 
   async convertStlToGltf(stlFilePath, outputPath, options = {}) {
+    const memory = trackPeakRss();
     try {
       const glbPath = outputPath.replace(/\.(gltf|glb)$/i, '.glb');
       console.log(`Converting STL to Draco-compressed GLB: ${stlFilePath} → ${glbPath}`);
@@ -20,11 +69,14 @@ class ConversionService {
         });
 
       const stlBuffer = await fs.readFile(stlFilePath);
+      memory.mark('read');
       
       // Parse the STL, now with corrected color handling.
       const meshData = this.parseStlWithColor(stlBuffer);
+      memory.mark('parse');
       
       const document = this.createGltfDocument(meshData);
+      memory.mark('document');
 
       // Apply Draco compression - but preserve COLOR_0 attribute
       await document.transform(
@@ -38,10 +90,12 @@ class ConversionService {
           },
         })
       );
+      memory.mark('draco');
 
       const glbBuffer = await io.writeBinary(document);
 
       await fs.writeFile(glbPath, glbBuffer);
+      const { startRss, peakRss, rssGrowth, phases } = memory.stop();
 
       const originalSize = stlBuffer.length;
       const convertedSize = glbBuffer.length;
@@ -50,6 +104,19 @@ class ConversionService {
 
       console.log(`✅ STL → Draco GLB conversion completed in ${conversionTime}ms`);
       console.log(`📊 Size reduction: ${this.formatFileSize(originalSize)} → ${this.formatFileSize(convertedSize)} (${compressionRatio}% smaller)`);
+      console.log(`🧠 Peak RSS ${this.formatFileSize(peakRss)} (+${this.formatFileSize(rssGrowth)} during conversion)`);
+
+      this.recordConversion({
+        file: path.basename(stlFilePath),
+        finishedAt: new Date().toISOString(),
+        originalSize,
+        triangleCount: meshData.triangleCount,
+        conversionTime,
+        startRss,
+        peakRss,
+        rssGrowth,
+        phases
+      });
       
       return {
         success: true,
@@ -57,17 +124,114 @@ class ConversionService {
         convertedSize,
         compressionRatio: Math.max(0, parseFloat(compressionRatio)),
         conversionTime,
+        peakRss,
+        rssGrowth,
         triangleCount: meshData.triangleCount,
         filePath: glbPath,
         hasColors: meshData.colors && meshData.colors.length > 0  // FIX: Include color info in result
       };
 
     } catch (error) {
+      const { startRss, peakRss, rssGrowth, phases } = memory.stop();
+      this.recordConversion({
+        file: path.basename(stlFilePath),
+        finishedAt: new Date().toISOString(),
+        error: error.message,
+        startRss,
+        peakRss,
+        rssGrowth,
+        phases
+      });
       console.error('❌ STL → GLB conversion failed:', error);
       throw new Error(`Conversion failed: ${error.message}`);
     }
   }
 
+  /**
+   * Checks a GLB produced in the browser before it replaces a server-side
+   * conversion: size, container header and declared counts first (cheap),
+   * then a full parse with Draco decoding - in a worker thread, as the input
+   * is untrusted - so a malformed or empty file never reaches the viewers.
+   */
+  async validateGlb(glbFilePath, { maxTriangles = 5000000 } = {}) {
+    const { size } = await fs.stat(glbFilePath);
+    // FIX: Cap the input before anything is decoded
+    if (size > MAX_CLIENT_GLB_BYTES) throw new Error(`GLB exceeds ${MAX_CLIENT_GLB_BYTES / 1024 / 1024}MB`);
+
+    const buffer = await fs.readFile(glbFilePath);
+    if (buffer.length < 20) throw new Error('GLB file is truncated');
+    if (buffer.readUInt32LE(0) !== 0x46546C67) throw new Error('Not a GLB file (bad magic)');
+    if (buffer.readUInt32LE(4) !== 2) throw new Error('Unsupported glTF version');
+    if (buffer.readUInt32LE(8) !== buffer.length) throw new Error('GLB length header does not match file size');
+    if (buffer.readUInt32LE(16) !== 0x4E4F534A) throw new Error('GLB is missing its JSON chunk');
+
+    // Declared sizes first: a model that claims too much is refused undecoded.
+    const jsonLength = buffer.readUInt32LE(12);
+    if (20 + jsonLength > buffer.length) throw new Error('GLB JSON chunk is truncated');
+    let gltf;
+    try {
+      gltf = JSON.parse(buffer.toString('utf8', 20, 20 + jsonLength));
+    } catch {
+      throw new Error('GLB JSON chunk is not valid JSON');
+    }
+    const accessors = Array.isArray(gltf.accessors) ? gltf.accessors : [];
+    let declaredTriangles = 0;
+    for (const mesh of Array.isArray(gltf.meshes) ? gltf.meshes : []) {
+      for (const prim of Array.isArray(mesh.primitives) ? mesh.primitives : []) {
+        const accessor = accessors[prim.indices ?? prim.attributes?.POSITION];
+        declaredTriangles += Math.floor((Number(accessor?.count) || 0) / 3);
+      }
+    }
+    if (declaredTriangles > maxTriangles) throw new Error(`GLB exceeds ${maxTriangles} triangles`);
+
+    const { triangleCount, primitiveCount, hasColors } = await this.decodeInWorker(glbFilePath);
+    if (primitiveCount === 0) throw new Error('GLB contains no mesh data');
+    if (triangleCount > maxTriangles) throw new Error(`GLB exceeds ${maxTriangles} triangles`);
+
+    return { size: buffer.length, triangleCount, hasColors };
+  }
+
+  /**
+   * Full Draco decode in services/glb-validation-worker.js. A decode that
+   * outlasts the timeout terminates the worker; the next call starts another.
+   */
+  decodeInWorker(glbFilePath) {
+    if (!this.validationWorker) {
+      const worker = new Worker(path.join(__dirname, 'glb-validation-worker.js'));
+      const pending = new Map();
+      const failAll = (error) => {
+        pending.forEach(({ reject, timer }) => { clearTimeout(timer); reject(error); });
+        pending.clear();
+        if (this.validationWorker?.worker === worker) this.validationWorker = null;
+      };
+      worker.on('message', ({ id, result, error }) => {
+        const request = pending.get(id);
+        if (!request) return;
+        pending.delete(id);
+        clearTimeout(request.timer);
+        if (error) request.reject(new Error(error));
+        else request.resolve(result);
+      });
+      worker.on('error', failAll);
+      worker.on('exit', () => failAll(new Error('GLB validation worker exited')));
+      worker.unref();
+      this.validationWorker = { worker, pending, nextId: 0 };
+    }
+
+    const { worker, pending } = this.validationWorker;
+    const id = ++this.validationWorker.nextId;
+    return new Promise((resolve, reject) => {
+      const timer = setTimeout(() => {
+        pending.delete(id);
+        reject(new Error('GLB validation timed out'));
+        console.warn(`⚠️ GLB validation timed out after ${GLB_VALIDATION_TIMEOUT_MS}ms, restarting worker`);
+        worker.terminate();
+      }, GLB_VALIDATION_TIMEOUT_MS);
+      pending.set(id, { resolve, reject, timer });
+      worker.postMessage({ id, filePath: path.resolve(glbFilePath) });
+    });
+  }
+
   createGltfDocument(meshData) {
     const document = new Document();
     const buffer = document.createBuffer();
@@ -1,14 +1,44 @@
 const { storage } = require('../config/firebase'); // Import the initialized storage instance
+const crypto = require('crypto');
+const fsSync = require('fs');
 const fs = require('fs').promises;
 const path = require('path');
 const sharp = require('sharp');
 
+// ✅ NEW: Browsers now resize and encode images before upload. A WebP that is
+// already within the target width is stored as-is instead of being re-encoded.
+// FIX: Only when it is what our own encoder would produce - a single frame
+// with no EXIF/XMP/IPTC (which can carry GPS) and lossy-sized - since stored
+// bytes are served to everyone. Anything else goes through sharp, which strips
+// metadata and re-compresses.
+const MAX_PASSTHROUGH_BYTES_PER_PIXEL = 0.5; // quality-80 lossy WebP is ~0.1-0.3
+
+async function isAlreadyWebOptimized(inputPath, maxWidth) {
+  try {
+    const [{ format, width, height, pages, exif, xmp, iptc }, { size }] = await Promise.all([
+      sharp(inputPath).metadata(),
+      fs.stat(inputPath)
+    ]);
+    return format === 'webp' && !!width && width <= maxWidth &&
+      (pages || 1) === 1 &&
+      !exif && !xmp && !iptc &&
+      size <= width * height * MAX_PASSTHROUGH_BYTES_PER_PIXEL;
+  } catch {
+    return false;
+  }
+}
+
 // Compress image for web
 async function compressImageForWeb(inputPath, originalName, maxWidth = 1920) {
   const ext = path.extname(originalName).toLowerCase();
   const isImage = ['.jpg', '.jpeg', '.png', '.webp', '.gif'].includes(ext);
   
   if (!isImage) return null;
+
+  if (await isAlreadyWebOptimized(inputPath, maxWidth)) {
+    console.log(`⏭️ ${originalName} is already an optimized WebP, skipping re-encode`);
+    return inputPath;
+  }
   
   const compressedPath = inputPath + '_compressed.webp';
   
@@ -39,6 +69,32 @@ class FileService {
     this.tempFilesCleanedUp = new Set();
   }
 
+  /**
+   * True when the file is a metadata-free, single-frame, lossy-sized WebP no
+   * wider than maxWidth (already resized client-side)
+   * @param {string} inputPath - Path to the temp image
+   * @param {number} maxWidth - Target width in pixels
+   * @returns {Promise<boolean>}
+   */
+  isAlreadyWebOptimized(inputPath, maxWidth) {
+    return isAlreadyWebOptimized(inputPath, maxWidth);
+  }
+
+  /**
+   * SHA-256 of a file on disk, streamed so large models aren't held in memory
+   * @param {string} filePath - Path to the file
+   * @returns {Promise<string>} - Hex digest
+   */
+  hashFile(filePath) {
+    return new Promise((resolve, reject) => {
+      const hash = crypto.createHash('sha256');
+      fsSync.createReadStream(filePath)
+        .on('error', reject)
+        .on('data', chunk => hash.update(chunk))
+        .on('end', () => resolve(hash.digest('hex')));
+    });
+  }
+
   /**
    * Upload a file to Firebase Storage with automatic temp cleanup
    * @param {Object} file - Multer file object
@@ -63,6 +119,8 @@ class FileService {
 
       // 1. Read the file asynchronously first
       const buffer = await fs.readFile(file.path);
+      // ✅ NEW: Stored with the file so edits can skip re-uploading identical content
+      const contentHash = crypto.createHash('sha256').update(buffer).digest('hex');
       
       // Create upload stream
       const stream = fileUpload.createWriteStream({
@@ -70,7 +128,8 @@ class FileService {
               contentType: file.mimetype,
               metadata: {
                   originalName: file.originalname,
-                  uploadedAt: new Date().toISOString()
+                  uploadedAt: new Date().toISOString(),
+                  contentHash
               }
           }
       });
@@ -95,7 +154,8 @@ class FileService {
           contentType: metadata.contentType,
           uploadedAt: metadata.metadata?.uploadedAt,
           originalName: file.originalname,
-          storagePath: storagePath
+          storagePath: storagePath,
+          contentHash
       };
       
   } catch (error) {
@@ -112,9 +172,10 @@ class FileService {
    * @param {Array} files - Array of multer file objects
    * @param {string} userId - User ID
    * @param {string} projectId - Project ID
+   * @param {Set<string>} [takenPaths] - Storage paths that must not be overwritten
    * @returns {Promise<Object>} - Organized file data
    */
-  async uploadProjectFiles(files, userId, projectId) {
+  async uploadProjectFiles(files, userId, projectId, takenPaths = null) {
     const uploadedFiles = {
       models: [],
       attachments: []
@@ -128,7 +189,7 @@ class FileService {
         try {
           const fileType = this.getFileType(file);
           const fileName = this.sanitizeFileName(file.originalname);
-          const storagePath = `projects/${userId}/${projectId}/${fileType}s/${fileName}`;
+          const storagePath = this.uniqueStoragePath(`projects/${userId}/${projectId}/${fileType}s/${fileName}`, takenPaths);
           
           // Upload file (temp cleanup happens inside uploadToFirebase)
           const uploadResult = await this.uploadToFirebase(file, storagePath);
@@ -175,6 +236,10 @@ class FileService {
    */
     async uploadBannerImage(file, userId, projectId) {
     if (!file) return null;
+
+    // contentHash is the hash of the stored WebP, like every other file's;
+    // sourceHash, of what the client sent, recognises an unchanged re-upload.
+    const sourceHash = await this.hashFile(file.path);
     
     // Compress the image first
     const compressedPath = await compressImageForWeb(file.path, file.originalname, 1200);
@@ -192,10 +257,12 @@ class FileService {
       
       const result = await this.uploadToFirebase(compressedFile, storagePath);
       
-      // Clean up compressed temp file
-      await this.cleanupSingleTempFile(compressedPath);
+      // Clean up compressed temp file (the multer temp is left to the upload middleware)
+      if (compressedPath !== file.path) {
+        await this.cleanupSingleTempFile(compressedPath);
+      }
       
-      return result;
+      return { ...result, sourceHash };
     }
     
     // Fallback to original if compression fails
@@ -204,7 +271,7 @@ class FileService {
     const fileName = `banner-${timestamp}${extension}`;
     const storagePath = `projects/${userId}/${projectId}/${fileName}`;
     
-    return await this.uploadToFirebase(file, storagePath);
+    return { ...(await this.uploadToFirebase(file, storagePath)), sourceHash };
   }
   
   /**
@@ -375,6 +442,25 @@ class FileService {
     return `${sanitized}${ext}`;
   }
   
+  /**
+   * ✅ NEW: The path itself, or a timestamped variant when it is taken, so an
+   * upload never overwrites an object a project still points at.
+   * @param {string} storagePath - Preferred path in Firebase Storage
+   * @param {Set<string>} [takenPaths] - Paths in use
+   * @returns {string}
+   */
+  uniqueStoragePath(storagePath, takenPaths) {
+    if (!takenPaths || !takenPaths.has(storagePath)) return storagePath;
+    const extension = path.extname(storagePath);
+    const base = storagePath.slice(0, storagePath.length - extension.length);
+    let stamp = Date.now();
+    let candidate;
+    do {
+      candidate = `${base}-${stamp++}${extension}`;
+    } while (takenPaths.has(candidate));
+    return candidate;
+  }
+
   /**
    * Delete file from Firebase Storage
    * @param {string} storagePath - Path in Firebase Storage
@@ -0,0 +1,44 @@
+// Worker thread for ConversionService.validateGlb: Draco-decodes an uploaded
+// GLB and counts what is really in it. Decoding untrusted input is CPU-heavy
+// and runs in WASM, so it stays off the API's event loop; a file that hangs
+// the decoder only costs this thread, which the service then replaces.
+
+const { parentPort } = require('worker_threads');
+const fs = require('fs').promises;
+const { NodeIO } = require('@gltf-transform/core');
+const { KHRDracoMeshCompression } = require('@gltf-transform/extensions');
+const draco3d = require('draco3dgltf');
+
+const io = draco3d.createDecoderModule().then(decoder =>
+  new NodeIO()
+    .registerExtensions([KHRDracoMeshCompression])
+    .registerDependencies({ 'draco3d.decoder': decoder })
+);
+
+async function inspect(filePath) {
+  const buffer = await fs.readFile(filePath);
+  const document = await (await io).readBinary(new Uint8Array(buffer.buffer, buffer.byteOffset, buffer.byteLength));
+
+  let triangleCount = 0;
+  let primitiveCount = 0;
+  let hasColors = false;
+  for (const mesh of document.getRoot().listMeshes()) {
+    for (const prim of mesh.listPrimitives()) {
+      const position = prim.getAttribute('POSITION');
+      if (!position) throw new Error('GLB primitive has no POSITION attribute');
+      const indices = prim.getIndices();
+      triangleCount += Math.floor((indices ? indices.getCount() : position.getCount()) / 3);
+      hasColors = hasColors || !!prim.getAttribute('COLOR_0');
+      primitiveCount++;
+    }
+  }
+  return { triangleCount, primitiveCount, hasColors };
+}
+
+parentPort.on('message', async ({ id, filePath }) => {
+  try {
+    parentPort.postMessage({ id, result: await inspect(filePath) });
+  } catch (error) {
+    parentPort.postMessage({ id, error: error.message });
+  }
+});
@@ -0,0 +1,243 @@
+// Serves stored images resized to the width a page actually renders.
+// The frontend's next/image loader (lib/image-loader.ts) points <Image>
+// srcsets at GET /api/images?src=<signed url>&w=<width>&q=<quality>.
+//
+// Access control: the signed Storage URL is the capability. Every request
+// re-proves it against Storage (memoized until the URL expires), so a cached
+// variant is only ever served to someone holding a valid URL for the source.
+
+const crypto = require('crypto');
+const fs = require('fs').promises;
+const os = require('os');
+const path = require('path');
+const sharp = require('sharp');
+const { storage } = require('../config/firebase');
+
+// Must match images.deviceSizes + images.imageSizes in next.config.ts.
+// Anything else is rejected so the cache can't be filled with odd sizes.
+const ALLOWED_WIDTHS = [32, 64, 96, 128, 256, 384, 640, 828, 1080, 1200, 1920];
+const DEFAULT_QUALITY = 75;
+
+const CACHE_DIR = path.resolve(process.env.IMAGE_CACHE_DIR || path.join(os.tmpdir(), 'hardwaresphere-image-cache'));
+const CACHE_MAX_BYTES = (parseInt(process.env.IMAGE_CACHE_MAX_MB, 10) || 512) * 1024 * 1024;
+const MAX_SOURCE_BYTES = 20 * 1024 * 1024;
+const MAX_BROWSER_CACHE_SECONDS = 24 * 60 * 60;
+const MAX_VERIFIED_URLS = 2000;
+const FETCH_TIMEOUT_MS = 10000;
+
+class ImageError extends Error {
+  constructor(message, status) {
+    super(message);
+    this.status = status;
+  }
+}
+
+class ImageService {
+  constructor() {
+    this.allowedWidths = ALLOWED_WIDTHS;
+
+    // Disk LRU index: file name -> size. Map order is recency order.
+    this.index = new Map();
+    this.totalBytes = 0;
+    this.ready = this.loadIndex();
+
+    // Signed URL -> { etag, expiresAt } once Storage has accepted it.
+    this.verified = new Map();
+    // Variants being generated, so concurrent requests share the work.
+    this.inFlight = new Map();
+  }
+
+  // --- Request validation ---
+
+  /**
+   * Parses a v4 signed URL for our bucket into its storage path and expiry.
+   * @param {string} src - Signed URL as handed out by the API
+   * @returns {{ storagePath: string, expiresAt: number }}
+   */
+  parseSource(src) {
+    let url;
+    try {
+      url = new URL(src);
+    } catch {
+      throw new ImageError('Invalid image source', 400);
+    }
+
+    const bucketPrefix = `/${storage.bucket().name}/`;
+    if (url.protocol !== 'https:' || url.hostname !== 'storage.googleapis.com' || !url.pathname.startsWith(bucketPrefix)) {
+      throw new ImageError('Image source is not in this bucket', 400);
+    }
+
+    const signedAt = url.searchParams.get('X-Goog-Date');
+    const lifetime = parseInt(url.searchParams.get('X-Goog-Expires'), 10);
+    const match = signedAt && signedAt.match(/^(\d{4})(\d{2})(\d{2})T(\d{2})(\d{2})(\d{2})Z$/);
+    if (!match || !lifetime || !url.searchParams.get('X-Goog-Signature')) {
+      throw new ImageError('Image source is not a signed URL', 400);
+    }
+
+    const [, y, mo, d, h, mi, s] = match.map(Number);
+    const expiresAt = Date.UTC(y, mo - 1, d, h, mi, s) + lifetime * 1000;
+    if (expiresAt <= Date.now()) {
+      throw new ImageError('Image URL has expired', 403);
+    }
+
+    return {
+      storagePath: decodeURIComponent(url.pathname.slice(bucketPrefix.length)),
+      expiresAt
+    };
+  }
+
+  parseWidth(value) {
+    const width = parseInt(value, 10);
+    if (!this.allowedWidths.includes(width)) {
+      throw new ImageError(`Width must be one of ${this.allowedWidths.join(', ')}`, 400);
+    }
+    return width;
+  }
+
+  parseQuality(value) {
+    if (value === undefined) return DEFAULT_QUALITY;
+    const quality = parseInt(value, 10);
+    if (!(quality >= 1 && quality <= 100)) {
+      throw new ImageError('Quality must be between 1 and 100', 400);
+    }
+    // Steps of 5 are indistinguishable in practice and keep the cache small.
+    return Math.max(5, Math.round(quality / 5) * 5);
+  }
+
+  /**
+   * Confirms Storage accepts the signed URL and returns the object's etag.
+   * A one-byte ranged GET is enough: the signature covers the method and
+   * path, not the Range header.
+   */
+  async verifySource(src, expiresAt) {
+    const known = this.verified.get(src);
+    if (known && known.expiresAt > Date.now()) return known.etag;
+
+    const response = await fetch(src, {
+      headers: { Range: 'bytes=0-0' },
+      signal: AbortSignal.timeout(FETCH_TIMEOUT_MS)
+    });
+    await response.body?.cancel();
+
+    if (response.status === 404) throw new ImageError('Image not found', 404);
+    if (!response.ok) throw new ImageError('Image URL was rejected by storage', 403);
+
+    const etag = (response.headers.get('etag') || '').replace(/"/g, '');
+    if (this.verified.size >= MAX_VERIFIED_URLS) {
+      this.verified.delete(this.verified.keys().next().value);
+    }
+    this.verified.set(src, { etag, expiresAt });
+    return etag;
+  }
+
+  // --- Variants ---
+
+  /**
+   * Returns a WebP of the source no wider than `width`, from the disk cache
+   * when possible.
+   * @returns {Promise<{ filePath: string, maxAge: number }>}
+   */
+  async getVariant(src, width, quality) {
+    const { storagePath, expiresAt } = this.parseSource(src);
+    const etag = await this.verifySource(src, expiresAt);
+    await this.ready;
+
+    // The etag changes when an object is overwritten, which retires old variants.
+    const key = crypto.createHash('sha256').update(`${storagePath}\n${etag}\n${width}\n${quality}`).digest('hex');
+    const fileName = `${key}.webp`;
+    const maxAge = Math.min(MAX_BROWSER_CACHE_SECONDS, Math.floor((expiresAt - Date.now()) / 1000));
+
+    if (this.index.has(fileName)) {
+      this.touch(fileName, this.index.get(fileName));
+      return { filePath: path.join(CACHE_DIR, fileName), maxAge };
+    }
+
+    if (!this.inFlight.has(fileName)) {
+      const job = this.generate(storagePath, fileName, width, quality)
+        .finally(() => this.inFlight.delete(fileName));
+      this.inFlight.set(fileName, job);
+    }
+    await this.inFlight.get(fileName);
+
+    return { filePath: path.join(CACHE_DIR, fileName), maxAge };
+  }
+
+  async generate(storagePath, fileName, width, quality) {
+    const file = storage.bucket().file(storagePath);
+    const [metadata] = await file.getMetadata().catch(() => {
+      throw new ImageError('Image not found', 404);
+    });
+    if (parseInt(metadata.size, 10) > MAX_SOURCE_BYTES) {
+      throw new ImageError('Image is too large to resize', 413);
+    }
+
+    const [source] = await file.download();
+    const output = await sharp(source)
+      .rotate()
+      .resize(width, null, { fit: 'inside', withoutEnlargement: true })
+      .webp({ quality, effort: 4 })
+      .toBuffer()
+      .catch(error => {
+        throw new ImageError(`Could not process image: ${error.message}`, 415);
+      });
+
+    // Write then rename so a concurrent reader never sees a partial file.
+    const filePath = path.join(CACHE_DIR, fileName);
+    const tempPath = `${filePath}.${process.pid}.tmp`;
+    await fs.writeFile(tempPath, output);
+    await fs.rename(tempPath, filePath);
+
+    this.touch(fileName, output.length);
+    console.log(`🖼️ Generated ${width}w variant of ${storagePath} (${Math.round(output.length / 1024)}KB)`);
+    await this.evict();
+  }
+
+  // --- Disk LRU ---
+
+  touch(fileName, size) {
+    if (this.index.has(fileName)) {
+      this.totalBytes -= this.index.get(fileName);
+      this.index.delete(fileName);
+    }
+    this.index.set(fileName, size);
+    this.totalBytes += size;
+  }
+
+  async evict() {
+    for (const [fileName, size] of this.index) {
+      if (this.totalBytes <= CACHE_MAX_BYTES) break;
+      this.index.delete(fileName);
+      this.totalBytes -= size;
+      await fs.unlink(path.join(CACHE_DIR, fileName)).catch(() => {});
+    }
+  }
+
+  /** Rebuilds the index from disk so the cache survives restarts. */
+  async loadIndex() {
+    try {
+      await fs.mkdir(CACHE_DIR, { recursive: true });
+      const names = await fs.readdir(CACHE_DIR);
+      const files = [];
+
+      for (const name of names) {
+        const filePath = path.join(CACHE_DIR, name);
+        if (!name.endsWith('.webp')) {
+          // Leftover temp files from an interrupted write.
+          await fs.unlink(filePath).catch(() => {});
+          continue;
+        }
+        const stat = await fs.stat(filePath).catch(() => null);
+        if (stat) files.push({ name, size: stat.size, usedAt: stat.atimeMs });
+      }
+
+      files.sort((a, b) => a.usedAt - b.usedAt).forEach(file => this.touch(file.name, file.size));
+      await this.evict();
+      console.log(`🖼️ Image cache ready: ${this.index.size} variants, ${Math.round(this.totalBytes / 1024 / 1024)}MB in ${CACHE_DIR}`);
+    } catch (error) {
+      console.error('❌ Image cache init failed:', error.message);
+    }
+  }
+}
+
+module.exports = new ImageService();
+module.exports.ImageError = ImageError;
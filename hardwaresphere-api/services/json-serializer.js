@@ -0,0 +1,115 @@
+// Compiles a response schema into a specialised JSON serializer, in the spirit
+// of fast-json-stringify.
+//
+// JSON.stringify has to discover every object's keys and each value's type as
+// it goes. A compiled serializer already knows them: it is generated code that
+// reads exactly the declared properties, in order, with the right encoding for
+// each. Properties the schema doesn't declare are never read, so internal
+// fields (search terms, storage bookkeeping) can't leak into a response.
+//
+// Supported schema keywords, a subset of JSON Schema:
+//   type: 'object' | 'array' | 'string' | 'number' | 'integer' | 'boolean'
+//         (or a list such as ['string', 'null']; null is always allowed)
+//   properties        for objects; undeclared properties are dropped
+//   additionalProperties: true   keeps an object as-is (free-form data)
+//   items             for arrays
+// A schema without a type (e.g. {}) passes its value through JSON.stringify,
+// which also covers Firestore timestamps and other opaque values.
+//
+// Values that don't match their declared type are serialized as JSON.stringify
+// would, so a schema that is out of date degrades to generic output rather
+// than to wrong output.
+
+const asAny = (value) => JSON.stringify(value) ?? 'null';
+
+// Most strings (ids, names, URLs) need no escaping and are quoted directly.
+const NEEDS_ESCAPE = /[\u0000-\u001f"\\\ud800-\udfff]/;
+
+// Dates become ISO strings, as with JSON.stringify (which calls toJSON).
+const asString = (value) => {
+  if (typeof value === 'string') return NEEDS_ESCAPE.test(value) ? JSON.stringify(value) : `"${value}"`;
+  if (value instanceof Date) return Number.isNaN(value.getTime()) ? 'null' : `"${value.toISOString()}"`;
+  return asAny(value);
+};
+
+const asNumber = (value) => {
+  if (typeof value === 'number') return Number.isFinite(value) ? `${value}` : 'null';
+  return asAny(value);
+};
+
+const asBoolean = (value) => {
+  if (value === true) return 'true';
+  if (value === false) return 'false';
+  return asAny(value);
+};
+
+const typeOf = (schema) => {
+  const types = Array.isArray(schema.type) ? schema.type : [schema.type];
+  return types.find(type => type && type !== 'null');
+};
+
+/** Emits a function for `schema` and returns its name. */
+function build(schema, functions) {
+  const type = typeOf(schema);
+  if (!type || (type === 'object' && schema.additionalProperties === true)) return 'asAny';
+  if (type === 'string') return 'asString';
+  if (type === 'number' || type === 'integer') return 'asNumber';
+  if (type === 'boolean') return 'asBoolean';
+
+  const index = functions.length;
+  const name = `s${index}`;
+  functions.push(null); // reserve the slot; nested schemas are emitted first
+
+  let body;
+  if (type === 'array') {
+    const item = build(schema.items || {}, functions);
+    body = `
+      if (!Array.isArray(value)) return asAny(value);
+      let json = '[';
+      for (let i = 0; i < value.length; i++) {
+        if (i > 0) json += ',';
+        const item = value[i];
+        json += item === undefined || item === null ? 'null' : ${item}(item);
+      }
+      return json + ']';`;
+  } else if (type === 'object') {
+    const properties = Object.entries(schema.properties || {}).map(([key, propertySchema]) => {
+      const serialize = build(propertySchema, functions);
+      // Strings are by far the most common values; quote plain ones inline.
+      const encode = serialize === 'asString'
+        ? `(typeof property === 'string' && !NEEDS_ESCAPE.test(property) ? '"' + property + '"' : asString(property))`
+        : `${serialize}(property)`;
+      return `
+      property = value[${JSON.stringify(key)}];
+      if (property !== undefined && typeof property !== 'function') {
+        json += (json.length > 1 ? ',' : '') + ${JSON.stringify(`${JSON.stringify(key)}:`)} + (property === null ? 'null' : ${encode});
+      }`;
+    });
+    body = `
+      if (typeof value !== 'object' || Array.isArray(value) || value instanceof Date) return asAny(value);
+      let json = '{';
+      let property;${properties.join('')}
+      return json + '}';`;
+  } else {
+    throw new Error(`Unsupported schema type: ${type}`);
+  }
+
+  functions[index] = `function ${name}(value) {${body}\n}`;
+  return name;
+}
+
+/**
+ * @param {Object} schema
+ * @returns {(value: *) => string} serializer; null and undefined become "null"
+ */
+function compile(schema) {
+  const functions = [];
+  const root = build(schema, functions);
+  const source = `${functions.join('\n')}
+    return function serialize(value) {
+      return value === undefined || value === null ? 'null' : ${root}(value);
+    };`;
+  return new Function('asAny', 'asString', 'asNumber', 'asBoolean', 'NEEDS_ESCAPE', source)(asAny, asString, asNumber, asBoolean, NEEDS_ESCAPE);
+}
+
+module.exports = { compile };
@@ -0,0 +1,135 @@
+// Project likes.
+//
+//   users/<uid>/likedProjects/<projectId>    Firestore  membership, source of truth
+//   projects/<id>/likeShards/<0..N-1>        Firestore  { count }
+//   user:<uid>:likes                         Redis set  liked project ids, plus '*'
+//                                                       once loaded from Firestore
+//   likes:dirty                              Redis set  projects whose shards moved
+//
+// A like touches only the liker's own membership doc and one random shard,
+// so a popular project's likes never queue behind each other. stats.likes on
+// the project, and the owner's totalLikes, are brought up to date from the
+// shards by a periodic aggregation of the dirty projects.
+
+const { firestore, admin } = require('../config/firebase');
+const redisClient = require('../config/redis');
+const statsService = require('./stats-service');
+
+const SHARD_COUNT = 20;
+const DIRTY_KEY = 'likes:dirty';
+const LOADED_MARKER = '*';
+const MEMBERSHIP_TTL_SECONDS = 24 * 60 * 60;
+
+const membershipKey = (uid) => `user:${uid}:likes`;
+
+class LikeService {
+  shardsRef(projectId) {
+    return firestore.collection('projects').doc(projectId).collection('likeShards');
+  }
+
+  likeRef(uid, projectId) {
+    return firestore.collection('users').doc(uid).collection('likedProjects').doc(projectId);
+  }
+
+  /** Removes a project's shards; used when the project is deleted. */
+  deleteShards(batch, projectId) {
+    for (let i = 0; i < SHARD_COUNT; i++) {
+      batch.delete(this.shardsRef(projectId).doc(String(i)));
+    }
+  }
+
+  // --- Membership ---
+
+  /** Fills the Redis set from Firestore when it has expired or never existed. */
+  async loadMembership(uid) {
+    const snapshot = await firestore.collection('users').doc(uid).collection('likedProjects').select().get();
+    await redisClient.sAdd(membershipKey(uid), [LOADED_MARKER, ...snapshot.docs.map(doc => doc.id)], MEMBERSHIP_TTL_SECONDS);
+    return new Set(snapshot.docs.map(doc => doc.id));
+  }
+
+  async isLiked(uid, projectId) {
+    const cached = await redisClient.sMIsMember(membershipKey(uid), [LOADED_MARKER, projectId]);
+    if (cached && cached[0]) return cached[1];
+
+    if (cached) return (await this.loadMembership(uid)).has(projectId);
+    // Redis unavailable: ask Firestore directly.
+    return (await this.likeRef(uid, projectId).get()).exists;
+  }
+
+  // --- Like / unlike ---
+
+  /**
+   * Sets whether `uid` likes the project. Idempotent: liking twice counts once.
+   * @returns {Promise<{ liked: boolean, changed: boolean }>}
+   */
+  async setLiked(uid, projectId, liked) {
+    const projectDoc = await firestore.collection('projects').doc(projectId).get();
+    const project = projectDoc.data();
+    if (!projectDoc.exists || (project.visibility === 'private' && project.userId !== uid)) {
+      throw Object.assign(new Error('Project not found'), { status: 404 });
+    }
+
+    const likeRef = this.likeRef(uid, projectId);
+    const changed = await firestore.runTransaction(async (transaction) => {
+      const likeDoc = await transaction.get(likeRef);
+      if (likeDoc.exists === liked) return false;
+
+      if (liked) {
+        transaction.set(likeRef, { createdAt: admin.firestore.FieldValue.serverTimestamp() });
+      } else {
+        transaction.delete(likeRef);
+      }
+      const shard = this.shardsRef(projectId).doc(String(Math.floor(Math.random() * SHARD_COUNT)));
+      transaction.set(shard, { count: admin.firestore.FieldValue.increment(liked ? 1 : -1) }, { merge: true });
+      return true;
+    });
+
+    if (changed) {
+      // Only keep the set in step once it is loaded; otherwise the next
+      // isLiked() loads it fresh.
+      const [loaded] = (await redisClient.sMIsMember(membershipKey(uid), [LOADED_MARKER])) || [false];
+      if (loaded) {
+        await (liked ? redisClient.sAdd(membershipKey(uid), projectId) : redisClient.sRem(membershipKey(uid), projectId));
+      }
+
+      const queued = await redisClient.sAdd(DIRTY_KEY, projectId);
+      if (!queued) await this.aggregateProject(projectId);
+    }
+
+    return { liked, changed };
+  }
+
+  // --- Aggregation ---
+
+  /** Writes the shard total to stats.likes and moves the difference onto the owner. */
+  async aggregateProject(projectId) {
+    const shards = await this.shardsRef(projectId).get();
+    const total = shards.docs.reduce((sum, doc) => sum + (doc.get('count') || 0), 0);
+    const projectRef = firestore.collection('projects').doc(projectId);
+
+    await firestore.runTransaction(async (transaction) => {
+      const projectDoc = await transaction.get(projectRef);
+      if (!projectDoc.exists) return; // Deleted; its likes left with it.
+
+      const delta = total - (projectDoc.get('stats.likes') || 0);
+      if (delta === 0) return;
+      transaction.update(projectRef, { 'stats.likes': total });
+      statsService.applyUserDeltas(transaction, projectDoc.get('userId'), { totalLikes: delta });
+    });
+  }
+
+  async aggregateDirty() {
+    const projectIds = await redisClient.sTakeAll(DIRTY_KEY);
+    if (projectIds.length === 0) return;
+
+    const results = await Promise.allSettled(projectIds.map(id => this.aggregateProject(id)));
+    const failed = projectIds.filter((_, i) => results[i].status === 'rejected');
+    if (failed.length > 0) {
+      console.error(`❌ Like aggregation failed for ${failed.length} projects, requeueing`);
+      await redisClient.sAdd(DIRTY_KEY, failed);
+    }
+    console.log(`❤️ Aggregated likes for ${projectIds.length - failed.length} projects`);
+  }
+}
+
+module.exports = new LikeService();
@@ -0,0 +1,190 @@
+// On-demand profiling of the running process through the inspector module,
+// for diagnosing slow paths and leaks in production without a restart.
+//
+//   cpu-<time>.cpuprofile          sampled CPU profile over N seconds
+//   heap-<time>.heapsnapshot       full heap snapshot (pauses the process)
+//   sampling-<time>.heapprofile    sampled allocations over N seconds
+//
+// Files are written to PROFILE_DIR and open in Chrome DevTools. The directory
+// is capped at PROFILE_DIR_MAX_MB: the oldest captures are deleted to make
+// room, and a capture that could not fit (or would leave the disk short) is
+// refused. Only one capture runs at a time.
+
+const fs = require('fs');
+const path = require('path');
+const inspector = require('inspector');
+
+const PROFILE_DIR = process.env.PROFILE_DIR || 'profiles/';
+const MAX_DIR_BYTES = (parseInt(process.env.PROFILE_DIR_MAX_MB, 10) || 1024) * 1024 * 1024;
+const MIN_FREE_DISK_BYTES = 2 * 1024 * 1024 * 1024;
+const MAX_DURATION_SECONDS = 120;
+const CPU_SAMPLING_INTERVAL_US = 1000;
+const HEAP_SAMPLING_INTERVAL_BYTES = 32 * 1024;
+// A snapshot is typically 1-2x the used heap
+const SNAPSHOT_SIZE_FACTOR = 2;
+
+const FILE_PATTERN = /^(cpu|heap|sampling)-[\dTZ-]+\.(cpuprofile|heapsnapshot|heapprofile)$/;
+
+const httpError = (status, message) => Object.assign(new Error(message), { status });
+const sleep = (ms) => new Promise(resolve => setTimeout(resolve, ms));
+
+class ProfilerService {
+  constructor() {
+    this.current = null;
+  }
+
+  clampSeconds(seconds, fallback) {
+    return Math.min(Math.max(parseInt(seconds, 10) || fallback, 1), MAX_DURATION_SECONDS);
+  }
+
+  /** Opens an inspector session for one capture; rejects if another is running. */
+  async withSession(kind, capture) {
+    if (this.current) {
+      throw httpError(409, `A ${this.current.kind} capture is already running (started ${this.current.startedAt})`);
+    }
+    this.current = { kind, startedAt: new Date().toISOString() };
+
+    const session = new inspector.Session();
+    session.connect();
+    const post = (method, params = {}) => new Promise((resolve, reject) => {
+      session.post(method, params, (error, result) => (error ? reject(error) : resolve(result)));
+    });
+
+    try {
+      return await capture(session, post);
+    } finally {
+      session.disconnect();
+      this.current = null;
+    }
+  }
+
+  fileName(kind, extension) {
+    return `${kind}-${new Date().toISOString().replace(/[:.]/g, '-')}.${extension}`;
+  }
+
+  async list() {
+    await fs.promises.mkdir(PROFILE_DIR, { recursive: true });
+    const names = (await fs.promises.readdir(PROFILE_DIR)).filter(name => FILE_PATTERN.test(name));
+    const files = await Promise.all(names.map(async name => {
+      const stats = await fs.promises.stat(path.join(PROFILE_DIR, name));
+      return { name, size: stats.size, createdAt: stats.mtime.toISOString() };
+    }));
+    return files.sort((a, b) => b.createdAt.localeCompare(a.createdAt));
+  }
+
+  /**
+   * Deletes the oldest captures until `bytes` more fit in the directory budget.
+   * Refuses when they can't fit at all or the disk would run short.
+   */
+  async makeRoom(bytes) {
+    if (bytes > MAX_DIR_BYTES) {
+      throw httpError(507, `Capture needs ~${Math.round(bytes / 1024 / 1024)}MB, over the ${MAX_DIR_BYTES / 1024 / 1024}MB profile limit`);
+    }
+
+    const files = await this.list();
+    let used = files.reduce((sum, file) => sum + file.size, 0);
+    while (used + bytes > MAX_DIR_BYTES && files.length > 0) {
+      const oldest = files.pop();
+      await fs.promises.unlink(path.join(PROFILE_DIR, oldest.name)).catch(() => {});
+      used -= oldest.size;
+      console.log(`🗑️ Removed old profile ${oldest.name}`);
+    }
+
+    const disk = await fs.promises.statfs(PROFILE_DIR);
+    if (disk.bavail * disk.bsize - bytes < MIN_FREE_DISK_BYTES) {
+      throw httpError(507, 'Not enough free disk space for this capture');
+    }
+  }
+
+  async writeProfile(kind, extension, profile) {
+    const body = JSON.stringify(profile);
+    await this.makeRoom(Buffer.byteLength(body));
+    const name = this.fileName(kind, extension);
+    await fs.promises.writeFile(path.join(PROFILE_DIR, name), body);
+    const stats = await fs.promises.stat(path.join(PROFILE_DIR, name));
+    console.log(`🔬 Saved ${name} (${Math.round(stats.size / 1024)}KB)`);
+    return { name, size: stats.size, createdAt: stats.mtime.toISOString() };
+  }
+
+  async captureCpuProfile(seconds) {
+    const duration = this.clampSeconds(seconds, 10);
+    return this.withSession('cpu', async (session, post) => {
+      console.log(`🔬 CPU profile started for ${duration}s`);
+      await post('Profiler.enable');
+      await post('Profiler.setSamplingInterval', { interval: CPU_SAMPLING_INTERVAL_US });
+      await post('Profiler.start');
+      await sleep(duration * 1000);
+      const { profile } = await post('Profiler.stop');
+      await post('Profiler.disable');
+      return this.writeProfile('cpu', 'cpuprofile', profile);
+    });
+  }
+
+  async captureHeapSampling(seconds) {
+    const duration = this.clampSeconds(seconds, 30);
+    return this.withSession('sampling', async (session, post) => {
+      console.log(`🔬 Heap sampling started for ${duration}s`);
+      await post('HeapProfiler.enable');
+      await post('HeapProfiler.startSampling', { samplingInterval: HEAP_SAMPLING_INTERVAL_BYTES });
+      await sleep(duration * 1000);
+      const { profile } = await post('HeapProfiler.stopSampling');
+      await post('HeapProfiler.disable');
+      return this.writeProfile('sampling', 'heapprofile', profile);
+    });
+  }
+
+  /** Streams a full heap snapshot to disk. The process is paused while V8 walks the heap. */
+  async captureHeapSnapshot() {
+    return this.withSession('heap', async (session, post) => {
+      await this.makeRoom(process.memoryUsage().heapUsed * SNAPSHOT_SIZE_FACTOR);
+
+      const name = this.fileName('heap', 'heapsnapshot');
+      const filePath = path.join(PROFILE_DIR, name);
+      const out = fs.createWriteStream(filePath);
+      const onChunk = ({ params }) => out.write(params.chunk);
+      session.on('HeapProfiler.addHeapSnapshotChunk', onChunk);
+
+      const startedAt = Date.now();
+      try {
+        await post('HeapProfiler.takeHeapSnapshot', { reportProgress: false });
+      } catch (error) {
+        out.destroy();
+        await fs.promises.unlink(filePath).catch(() => {});
+        throw error;
+      } finally {
+        session.removeListener('HeapProfiler.addHeapSnapshotChunk', onChunk);
+      }
+      await new Promise((resolve, reject) => {
+        out.once('error', reject);
+        out.end(resolve);
+      });
+
+      const stats = await fs.promises.stat(filePath);
+      console.log(`🔬 Saved ${name} (${Math.round(stats.size / 1024 / 1024)}MB, paused ${Date.now() - startedAt}ms)`);
+      return { name, size: stats.size, createdAt: stats.mtime.toISOString() };
+    });
+  }
+
+  /** Absolute path of a stored capture, or null for names outside the directory. */
+  resolve(name) {
+    if (!FILE_PATTERN.test(name)) return null;
+    return path.resolve(PROFILE_DIR, name);
+  }
+
+  async remove(name) {
+    const filePath = this.resolve(name);
+    if (!filePath) throw httpError(404, 'Profile not found');
+    try {
+      await fs.promises.unlink(filePath);
+    } catch (error) {
+      if (error.code === 'ENOENT') throw httpError(404, 'Profile not found');
+      throw error;
+    }
+  }
+
+  getStatus() {
+    return { running: this.current };
+  }
+}
+
+module.exports = new ProfilerService();
@@ -2,6 +2,10 @@ const { firestore, storage, admin } = require('../config/firebase');
 const fileService = require('./file-service');
 const conversionService = require('./conversion-service');
 const redisClient = require('../config/redis'); // ✅ NEW: Added for cache invalidation
+const revalidationService = require('./revalidation-service');
+const statsService = require('./stats-service');
+const likeService = require('./like-service');
+const revisionService = require('./revision-service');
 const path = require('path');
 
 // --- NEW: Helper function to generate secure, temporary URLs ---
@@ -31,6 +35,35 @@ async function generateSignedUrl(filePath) {
 }
 
 
+// --- Helpers for partial updates (patchProject) ---
+const httpError = (status, message) => Object.assign(new Error(message), { status });
+
+const parseJsonField = (value, defaultValue) => {
+  if (value === undefined || value === '') return defaultValue;
+  if (typeof value !== 'string') return value;
+  try {
+    return JSON.parse(value);
+  } catch {
+    throw httpError(400, 'Malformed JSON in request body');
+  }
+};
+
+// Fields a PATCH may change, each with its validator.
+const PATCHABLE_FIELDS = {
+  title: (v) => typeof v === 'string' && v.trim().length > 0 && v.length <= 200,
+  description: (v) => typeof v === 'string' && v.length <= 10000,
+  tags: (v) => Array.isArray(v) && v.length <= 30 && v.every(tag => typeof tag === 'string' && tag.length <= 50),
+  visibility: (v) => v === 'public' || v === 'private',
+  allowDownloads: (v) => typeof v === 'boolean'
+};
+
+// Upload fields a file operation may use, and the project slot each fills.
+const UPLOAD_SLOTS = {
+  bannerImage: 'thumbnail',
+  modelFile: 'model',
+  projectFiles: 'attachment'
+};
+
 // Helper function to invalidate all user-related caches
 async function invalidateUserCaches(userId, projectId = null) {
   try {
@@ -40,7 +73,7 @@ async function invalidateUserCaches(userId, projectId = null) {
     
     const cacheKeys = [
       `user:${userId}:projects`,  // User projects cache (projects.js)
-      ...(username ? [`user:${username}:profile`] : []), // User profile cache (users.js)
+      ...(username ? [`user:${username.toLowerCase()}:profile`] : []), // User profile cache (users.js)
       ...(projectId ? [`project:${projectId}`] : []) // Individual project cache
     ];
     
@@ -54,6 +87,9 @@ async function invalidateUserCaches(userId, projectId = null) {
     );
     
     await Promise.all(deletePromises);
+
+    // ✅ NEW: Regenerate the statically rendered project and profile pages
+    await revalidationService.revalidateProject(projectId, username);
     
   } catch (error) {
     console.warn('Cache invalidation failed:', error.message);
@@ -79,28 +115,67 @@ class ProjectService {
     }
     
     const bannerFile = files.bannerImage ? files.bannerImage[0] : null;
+    const clientGlbFile = files.modelGlb ? files.modelGlb[0] : null;
+
+    // ✅ NEW: A Draco GLB converted in the browser replaces the server conversion,
+    // but only once it validates. Otherwise fall back to converting the STL here.
+    let clientGlb = null;
+    if (clientGlbFile) {
+      try {
+        clientGlb = await conversionService.validateGlb(clientGlbFile.path);
+        console.log(`✅ Client GLB accepted for ${projectId}: ${clientGlb.triangleCount} triangles`);
+      } catch (error) {
+        console.warn(`⚠️ Client GLB rejected for ${projectId}: ${error.message}`);
+        if (!stlFile) {
+          throw new Error(`The converted model could not be validated: ${error.message}`);
+        }
+      }
+    }
 
-    if (!stlFile) {
+    if (!stlFile && !clientGlb) {
       throw new Error('A 3D model file (.stl) is required to create a project.');
     }
 
+    const glbFileName = clientGlb ? fileService.sanitizeFileName(clientGlbFile.originalname) : null;
+
     // 💡 IMPROVEMENT: Fetch all user details concurrently.
-    const [username, authorName, authorAvatar, modelUploadResult, bannerUploadResult, attachmentsResult] = await Promise.all([
+    const [username, authorName, authorAvatar, modelUploadResult, glbUploadResult, bannerUploadResult, attachmentsResult] = await Promise.all([
       this.getUsernameFromUserId(userId),
       this.getDisplayNameFromUserId(userId),
       this.getAvatarFromUserId(userId), // Fetches the user's avatar URL
-      // UPDATED THIS LINE
-      fileService.uploadToFirebase(stlFile, `projects/${userId}/${projectId}/models/${stlFile.originalname}`),
-      
+      // The STL is only sent alongside a client GLB when downloads are allowed.
+      stlFile ? fileService.uploadToFirebase(stlFile, `projects/${userId}/${projectId}/models/${stlFile.originalname}`) : Promise.resolve(null),
+      clientGlb
+        ? fileService.uploadToFirebase(
+            { path: clientGlbFile.path, originalname: glbFileName, mimetype: 'model/gltf-binary' },
+            `projects/${userId}/${projectId}/models/${glbFileName}`
+          )
+        : Promise.resolve(null),
       bannerFile ? fileService.uploadBannerImage(bannerFile, userId, projectId) : Promise.resolve(null),
       fileService.uploadProjectFiles(otherFiles, userId, projectId)
     ]);
 
     const filesForFirestore = this.organizeProjectFiles(
-      { models: [modelUploadResult], attachments: attachmentsResult.attachments },
+      { models: [modelUploadResult].filter(Boolean), attachments: attachmentsResult.attachments },
       bannerUploadResult
     );
 
+    if (glbUploadResult) {
+      filesForFirestore.model.glb = {
+        filename: glbFileName,
+        size: glbUploadResult.size,
+        convertedFrom: projectData.modelSourceName || stlFile?.originalname || null,
+        conversionStats: {
+          originalSize: Number(projectData.modelSourceSize) || stlFile?.size || 0,
+          convertedSize: glbUploadResult.size,
+          triangleCount: clientGlb.triangleCount,
+          convertedInBrowser: true
+        },
+        createdAt: admin.firestore.FieldValue.serverTimestamp(),
+        storagePath: glbUploadResult.storagePath
+      };
+    }
+
     const parsedTags = JSON.parse(projectData.tags || '[]');
     
     // ✅ KEY CHANGE: Added `authorAvatar` to the new project schema.
@@ -120,22 +195,41 @@ class ProjectService {
       stats: { views: 0, downloads: 0, likes: 0 },
       createdAt: admin.firestore.FieldValue.serverTimestamp(),
       updatedAt: admin.firestore.FieldValue.serverTimestamp(),
-      conversionStatus: {
-        stlFiles: 1,
-        convertedFiles: 0,
-        inProgress: true,
-        completed: false,
-        errors: [],
-        startedAt: admin.firestore.FieldValue.serverTimestamp()
-      }
+      conversionStatus: clientGlb
+        ? {
+            stlFiles: stlFile ? 1 : 0,
+            convertedFiles: 1,
+            inProgress: false,
+            completed: true,
+            errors: [],
+            startedAt: admin.firestore.FieldValue.serverTimestamp(),
+            completedAt: admin.firestore.FieldValue.serverTimestamp()
+          }
+        : {
+            stlFiles: 1,
+            convertedFiles: 0,
+            inProgress: true,
+            completed: false,
+            errors: [],
+            startedAt: admin.firestore.FieldValue.serverTimestamp()
+          }
     };
 
-    await projectRef.set(newProject);
+    // 🚀 OPTIMIZATION: Owner's project count moves in the same batch
+    const batch = firestore.batch();
+    batch.set(projectRef, newProject);
+    statsService.applyUserDeltas(batch, userId, { totalProjects: 1 });
+    await batch.commit();
     console.log(`Project document ${projectId} created successfully.`);
     await invalidateUserCaches(userId, projectId);
 
 
-    if (stlFile.path) {
+    if (clientGlb) {
+      // Nothing left to convert; the STL temp file is not needed any more.
+      if (stlFile?.path) {
+        await this.enhancedCleanup([stlFile.path], `STL temp file (client GLB used): ${stlFile.originalname}`);
+      }
+    } else if (stlFile.path) {
       setTimeout(() => {
         this.startBackgroundConversion(projectId, userId, [stlFile])
           .catch(err => console.error(`Background conversion failed to start for ${projectId}:`, err));
@@ -179,53 +273,72 @@ class ProjectService {
     const newBannerFile = files.bannerImage ? files.bannerImage[0] : null;
     const newAttachments = files.projectFiles || [];
 
-    if (newModelFile) {
-      if (existingProject.files?.model?.stl?.storagePath) pathsToDelete.add(existingProject.files.model.stl.storagePath);
-      if (existingProject.files?.model?.glb?.storagePath) pathsToDelete.add(existingProject.files.model.glb.storagePath);
-      // UPDATED THIS LINE
-      const modelUploadResult = await fileService.uploadToFirebase(newModelFile, `projects/${userId}/${projectId}/models/${newModelFile.originalname}`);
+    // ✅ NEW: Keep the current state in history before anything is overwritten
+    // FIX: ...once the request has been parsed; dropped again if the update fails.
+    const revisionId = await revisionService.snapshot(projectId, userId, existingProject, 'update');
+    // Uploads go to fresh paths, so replaced files stay live until retired below.
+    const takenPaths = new Set(revisionService.listFiles(existingProject.files).map(([, file]) => file.storagePath));
+    const uploaded = [];
 
-      finalUpdate['files.model.stl'] = {
-        filename: modelUploadResult.originalName,
-        size: modelUploadResult.size,
-        storagePath: modelUploadResult.storagePath,
-        uploadedAt: admin.firestore.FieldValue.serverTimestamp()
-      };
+    try {
+      if (newModelFile) {
+        if (existingProject.files?.model?.stl?.storagePath) pathsToDelete.add(existingProject.files.model.stl.storagePath);
+        if (existingProject.files?.model?.glb?.storagePath) pathsToDelete.add(existingProject.files.model.glb.storagePath);
+        // UPDATED THIS LINE
+        const modelUploadResult = await fileService.uploadToFirebase(newModelFile, fileService.uniqueStoragePath(`projects/${userId}/${projectId}/models/${newModelFile.originalname}`, takenPaths));
+        uploaded.push(modelUploadResult.storagePath);
+
+        finalUpdate['files.model.stl'] = {
+          filename: modelUploadResult.originalName,
+          size: modelUploadResult.size,
+          storagePath: modelUploadResult.storagePath,
+          contentHash: modelUploadResult.contentHash,
+          uploadedAt: admin.firestore.FieldValue.serverTimestamp()
+        };
       
-      finalUpdate['files.model.glb'] = admin.firestore.FieldValue.delete();
-      finalUpdate.conversionStatus = {
-        stlFiles: 1,
-        convertedFiles: 0,
-        inProgress: true,
-        completed: false,
-        errors: [],
-        startedAt: admin.firestore.FieldValue.serverTimestamp()
-      };
-    }
+        finalUpdate['files.model.glb'] = admin.firestore.FieldValue.delete();
+        finalUpdate.conversionStatus = {
+          stlFiles: 1,
+          convertedFiles: 0,
+          inProgress: true,
+          completed: false,
+          errors: [],
+          startedAt: admin.firestore.FieldValue.serverTimestamp()
+        };
+      }
 
-    if (newBannerFile) {
-      if (existingProject.files?.thumbnail?.storagePath) pathsToDelete.add(existingProject.files.thumbnail.storagePath);
-      const bannerUploadResult = await fileService.uploadBannerImage(newBannerFile, userId, projectId);
-      finalUpdate['files.thumbnail'] = {
-        filename: bannerUploadResult.originalName,
-        size: bannerUploadResult.size,
-        storagePath: bannerUploadResult.storagePath
-      };
-    }
+      if (newBannerFile) {
+        if (existingProject.files?.thumbnail?.storagePath) pathsToDelete.add(existingProject.files.thumbnail.storagePath);
+        const bannerUploadResult = await fileService.uploadBannerImage(newBannerFile, userId, projectId);
+        uploaded.push(bannerUploadResult.storagePath);
+        finalUpdate['files.thumbnail'] = {
+          filename: bannerUploadResult.originalName,
+          size: bannerUploadResult.size,
+          storagePath: bannerUploadResult.storagePath,
+          contentHash: bannerUploadResult.contentHash,
+          sourceHash: bannerUploadResult.sourceHash
+        };
+      }
 
-    let updatedAttachments = (existingProject.files?.attachments || []).filter(file => !filesToDeleteFromFrontend.includes(file.storagePath));
-    if (newAttachments.length > 0) {
-      const attachmentsUploadResult = await fileService.uploadProjectFiles(newAttachments, userId, projectId);
-      updatedAttachments.push(...attachmentsUploadResult.attachments);
-    }
-    finalUpdate['files.attachments'] = updatedAttachments;
-    
-    if (pathsToDelete.size > 0) {
-      const deletePromises = Array.from(pathsToDelete).map(p => fileService.deleteFromFirebase(p).catch(err => console.warn(err.message)));
-      await Promise.all(deletePromises);
+      let updatedAttachments = (existingProject.files?.attachments || []).filter(file => !filesToDeleteFromFrontend.includes(file.storagePath));
+      if (newAttachments.length > 0) {
+        const attachmentsUploadResult = await fileService.uploadProjectFiles(newAttachments, userId, projectId, takenPaths);
+        uploaded.push(...attachmentsUploadResult.attachments.map(file => file.storagePath));
+        updatedAttachments.push(...attachmentsUploadResult.attachments);
+      }
+      finalUpdate['files.attachments'] = updatedAttachments;
+
+      await projectRef.update(finalUpdate);
+    } catch (error) {
+      // FIX: Nothing points at these uploads or the revision yet.
+      await Promise.all(uploaded.map(p => fileService.deleteFromFirebase(p).catch(err => console.warn(err.message))));
+      await revisionService.discard(projectId, revisionId)
+        .catch(err => console.warn(`Failed to discard revision ${revisionId}:`, err.message));
+      throw error;
     }
 
-    await projectRef.update(finalUpdate);
+    // FIX: Replaced files are archived in the background, then deleted
+    await revisionService.retire(projectId, userId, revisionId, [...pathsToDelete]);
 
     // ✅ NEW: Invalidate Redis cache when project is updated
     // Invalidate all user-related caches  
@@ -243,6 +356,308 @@ class ProjectService {
     return { id: updatedDoc.id, ...updatedDoc.data() };
   }
   
+  /**
+   * ✅ NEW: Partial update. Only changed fields and explicit file operations are
+   * sent; untouched document fields and files are never rewritten.
+   * @param {string} projectId
+   * @param {string} userId
+   * @param {Object} body - Multipart fields: `fields` (JSON object of changed
+   *   values) and `fileOps` (JSON array, see applyFileOp)
+   * @param {Object} files - Multer files keyed by field name
+   * @returns {Promise<Object>} - The updated project plus a list of skipped ops
+   */
+  async patchProject(projectId, userId, body, files = {}) {
+    const projectRef = firestore.collection('projects').doc(projectId);
+    const projectDoc = await projectRef.get();
+
+    if (!projectDoc.exists || projectDoc.data().userId !== userId) {
+      throw httpError(404, 'Project not found or you do not have permission to edit it.');
+    }
+    const existingProject = projectDoc.data();
+
+    const fields = parseJsonField(body.fields, {});
+    const fileOps = parseJsonField(body.fileOps, []);
+    if (typeof fields !== 'object' || Array.isArray(fields) || !Array.isArray(fileOps)) {
+      throw httpError(400, 'fields must be an object and fileOps an array');
+    }
+
+    const update = this.diffProjectFields(existingProject, fields);
+
+    // Uploads are matched to operations by "<field>/<original name>".
+    const uploads = new Map();
+    Object.entries(files).forEach(([field, list]) => {
+      list.forEach(file => uploads.set(`${field}/${file.originalname}`, file));
+    });
+
+    // FIX: Every operation is checked before anything is uploaded or archived,
+    // so a bad one late in the list rejects the patch without side effects.
+    const claimed = new Set();
+    const plans = fileOps.map(op => this.planFileOp(existingProject.files || {}, op, uploads, claimed));
+
+    // ✅ NEW: Record the current state before anything changes; dropped again
+    // below if the patch turns out to change nothing.
+    const revisionId = (Object.keys(update).length > 0 || plans.length > 0)
+      ? await revisionService.snapshot(projectId, userId, existingProject, 'patch')
+      : null;
+
+    const state = {
+      update,
+      attachments: null, // copied on first attachment change
+      pathsToDelete: new Set(),
+      // Uploads go to fresh paths, so a failed patch can delete all of them
+      // without touching anything the project still points at.
+      takenPaths: new Set(revisionService.listFiles(existingProject.files).map(([, file]) => file.storagePath)),
+      uploaded: [],
+      modelForConversion: null,
+      skipped: []
+    };
+    try {
+      for (const plan of plans) {
+        await this.applyFileOp(projectId, userId, existingProject, plan, state);
+      }
+      if (state.attachments) update['files.attachments'] = state.attachments;
+
+      if (Object.keys(update).length > 0) {
+        update.updatedAt = admin.firestore.FieldValue.serverTimestamp();
+        await projectRef.update(update);
+      }
+    } catch (error) {
+      // FIX: Nothing points at this patch's uploads or revision yet.
+      await Promise.all(state.uploaded.map(p => fileService.deleteFromFirebase(p).catch(err => console.warn(err.message))));
+      if (revisionId) {
+        await revisionService.discard(projectId, revisionId)
+          .catch(err => console.warn(`Failed to discard revision ${revisionId}:`, err.message));
+      }
+      throw error;
+    }
+
+    if (Object.keys(update).length > 0) {
+      console.log(`✏️ Patched project ${projectId}: ${Object.keys(update).join(', ')}`);
+
+      // Old files go only after the document stops pointing at them, and
+      // after they are archived (in the background).
+      await revisionService.retire(projectId, userId, revisionId, [...state.pathsToDelete]);
+      await invalidateUserCaches(userId, projectId);
+    } else {
+      console.log(`⏭️ Patch for project ${projectId} changed nothing`);
+      if (revisionId) await revisionService.discard(projectId, revisionId);
+    }
+
+    if (state.modelForConversion) {
+      const stlFile = state.modelForConversion;
+      setTimeout(() => {
+        this.startBackgroundConversionForUpdate(projectId, userId, stlFile)
+          .catch(err => console.error(`Background re-conversion failed for project ${projectId}:`, err));
+      }, 100);
+    }
+
+    const updatedDoc = await projectRef.get();
+    return { id: updatedDoc.id, ...updatedDoc.data(), skipped: state.skipped };
+  }
+
+  /**
+   * Validates the changed scalar fields and returns only those that differ.
+   * searchTerms and category are derived, so they follow their inputs.
+   */
+  diffProjectFields(existingProject, fields) {
+    const update = {};
+
+    for (const [key, value] of Object.entries(fields)) {
+      const validate = PATCHABLE_FIELDS[key];
+      if (!validate) throw httpError(400, `Field "${key}" cannot be updated`);
+      if (!validate(value)) throw httpError(400, `Invalid value for "${key}"`);
+
+      const unchanged = key === 'tags'
+        ? JSON.stringify(value) === JSON.stringify(existingProject.tags || [])
+        : value === existingProject[key];
+      if (!unchanged) update[key] = value;
+    }
+
+    if ('title' in update || 'description' in update || 'tags' in update) {
+      const merged = { ...existingProject, ...update };
+      update.searchTerms = this.generateSearchTerms(merged.title, merged.description, merged.tags || []);
+    }
+    if ('tags' in update) {
+      update.category = this.determineCategory(update.tags);
+    }
+
+    return update;
+  }
+
+  /**
+   * Checks one file operation from a patch, without side effects:
+   *   { op: 'remove',  target }                  target = storagePath of a project file
+   *   { op: 'add',     file, name }              file = upload field (bannerImage | modelFile | projectFiles)
+   *   { op: 'replace', target, file, name }
+   * A file, an upload and the banner or model slot may each be used by one
+   * operation only (`claimed` collects them across the patch).
+   * @returns {{ op: Object, target: Object|null, upload: Object|null }}
+   */
+  planFileOp(existingFiles, op, uploads, claimed) {
+    if (!op || typeof op !== 'object') throw httpError(400, 'Each file operation must be an object');
+    if (!['remove', 'add', 'replace'].includes(op.op)) throw httpError(400, `Unknown file operation "${op.op}"`);
+
+    const claim = (key) => {
+      if (claimed.has(key)) throw httpError(400, `${key} is used by more than one file operation`);
+      claimed.add(key);
+    };
+
+    const target = op.target ? this.findProjectFile(existingFiles, op.target) : null;
+    if (op.target && !target) throw httpError(400, `File ${op.target} does not belong to this project`);
+    if (op.op !== 'add' && !target) throw httpError(400, `${op.op} requires a target`);
+    if (target) claim(target.file.storagePath);
+
+    if (op.op === 'remove') {
+      if (target.slot === 'model') throw httpError(400, 'The 3D model can be replaced but not removed');
+      return { op, target, upload: null };
+    }
+
+    const slot = UPLOAD_SLOTS[op.file];
+    if (!slot) throw httpError(400, `Unknown upload field "${op.file}"`);
+    if (target && target.slot !== slot) throw httpError(400, `${op.file} cannot replace ${op.target}`);
+
+    const upload = uploads.get(`${op.file}/${op.name}`);
+    if (!upload) throw httpError(400, `No uploaded file for ${op.file}/${op.name}`);
+    claim(`${op.file}/${op.name}`);
+    // Banner and model are single slots.
+    if (slot !== 'attachment') claim(op.file);
+
+    if (op.file === 'modelFile' && !upload.originalname.toLowerCase().endsWith('.stl')) {
+      throw httpError(400, 'The 3D model must be an STL file');
+    }
+    return { op, target, upload };
+  }
+
+  /**
+   * Carries out an operation checked by planFileOp. A replacement whose
+   * content hash matches the current file is skipped.
+   */
+  async applyFileOp(projectId, userId, existingProject, { op, target, upload }, state) {
+    const existingFiles = existingProject.files || {};
+    const attachments = () => (state.attachments ||= [...(existingFiles.attachments || [])]);
+    const removeAttachment = (storagePath) => {
+      state.attachments = attachments().filter(file => file.storagePath !== storagePath);
+    };
+
+    if (op.op === 'remove') {
+      if (target.slot === 'thumbnail') state.update['files.thumbnail'] = admin.firestore.FieldValue.delete();
+      else removeAttachment(target.file.storagePath);
+      state.pathsToDelete.add(target.file.storagePath);
+      return;
+    }
+
+    // Banner and model are single slots, so adding one replaces the current file.
+    const current = target?.file
+      || (op.file === 'bannerImage' && existingFiles.thumbnail)
+      || (op.file === 'modelFile' && existingFiles.model?.stl)
+      || null;
+
+    const contentHash = await fileService.hashFile(upload.path);
+    // The banner is stored re-encoded, so compare with what the client sent
+    // (thumbnails from before sourceHash carried it as contentHash).
+    const currentHash = op.file === 'bannerImage' ? (current?.sourceHash || current?.contentHash) : current?.contentHash;
+    if (currentHash && currentHash === contentHash) {
+      console.log(`⏭️ ${op.name} is identical to ${current.filename}, skipping upload`);
+      state.skipped.push(op.name);
+      if (op.file === 'modelFile') {
+        // STL temp files are kept for conversion by the upload middleware.
+        await this.enhancedCleanup([upload.path], `unchanged STL: ${op.name}`);
+      }
+      return;
+    }
+
+    if (op.file === 'bannerImage') {
+      // Banner paths are timestamped, so never taken.
+      const result = await fileService.uploadBannerImage(upload, userId, projectId);
+      state.uploaded.push(result.storagePath);
+      state.update['files.thumbnail'] = {
+        filename: result.originalName,
+        size: result.size,
+        storagePath: result.storagePath,
+        contentHash: result.contentHash,
+        sourceHash: result.sourceHash
+      };
+    } else if (op.file === 'modelFile') {
+      const storagePath = fileService.uniqueStoragePath(`projects/${userId}/${projectId}/models/${upload.originalname}`, state.takenPaths);
+      const result = await fileService.uploadToFirebase(upload, storagePath);
+      state.uploaded.push(result.storagePath);
+      state.update['files.model.stl'] = {
+        filename: result.originalName,
+        size: result.size,
+        storagePath: result.storagePath,
+        contentHash: result.contentHash,
+        uploadedAt: admin.firestore.FieldValue.serverTimestamp()
+      };
+      state.update['files.model.glb'] = admin.firestore.FieldValue.delete();
+      state.update.conversionStatus = {
+        stlFiles: 1,
+        convertedFiles: 0,
+        inProgress: true,
+        completed: false,
+        errors: [],
+        startedAt: admin.firestore.FieldValue.serverTimestamp()
+      };
+      if (existingFiles.model?.glb?.storagePath) state.pathsToDelete.add(existingFiles.model.glb.storagePath);
+      state.modelForConversion = upload;
+    } else {
+      const result = await fileService.uploadProjectFiles([upload], userId, projectId, state.takenPaths);
+      if (result.attachments.length === 0) throw httpError(400, `Upload of ${op.name} failed`);
+      state.uploaded.push(...result.attachments.map(file => file.storagePath));
+      if (target) removeAttachment(target.file.storagePath);
+      attachments().push(...result.attachments.map(file => ({ ...file, contentHash })));
+    }
+    state.uploaded.forEach(storagePath => state.takenPaths.add(storagePath));
+
+    if (current?.storagePath) state.pathsToDelete.add(current.storagePath);
+  }
+
+  /** Locates a file of the project by storage path. */
+  findProjectFile(files, storagePath) {
+    if (files.thumbnail?.storagePath === storagePath) return { slot: 'thumbnail', file: files.thumbnail };
+    if (files.model?.stl?.storagePath === storagePath) return { slot: 'model', file: files.model.stl };
+    const attachment = (files.attachments || []).find(file => file.storagePath === storagePath);
+    return attachment ? { slot: 'attachment', file: attachment } : null;
+  }
+  
+  // ✅ NEW: Revision history (see revision-service)
+  async listRevisions(projectId, userId) {
+    const projectDoc = await firestore.collection('projects').doc(projectId).get();
+    if (!projectDoc.exists || projectDoc.data().userId !== userId) {
+      throw httpError(404, 'Project not found or you do not have permission to edit it.');
+    }
+    return revisionService.listRevisions(projectId);
+  }
+
+  async restoreRevision(projectId, userId, revisionId) {
+    const { reconvert } = await revisionService.restore(projectId, userId, revisionId);
+    await invalidateUserCaches(userId, projectId);
+
+    // GLBs are not kept in history; convert the restored STL again.
+    if (reconvert) {
+      const stlFile = {
+        path: path.join('uploads', `restored-${projectId}-${Date.now()}-${path.basename(reconvert.storagePath)}`),
+        originalname: reconvert.filename,
+        size: reconvert.size
+      };
+      storage.bucket().file(reconvert.storagePath).download({ destination: stlFile.path })
+        .then(
+          () => this.startBackgroundConversionForUpdate(projectId, userId, stlFile),
+          async (error) => {
+            await this.updateConversionStatus(projectId, {
+              errors: [{ fileName: stlFile.originalname, error: error.message, timestamp: new Date() }],
+              inProgress: false,
+              completed: true,
+              completedAt: new Date()
+            });
+            throw error;
+          }
+        )
+        .catch(err => console.error(`Background re-conversion failed for project ${projectId}:`, err));
+    }
+    const updatedDoc = await firestore.collection('projects').doc(projectId).get();
+    return { id: updatedDoc.id, ...updatedDoc.data() };
+  }
+
   async getProject(projectId) {
     const projectRef = firestore.collection('projects').doc(projectId);
     const doc = await projectRef.get();
@@ -289,7 +704,9 @@ class ProjectService {
         thumbnail: { 
           filename: bannerResult.originalName, 
           size: bannerResult.size, 
-          storagePath: bannerResult.storagePath 
+          storagePath: bannerResult.storagePath,
+          contentHash: bannerResult.contentHash,
+          sourceHash: bannerResult.sourceHash
         } 
       }),
       attachments: []
@@ -302,7 +719,8 @@ class ProjectService {
           filename: stlModel.originalName, 
           size: stlModel.size, 
           uploadedAt: stlModel.uploadedAt, 
-          storagePath: stlModel.storagePath 
+          storagePath: stlModel.storagePath,
+          contentHash: stlModel.contentHash
         };
       }
     }
@@ -313,7 +731,8 @@ class ProjectService {
         filename: file.originalName, 
         size: file.size, 
         description: file.description, 
-        storagePath: file.storagePath 
+        storagePath: file.storagePath,
+        contentHash: file.contentHash
       }));
     }
     return files;
@@ -330,7 +749,8 @@ class ProjectService {
             convertedFrom: originalStlName,
             conversionStats: glbResult.conversionStats,
             createdAt: admin.firestore.FieldValue.serverTimestamp(),
-            storagePath: glbResult.storagePath
+            storagePath: glbResult.storagePath,
+            contentHash: glbResult.contentHash
           },
           'conversionStatus.convertedFiles': admin.firestore.FieldValue.increment(1),
           'conversionStatus.lastUpdate': admin.firestore.FieldValue.serverTimestamp()
@@ -358,7 +778,19 @@ class ProjectService {
       console.error(`Failed to delete files for project ${projectId}. Manual cleanup may be required.`, error);
     }
     
-    await projectRef.delete();
+    // 🚀 OPTIMIZATION: Take the project's share out of the owner's aggregates
+    const batch = firestore.batch();
+    batch.delete(projectRef);
+    likeService.deleteShards(batch, projectId);
+    statsService.applyUserDeltas(batch, userId, {
+      totalProjects: -1,
+      totalViews: -(projectData.stats?.views || 0),
+      totalLikes: -(projectData.stats?.likes || 0)
+    });
+    await batch.commit();
+    await revisionService.deleteHistory(projectId).catch(error => {
+      console.error(`Failed to delete revision history for ${projectId}:`, error.message);
+    });
 
     // ✅ NEW: Invalidate cache when project is deleted
     // Invalidate all user-related caches
@@ -428,10 +860,6 @@ class ProjectService {
         }
       }
 
-      // ✅ Cache invalidation after all conversions complete
-      // After conversion completes, invalidate caches
-      await invalidateUserCaches(userId, projectId);
-
     } finally {
       // ✅ SAFETY: Final cleanup for any remaining temp files
       await this.enhancedCleanup(tempFilesToCleanup, "final safety cleanup after background conversion");
@@ -441,6 +869,10 @@ class ProjectService {
         completedAt: new Date(), 
         progress: 100 
       });
+
+      // ✅ Cache invalidation after all conversions complete
+      // FIX: Runs after the status update so regenerated pages no longer show "converting"
+      await invalidateUserCaches(userId, projectId);
     }
   }
 
@@ -461,7 +893,8 @@ class ProjectService {
             convertedFrom: stlFile.originalname,
             conversionStats: glbResult.conversionStats,
             createdAt: admin.firestore.FieldValue.serverTimestamp(),
-            storagePath: glbResult.storagePath
+            storagePath: glbResult.storagePath,
+            contentHash: glbResult.contentHash
           },
           'conversionStatus.convertedFiles': 1,
           'conversionStatus.inProgress': false,
@@ -487,6 +920,7 @@ class ProjectService {
         completed: true, 
         completedAt: new Date() 
       });
+      await invalidateUserCaches(userId, projectId);
       
       // ✅ Clean up STL temp file even on conversion error
       if (stlFile.path) {
@@ -522,7 +956,9 @@ class ProjectService {
         conversionStats: { 
           originalSize: stlFile.size || 0,
           convertedSize: uploadResult.size || 0,
-          conversionTime: Date.now()
+          conversionTime: Date.now(),
+          peakRss: conversionResult.peakRss,
+          rssGrowth: conversionResult.rssGrowth
         } 
       };
     } catch (error) {
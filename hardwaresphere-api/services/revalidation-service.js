@@ -0,0 +1,63 @@
+// Tells the Next.js frontend to regenerate its pre-rendered pages (ISR) after
+// data changes. Tags match lib/server-api.ts in the frontend:
+//   project:<id>      -> /project/<id>
+//   user:<username>   -> /user/<username>
+
+const REVALIDATE_TIMEOUT_MS = 5000;
+
+class RevalidationService {
+  constructor() {
+    this.frontendUrl = (process.env.FRONTEND_URL || '').replace(/\/$/, '');
+    this.secret = process.env.REVALIDATE_SECRET;
+    this.enabled = !!(this.frontendUrl && this.secret);
+
+    if (!this.enabled) {
+      console.log('ℹ️ Page revalidation disabled (FRONTEND_URL / REVALIDATE_SECRET not set)');
+    }
+  }
+
+  /**
+   * Best effort: a failed webhook only means the page stays stale until its
+   * revalidate window expires, so errors are logged and never thrown.
+   */
+  async revalidateTags(tags) {
+    const uniqueTags = [...new Set(tags.filter(Boolean))];
+    if (!this.enabled || uniqueTags.length === 0) return false;
+
+    try {
+      const response = await fetch(`${this.frontendUrl}/api/revalidate`, {
+        method: 'POST',
+        headers: {
+          'Content-Type': 'application/json',
+          'x-revalidate-secret': this.secret
+        },
+        body: JSON.stringify({ tags: uniqueTags }),
+        signal: AbortSignal.timeout(REVALIDATE_TIMEOUT_MS)
+      });
+
+      if (!response.ok) {
+        console.warn(`⚠️ Page revalidation failed (${response.status}) for: ${uniqueTags.join(', ')}`);
+        return false;
+      }
+
+      console.log(`♻️ Pages revalidated: ${uniqueTags.join(', ')}`);
+      return true;
+    } catch (error) {
+      console.warn(`⚠️ Page revalidation error for ${uniqueTags.join(', ')}:`, error.message);
+      return false;
+    }
+  }
+
+  revalidateProject(projectId, username = null) {
+    return this.revalidateTags([
+      projectId && `project:${projectId}`,
+      username && `user:${username}`
+    ]);
+  }
+
+  revalidateUser(...usernames) {
+    return this.revalidateTags(usernames.map(username => username && `user:${username}`));
+  }
+}
+
+module.exports = new RevalidationService();
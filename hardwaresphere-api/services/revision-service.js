@@ -0,0 +1,462 @@
+// Project revision history.
+//
+//   projects/<id>/revisions/<revisionId>   Firestore  fields + file entries
+//                                          as they were before a change
+//   projects/<id>/manifests/<contentHash>  Firestore  { chunks, size, contentType }
+//   projects/<uid>/<id>/chunks/<sha256>    Storage    content-defined chunks
+//
+// An edit records the project's fields and file entries as a revision (one
+// document write) before it changes anything. Edits upload to fresh paths,
+// so every file the revision lists stays live until the edit is committed;
+// the files it replaced or removed are then handed to retire(), which
+// archives them into the chunk store in the background and only afterwards
+// deletes them. Unchanged files are not copied: they are still live, and are
+// archived whenever a later edit retires them. The converted model.glb is
+// derived from the STL, so it is never archived; a restore reconverts it.
+//
+// Files are split with content-defined chunking (content-chunker.js) and only
+// chunks the project has never stored before are uploaded, so archiving a
+// 50MB model with a local edit costs a few hundred KB. A file whose content
+// hash already has a manifest costs nothing. Pruning old revisions deletes
+// the manifests and chunks no remaining revision needs.
+//
+// Restoring puts the revision's fields and file entries back on the project.
+// Files still live with the same content are reused as-is; the rest are
+// reassembled by Storage itself (compose), without streaming through the API.
+
+const crypto = require('crypto');
+const { firestore, storage, admin } = require('../config/firebase');
+const redisClient = require('../config/redis');
+const { chunkStream } = require('./content-chunker');
+const fileService = require('./file-service');
+
+const COMPOSE_LIMIT = 32; // Storage's maximum sources per compose
+const UPLOAD_CONCURRENCY = 4;
+// Archiving and pruning of one project run on one instance at a time, so a
+// prune never deletes chunks an archive is about to reference.
+const ARCHIVE_LEASE_TTL_MS = 10 * 60 * 1000;
+const MAX_REVISIONS = parseInt(process.env.MAX_PROJECT_REVISIONS, 10) || 50;
+const REVISION_FIELDS = ['title', 'description', 'tags', 'visibility', 'allowDownloads'];
+
+const httpError = (status, message) => Object.assign(new Error(message), { status });
+
+class RevisionService {
+  revisionsRef(projectId) {
+    return firestore.collection('projects').doc(projectId).collection('revisions');
+  }
+
+  manifestsRef(projectId) {
+    return firestore.collection('projects').doc(projectId).collection('manifests');
+  }
+
+  chunkPath(userId, projectId, hash) {
+    return `projects/${userId}/${projectId}/chunks/${hash}`;
+  }
+
+  /** Every file entry of a project, with a label for where it lives. */
+  listFiles(files = {}) {
+    const entries = [];
+    if (files.thumbnail?.storagePath) entries.push(['thumbnail', files.thumbnail]);
+    if (files.model?.stl?.storagePath) entries.push(['model.stl', files.model.stl]);
+    if (files.model?.glb?.storagePath) entries.push(['model.glb', files.model.glb]);
+    (files.attachments || []).forEach((file, i) => {
+      if (file.storagePath) entries.push([`attachments.${i}`, file]);
+    });
+    return entries;
+  }
+
+  /** Storage paths of the derived (never archived) files of a revision. */
+  derivedPaths(files = {}) {
+    return new Set(files.model?.glb?.storagePath ? [files.model.glb.storagePath] : []);
+  }
+
+  // --- Archiving ---
+
+  /**
+   * Stores a live file in the chunk store unless its content already is.
+   * @returns {Promise<{ contentHash: string, newBytes: number }>}
+   */
+  async archiveFile(projectId, userId, file, knownChunks) {
+    if (file.contentHash) {
+      const manifest = await this.manifestsRef(projectId).doc(file.contentHash).get();
+      if (manifest.exists) return { contentHash: file.contentHash, newBytes: 0 };
+    }
+
+    const bucket = storage.bucket();
+    const source = bucket.file(file.storagePath);
+    const [metadata] = await source.getMetadata();
+
+    const fileHash = crypto.createHash('sha256');
+    const chunks = [];
+    const uploads = new Set();
+    let newBytes = 0;
+
+    for await (const { hash, data } of chunkStream(source.createReadStream())) {
+      fileHash.update(data);
+      chunks.push(hash);
+      if (knownChunks.has(hash)) continue;
+      knownChunks.add(hash);
+      newBytes += data.length;
+
+      const upload = bucket.file(this.chunkPath(userId, projectId, hash))
+        .save(data, { resumable: false, contentType: 'application/octet-stream' })
+        .finally(() => uploads.delete(upload));
+      uploads.add(upload);
+      if (uploads.size >= UPLOAD_CONCURRENCY) await Promise.race(uploads);
+    }
+    await Promise.all(uploads);
+
+    const contentHash = fileHash.digest('hex');
+    await this.manifestsRef(projectId).doc(contentHash).set({
+      chunks,
+      size: parseInt(metadata.size, 10),
+      contentType: metadata.contentType || 'application/octet-stream',
+      // Lets a restore find files that were recorded before they had a hash.
+      sourcePath: file.storagePath,
+      createdAt: admin.firestore.FieldValue.serverTimestamp()
+    });
+    return { contentHash, newBytes };
+  }
+
+  async loadKnownChunks(projectId) {
+    const manifests = await this.manifestsRef(projectId).select('chunks').get();
+    return new Set(manifests.docs.flatMap(doc => doc.get('chunks') || []));
+  }
+
+  /**
+   * Records the project as it is now, before `reason` changes it. Only
+   * metadata is written here; files are archived when they are retired.
+   * @param {string} projectId
+   * @param {string} userId
+   * @param {Object} project - current project document data
+   * @param {string} reason - 'update' | 'patch' | 'restore'
+   * @returns {Promise<string>} revision id
+   */
+  async snapshot(projectId, userId, project, reason) {
+    const files = JSON.parse(JSON.stringify(project.files || {}, (key, value) => (
+      // Firestore timestamps don't survive a JSON round trip usefully.
+      value && typeof value.toDate === 'function' ? value.toDate().toISOString() : value
+    )));
+
+    const fields = {};
+    REVISION_FIELDS.forEach(field => {
+      if (project[field] !== undefined) fields[field] = project[field];
+    });
+
+    const revisionRef = this.revisionsRef(projectId).doc();
+    await revisionRef.set({
+      reason,
+      fields,
+      files,
+      archived: true, // nothing retired yet
+      newBytes: 0,
+      totalBytes: this.listFiles(files).reduce((sum, [, file]) => sum + (Number(file.size) || 0), 0),
+      createdAt: admin.firestore.FieldValue.serverTimestamp()
+    });
+    return revisionRef.id;
+  }
+
+  /**
+   * Called once the edit recorded by `revisionId` is committed, with the
+   * storage paths it no longer uses. Derived files are deleted right away;
+   * the rest are archived in the background and deleted after that. Never
+   * throws: the edit has already happened, at worst old files stay behind.
+   */
+  async retire(projectId, userId, revisionId, storagePaths) {
+    try {
+      const revisionRef = this.revisionsRef(projectId).doc(revisionId);
+      const revision = await revisionRef.get();
+      if (!revision.exists) return;
+
+      // Only files the revision lists; anything else was never the project's.
+      const files = revision.get('files');
+      const derived = this.derivedPaths(files);
+      const owned = new Set(this.listFiles(files).map(([, file]) => file.storagePath));
+      const paths = [...new Set(storagePaths)].filter(p => owned.has(p));
+
+      await Promise.all(paths.filter(p => derived.has(p)).map(p => (
+        storage.bucket().file(p).delete().catch(err => console.warn(err.message))
+      )));
+      const pendingPaths = paths.filter(p => !derived.has(p));
+      if (pendingPaths.length > 0) {
+        await revisionRef.update({ archived: false, pendingPaths });
+      }
+    } catch (error) {
+      console.error(`Failed to retire files of revision ${revisionId} of ${projectId}:`, error.message);
+      return;
+    }
+
+    setImmediate(() => {
+      this.archivePending(projectId, userId)
+        .catch(error => console.error(`Archiving revisions of ${projectId} failed:`, error));
+    });
+  }
+
+  /**
+   * Archives the retired files of every revision still pending, then prunes.
+   * A run that fails or crashes leaves its revisions pending; the next edit
+   * or restore of the project retries.
+   * @returns {Promise<boolean>} false when another instance holds the lease
+   */
+  async archivePending(projectId, userId) {
+    const leaseKey = `revisions:${projectId}:archive`;
+    const owner = crypto.randomUUID();
+    if (!(await redisClient.acquireLease(leaseKey, owner, ARCHIVE_LEASE_TTL_MS))) return false;
+
+    try {
+      const pending = await this.revisionsRef(projectId).where('archived', '==', false).get();
+      if (!pending.empty) await this.archive(projectId, userId, pending.docs);
+      await this.prune(projectId, userId);
+      return true;
+    } finally {
+      await redisClient.releaseLease(leaseKey, owner);
+    }
+  }
+
+  /** Stores the retired files of pending revisions, then deletes them from their live paths. */
+  async archive(projectId, userId, revisionDocs) {
+    const startedAt = Date.now();
+    const knownChunks = await this.loadKnownChunks(projectId);
+    for (const doc of revisionDocs) {
+      const { files, pendingPaths = [] } = doc.data();
+
+      // Sequential: each file may add to knownChunks for the next.
+      let newBytes = 0;
+      for (const [, file] of this.listFiles(files)) {
+        if (!pendingPaths.includes(file.storagePath)) continue;
+        try {
+          const archived = await this.archiveFile(projectId, userId, file, knownChunks);
+          file.contentHash = archived.contentHash;
+          newBytes += archived.newBytes;
+        } catch (error) {
+          // Already gone: nothing left to keep, and retrying would block restores.
+          if (error.code !== 404) throw error;
+          console.warn(`⚠️ ${file.storagePath} vanished before it was archived`);
+        }
+      }
+
+      await doc.ref.update({
+        files,
+        newBytes,
+        archived: true,
+        pendingPaths: admin.firestore.FieldValue.delete()
+      });
+      // Only now that the content is in the chunk store.
+      await Promise.all(pendingPaths.map(p => storage.bucket().file(p).delete().catch(err => console.warn(err.message))));
+      console.log(`🗂️ Revision ${doc.id} of ${projectId}: archived ${pendingPaths.length} file(s), ${Math.round(newBytes / 1024)}KB new`);
+    }
+    console.log(`🗂️ Archived ${revisionDocs.length} revision(s) of ${projectId} in ${Date.now() - startedAt}ms`);
+  }
+
+  /** Drops a revision that turned out to precede no change. */
+  async discard(projectId, revisionId) {
+    await this.revisionsRef(projectId).doc(revisionId).delete();
+  }
+
+  /**
+   * Keeps the newest MAX_REVISIONS, then deletes manifests no remaining
+   * revision lists and chunks no remaining manifest uses. Runs under the
+   * archive lease (see archivePending).
+   */
+  async prune(projectId, userId) {
+    const stale = await this.revisionsRef(projectId).orderBy('createdAt', 'desc').offset(MAX_REVISIONS).select().get();
+    if (stale.empty) return;
+    const batch = firestore.batch();
+    stale.docs.forEach(doc => batch.delete(doc.ref));
+    await batch.commit();
+
+    const [revisions, manifests] = await Promise.all([
+      this.revisionsRef(projectId).select('files').get(),
+      this.manifestsRef(projectId).get()
+    ]);
+    const referenced = new Set();
+    revisions.docs.forEach(doc => {
+      this.listFiles(doc.get('files')).forEach(([, file]) => referenced.add(file.contentHash));
+    });
+
+    const liveChunks = new Set();
+    const unusedManifests = [];
+    manifests.docs.forEach(doc => {
+      if (referenced.has(doc.id)) (doc.get('chunks') || []).forEach(hash => liveChunks.add(hash));
+      else unusedManifests.push(doc.ref);
+    });
+
+    const bucket = storage.bucket();
+    const [chunkFiles] = await bucket.getFiles({ prefix: this.chunkPath(userId, projectId, '') });
+    const unusedChunks = chunkFiles.filter(file => !liveChunks.has(file.name.split('/').pop()));
+
+    // Manifests first: a manifest must never outlive one of its chunks.
+    for (let i = 0; i < unusedManifests.length; i += 500) {
+      const manifestBatch = firestore.batch();
+      unusedManifests.slice(i, i + 500).forEach(ref => manifestBatch.delete(ref));
+      await manifestBatch.commit();
+    }
+    await Promise.all(unusedChunks.map(file => file.delete().catch(err => console.warn(err.message))));
+
+    console.log(`🧹 Pruned ${stale.size} revision(s) of ${projectId}: ${unusedManifests.length} manifest(s), ${unusedChunks.length} chunk(s) deleted`);
+  }
+
+  async listRevisions(projectId) {
+    const snapshot = await this.revisionsRef(projectId).orderBy('createdAt', 'desc').get();
+    return snapshot.docs.map(doc => {
+      const data = doc.data();
+      return {
+        id: doc.id,
+        reason: data.reason,
+        title: data.fields?.title,
+        fileCount: this.listFiles(data.files).length,
+        newBytes: data.newBytes,
+        totalBytes: data.totalBytes,
+        createdAt: data.createdAt?.toDate?.() || data.createdAt
+      };
+    });
+  }
+
+  // --- Restoring ---
+
+  /** Reassembles a file from its chunks at `destination` using Storage compose. */
+  async composeFile(projectId, userId, contentHash, destination) {
+    const manifest = await this.manifestsRef(projectId).doc(contentHash).get();
+    if (!manifest.exists) throw httpError(409, `Revision content ${contentHash.slice(0, 12)} is missing`);
+    const { chunks, contentType } = manifest.data();
+
+    const bucket = storage.bucket();
+    if (chunks.length === 0) {
+      await bucket.file(destination).save(Buffer.alloc(0), { resumable: false, contentType });
+      return;
+    }
+
+    const temporary = [];
+    let sources = chunks.map(hash => bucket.file(this.chunkPath(userId, projectId, hash)));
+
+    try {
+      // Compose in rounds of at most 32 sources until one object remains.
+      while (sources.length > COMPOSE_LIMIT) {
+        const next = [];
+        for (let i = 0; i < sources.length; i += COMPOSE_LIMIT) {
+          const part = bucket.file(`projects/${userId}/${projectId}/tmp/${crypto.randomUUID()}`);
+          await bucket.combine(sources.slice(i, i + COMPOSE_LIMIT), part);
+          temporary.push(part);
+          next.push(part);
+        }
+        sources = next;
+      }
+      const target = bucket.file(destination);
+      await bucket.combine(sources, target);
+      await target.setMetadata({ contentType });
+    } finally {
+      await Promise.all(temporary.map(part => part.delete().catch(() => {})));
+    }
+  }
+
+  /** Content hash of a file recorded before files carried one, via its archive. */
+  async findArchivedHash(projectId, storagePath) {
+    const manifests = await this.manifestsRef(projectId).where('sourcePath', '==', storagePath).limit(1).select().get();
+    return manifests.empty ? null : manifests.docs[0].id;
+  }
+
+  /**
+   * Makes a revision current. The state being replaced is recorded first,
+   * so a restore can itself be undone.
+   * @returns {Promise<{ reconvert: Object|null }>} the restored STL entry when
+   *   its GLB is no longer live and has to be converted again
+   */
+  async restore(projectId, userId, revisionId) {
+    const projectRef = firestore.collection('projects').doc(projectId);
+    const [projectDoc, revisionDoc] = await Promise.all([
+      projectRef.get(),
+      this.revisionsRef(projectId).doc(revisionId).get()
+    ]);
+    if (!projectDoc.exists || projectDoc.data().userId !== userId) {
+      throw httpError(404, 'Project not found or you do not have permission to edit it.');
+    }
+    if (!revisionDoc.exists) throw httpError(404, 'Revision not found');
+
+    // Files retired by earlier edits must be in the chunk store before composing.
+    if (!(await this.archivePending(projectId, userId))) {
+      throw httpError(409, 'Revision history is being updated, try again shortly');
+    }
+
+    const current = projectDoc.data();
+    const revision = revisionDoc.data();
+    const files = revision.files || {};
+    const derived = this.derivedPaths(files);
+    const snapshotId = await this.snapshot(projectId, userId, current, 'restore');
+
+    // Content still live somewhere in the project needs no reassembly when
+    // it is already at the path the revision expects.
+    const live = new Map(this.listFiles(current.files).map(([, file]) => [file.storagePath, file.contentHash]));
+    const takenPaths = new Set(live.keys());
+    const restoredPaths = new Set();
+    const composed = [];
+    try {
+      for (const [, file] of this.listFiles(files)) {
+        if (live.has(file.storagePath) && live.get(file.storagePath) === file.contentHash) {
+          restoredPaths.add(file.storagePath);
+          continue;
+        }
+        if (derived.has(file.storagePath)) continue; // not archived; reconverted instead
+
+        const contentHash = file.contentHash || await this.findArchivedHash(projectId, file.storagePath);
+        if (!contentHash) throw httpError(409, `Revision file ${file.filename || file.storagePath} is missing`);
+        // FIX: Paths get reused, so the live object there may hold other,
+        // unarchived content; compose next to it and let it be retired.
+        const destination = fileService.uniqueStoragePath(file.storagePath, takenPaths);
+        await this.composeFile(projectId, userId, contentHash, destination);
+        takenPaths.add(destination);
+        file.storagePath = destination;
+        file.contentHash = contentHash;
+        composed.push(destination);
+        restoredPaths.add(destination);
+      }
+    } catch (error) {
+      await Promise.all(composed.map(p => storage.bucket().file(p).delete().catch(err => console.warn(err.message))));
+      await this.discard(projectId, snapshotId).catch(err => console.warn(err.message));
+      throw error;
+    }
+
+    const hasGlb = !!files.model?.glb && restoredPaths.has(files.model.glb.storagePath);
+    if (files.model?.glb && !hasGlb) delete files.model.glb;
+    const reconvert = files.model?.stl && !hasGlb ? files.model.stl : null;
+
+    await projectRef.update({
+      ...revision.fields,
+      files,
+      conversionStatus: reconvert
+        ? {
+            stlFiles: 1,
+            convertedFiles: 0,
+            inProgress: true,
+            completed: false,
+            errors: [],
+            startedAt: admin.firestore.FieldValue.serverTimestamp()
+          }
+        : {
+            stlFiles: files.model?.stl ? 1 : 0,
+            convertedFiles: hasGlb ? 1 : 0,
+            inProgress: false,
+            completed: true,
+            errors: [],
+            completedAt: admin.firestore.FieldValue.serverTimestamp()
+          },
+      restoredFrom: revisionId,
+      updatedAt: admin.firestore.FieldValue.serverTimestamp()
+    });
+
+    // Live objects the restored project no longer references.
+    await this.retire(projectId, userId, snapshotId, [...live.keys()].filter(p => !restoredPaths.has(p)));
+
+    console.log(`⏪ Restored project ${projectId} to revision ${revisionId}`);
+    return { reconvert };
+  }
+
+  /** Removes history documents with the project (chunks go with its storage prefix). */
+  async deleteHistory(projectId) {
+    await Promise.all([
+      firestore.recursiveDelete(this.revisionsRef(projectId)),
+      firestore.recursiveDelete(this.manifestsRef(projectId))
+    ]);
+  }
+}
+
+module.exports = new RevisionService();
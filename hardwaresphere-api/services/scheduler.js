@@ -0,0 +1,231 @@
+// In-process scheduler for maintenance work that must stay off the request path.
+//
+//   scheduler:leader   Redis string  id of the instance holding the leader lease
+//
+// A job runs either on a cron expression (minute resolution, five fields:
+// minute hour day-of-month month day-of-week) or every N ms for sub-minute
+// work, and has a scope:
+//
+//   cluster    runs on the leader only, so once cluster-wide
+//   instance   runs on every instance (machine-local work, e.g. temp files)
+//
+// Leadership is a Redis lease renewed every few seconds; if the leader dies,
+// another instance takes over within LEASE_TTL_MS. While Redis is unavailable
+// nobody leads and cluster jobs pause - they all work on Redis state anyway.
+//
+// Each run is delayed by a random jitter so instances don't fire in lockstep,
+// a run still in progress when the job comes due again is skipped rather than
+// stacked, and run counts and durations are kept for /api/admin/status.
+
+const crypto = require('crypto');
+const os = require('os');
+const redisClient = require('../config/redis');
+
+const LEADER_KEY = 'scheduler:leader';
+const LEASE_TTL_MS = 15000;
+const LEASE_RENEW_MS = 5000;
+const TICK_MS = 1000;
+
+// --- Cron expressions ---
+
+const CRON_FIELDS = [
+  { name: 'minute', min: 0, max: 59 },
+  { name: 'hour', min: 0, max: 23 },
+  { name: 'day of month', min: 1, max: 31 },
+  { name: 'month', min: 1, max: 12 },
+  { name: 'day of week', min: 0, max: 6 }
+];
+
+// Expands one field ("*", "5", "1-5", "*/15", "0-30/10", lists of those) into a Set.
+function parseCronField(text, { name, min, max }) {
+  const values = new Set();
+  for (const part of text.split(',')) {
+    const match = /^(\*|(\d+)(?:-(\d+))?)(?:\/(\d+))?$/.exec(part);
+    if (!match) throw new Error(`Invalid cron ${name}: "${part}"`);
+    const step = match[4] ? parseInt(match[4], 10) : 1;
+    let from = min;
+    let to = max;
+    if (match[1] !== '*') {
+      from = parseInt(match[2], 10);
+      to = match[3] !== undefined ? parseInt(match[3], 10) : (match[4] ? max : from);
+    }
+    if (from < min || to > max || from > to || step < 1) throw new Error(`Invalid cron ${name}: "${part}"`);
+    for (let value = from; value <= to; value += step) values.add(value);
+  }
+  return values;
+}
+
+function parseCron(expression) {
+  const parts = expression.trim().split(/\s+/);
+  if (parts.length !== 5) throw new Error(`Cron expression needs 5 fields: "${expression}"`);
+  const [minutes, hours, days, months, weekdays] = parts.map((part, i) => parseCronField(part, CRON_FIELDS[i]));
+  return {
+    minutes, hours, days, months, weekdays,
+    // As in cron: when both day fields are restricted, either may match.
+    anyDay: parts[2] === '*' || parts[4] === '*'
+  };
+}
+
+/** First minute strictly after `after` (ms) that matches, in server local time. */
+function nextCronTime(cron, after) {
+  const date = new Date(after);
+  date.setSeconds(0, 0);
+  date.setMinutes(date.getMinutes() + 1);
+
+  // Four years and a day covers the rarest match, Feb 29.
+  const limit = after + (4 * 366 + 1) * 24 * 60 * 60 * 1000;
+  while (date.getTime() <= limit) {
+    const dayMatches = cron.anyDay
+      ? cron.days.has(date.getDate()) && cron.weekdays.has(date.getDay())
+      : cron.days.has(date.getDate()) || cron.weekdays.has(date.getDay());
+    if (!cron.months.has(date.getMonth() + 1) || !dayMatches) {
+      date.setHours(24, 0, 0, 0);
+    } else if (!cron.hours.has(date.getHours())) {
+      date.setHours(date.getHours() + 1, 0, 0, 0);
+    } else if (!cron.minutes.has(date.getMinutes())) {
+      date.setMinutes(date.getMinutes() + 1, 0, 0);
+    } else {
+      return date.getTime();
+    }
+  }
+  throw new Error('Cron expression never matches');
+}
+
+// --- Scheduler ---
+
+class Scheduler {
+  constructor() {
+    this.id = `${os.hostname()}:${process.pid}:${crypto.randomBytes(4).toString('hex')}`;
+    this.jobs = new Map();
+    this.isLeader = false;
+    this.timers = [];
+  }
+
+  /**
+   * Registers a job. Takes effect immediately if the scheduler is running.
+   * @param {string} name
+   * @param {Object} options
+   * @param {string} [options.cron] - five-field cron expression
+   * @param {number} [options.everyMs] - fixed interval, for sub-minute jobs
+   * @param {'cluster'|'instance'} [options.scope='cluster']
+   * @param {number} [options.jitterMs=0] - random delay added to each run
+   * @param {boolean} [options.runOnStart=false] - also run once right after start
+   * @param {() => Promise<*>} task
+   */
+  register(name, options, task) {
+    if (this.jobs.has(name)) throw new Error(`Job "${name}" is already registered`);
+    if (!options.cron === !options.everyMs) throw new Error(`Job "${name}" needs exactly one of cron or everyMs`);
+
+    this.jobs.set(name, {
+      name,
+      task,
+      cron: options.cron ? parseCron(options.cron) : null,
+      schedule: options.cron || `every ${options.everyMs}ms`,
+      everyMs: options.everyMs,
+      scope: options.scope || 'cluster',
+      jitterMs: options.jitterMs || 0,
+      runOnStart: !!options.runOnStart,
+      nextRunAt: null,
+      running: false,
+      stats: { runs: 0, failures: 0, skipped: 0, lastRunAt: null, lastDurationMs: null, maxDurationMs: 0, totalDurationMs: 0, lastError: null }
+    });
+    if (this.timers.length > 0) this.plan(this.jobs.get(name), Date.now(), true);
+    return this;
+  }
+
+  plan(job, now, starting = false) {
+    const due = starting && job.runOnStart
+      ? now
+      : job.cron ? nextCronTime(job.cron, now) : now + job.everyMs;
+    job.nextRunAt = due + Math.floor(Math.random() * job.jitterMs);
+  }
+
+  /** Runs due jobs. Once per second; a job that comes due while running is skipped. */
+  tick() {
+    const now = Date.now();
+    for (const job of this.jobs.values()) {
+      if (now < job.nextRunAt) continue;
+      this.plan(job, now);
+      if (job.scope === 'cluster' && !this.isLeader) continue;
+      if (job.running) {
+        job.stats.skipped++;
+        console.warn(`⏭️ Job ${job.name} still running, skipped a run`);
+        continue;
+      }
+      this.runJob(job);
+    }
+  }
+
+  async runJob(job) {
+    job.running = true;
+    const startedAt = Date.now();
+    try {
+      await job.task();
+    } catch (error) {
+      job.stats.failures++;
+      job.stats.lastError = error.message;
+      console.error(`❌ Job ${job.name} failed:`, error.message);
+    } finally {
+      const durationMs = Date.now() - startedAt;
+      job.running = false;
+      job.stats.runs++;
+      job.stats.lastRunAt = new Date(startedAt).toISOString();
+      job.stats.lastDurationMs = durationMs;
+      job.stats.totalDurationMs += durationMs;
+      job.stats.maxDurationMs = Math.max(job.stats.maxDurationMs, durationMs);
+    }
+  }
+
+  async renewLeadership() {
+    const wasLeader = this.isLeader;
+    this.isLeader = await redisClient.acquireLease(LEADER_KEY, this.id, LEASE_TTL_MS);
+    if (this.isLeader !== wasLeader) {
+      console.log(this.isLeader ? `👑 Scheduler leader: ${this.id}` : `👋 Scheduler leadership lost: ${this.id}`);
+    }
+  }
+
+  async start() {
+    if (this.timers.length > 0) return;
+    await this.renewLeadership();
+
+    const now = Date.now();
+    this.jobs.forEach(job => this.plan(job, now, true));
+
+    const every = (ms, task) => {
+      const timer = setInterval(task, ms);
+      timer.unref();
+      this.timers.push(timer);
+    };
+    every(LEASE_RENEW_MS, () => this.renewLeadership().catch(() => {}));
+    every(TICK_MS, () => this.tick());
+    console.log(`⏰ Scheduler started with ${this.jobs.size} jobs (${this.isLeader ? 'leader' : 'follower'})`);
+  }
+
+  /** Stops scheduling and hands leadership over without waiting for the lease to expire. */
+  async stop() {
+    this.timers.forEach(clearInterval);
+    this.timers = [];
+    if (this.isLeader) {
+      this.isLeader = false;
+      await redisClient.releaseLease(LEADER_KEY, this.id);
+    }
+  }
+
+  getStatus() {
+    const jobs = {};
+    for (const job of this.jobs.values()) {
+      const { totalDurationMs, ...stats } = job.stats;
+      jobs[job.name] = {
+        schedule: job.schedule,
+        scope: job.scope,
+        running: job.running,
+        nextRunAt: job.nextRunAt && new Date(job.nextRunAt).toISOString(),
+        ...stats,
+        avgDurationMs: stats.runs > 0 ? Math.round(totalDurationMs / stats.runs) : null
+      };
+    }
+    return { instance: this.id, leader: this.isLeader, jobs };
+  }
+}
+
+module.exports = new Scheduler();
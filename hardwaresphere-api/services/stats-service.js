@@ -0,0 +1,196 @@
+// Keeps users/<uid>.stats-style aggregates current without scanning projects.
+//
+//   users/<uid>/statShards/<0..N-1>   { totalProjects, totalViews, totalLikes }
+//   views:pending                     Redis hash  projectId -> views not yet written
+//   stats:backfill                    Redis set   users still without shards
+//
+// Every change is an increment on one randomly chosen shard, so busy users
+// don't serialize on a single document (Firestore sustains about one write
+// per second per document). Reading sums a fixed number of shards.
+//
+// Views are buffered in Redis and flushed in batches: one write per project
+// and one per owner per interval, however many views came in.
+//
+// Users from before sharding (no statsShardedAt) are counted from their
+// projects when read, and queued for the scheduler to rebuild their shards;
+// reads never write.
+
+const { firestore, admin } = require('../config/firebase');
+const redisClient = require('../config/redis');
+
+const SHARD_COUNT = 10;
+const PENDING_VIEWS_KEY = 'views:pending';
+const BACKFILL_KEY = 'stats:backfill';
+const STAT_FIELDS = ['totalProjects', 'totalViews', 'totalLikes'];
+
+const increment = admin.firestore.FieldValue.increment;
+
+class StatsService {
+  constructor() {
+    this.flushing = null;
+  }
+
+  shardsRef(userId) {
+    return firestore.collection('users').doc(userId).collection('statShards');
+  }
+
+  randomShard(userId) {
+    return this.shardsRef(userId).doc(String(Math.floor(Math.random() * SHARD_COUNT)));
+  }
+
+  /**
+   * Queues increments to a user's aggregates on a batch or transaction, so
+   * they commit together with the change that caused them.
+   * @param {FirebaseFirestore.WriteBatch|FirebaseFirestore.Transaction} writer
+   * @param {string} userId
+   * @param {Object<string, number>} deltas - e.g. { totalProjects: 1 }
+   */
+  applyUserDeltas(writer, userId, deltas) {
+    const update = {};
+    Object.entries(deltas).forEach(([field, amount]) => {
+      if (amount) update[field] = increment(amount);
+    });
+    if (Object.keys(update).length > 0) {
+      writer.set(this.randomShard(userId), update, { merge: true });
+    }
+  }
+
+  /**
+   * Sums the shards. Users from before sharding are counted from their
+   * projects instead, and queued for backfillUserStats.
+   * @param {string} userId
+   * @param {Object} userData - the users/<uid> document data
+   */
+  async getUserStats(userId, userData) {
+    if (!userData?.statsShardedAt) {
+      await redisClient.sAdd(BACKFILL_KEY, [userId]);
+      return this.countUserStats(firestore, userId);
+    }
+
+    const snapshot = await this.shardsRef(userId).get();
+
+    const stats = { totalProjects: 0, totalViews: 0, totalLikes: 0 };
+    snapshot.docs.forEach(doc => {
+      STAT_FIELDS.forEach(field => { stats[field] += doc.get(field) || 0; });
+    });
+    return stats;
+  }
+
+  /** Totals over a user's projects, read through `reader` (Firestore or a transaction). */
+  async countUserStats(reader, userId) {
+    const query = firestore.collection('projects').where('userId', '==', userId).select('stats');
+    const projects = await (reader === firestore ? query.get() : reader.get(query));
+    const stats = { totalProjects: projects.size, totalViews: 0, totalLikes: 0 };
+    projects.docs.forEach(doc => {
+      stats.totalViews += doc.get('stats.views') || 0;
+      stats.totalLikes += doc.get('stats.likes') || 0;
+    });
+    return stats;
+  }
+
+  /**
+   * Recomputes a user's aggregates from their projects: shard 0 gets the
+   * totals and the others are zeroed. Runs in a transaction that holds the
+   * shards and projects, so increments landing meanwhile are neither lost
+   * nor counted twice. Returns null if the user was already sharded.
+   */
+  async rebuildUserStats(userId) {
+    const userRef = firestore.collection('users').doc(userId);
+    const shardRefs = Array.from({ length: SHARD_COUNT }, (_, i) => this.shardsRef(userId).doc(String(i)));
+
+    const stats = await firestore.runTransaction(async (transaction) => {
+      const [userDoc] = await transaction.getAll(userRef, ...shardRefs);
+      if (!userDoc.exists || userDoc.get('statsShardedAt')) return null;
+
+      const totals = await this.countUserStats(transaction, userId);
+      shardRefs.forEach((ref, i) => {
+        transaction.set(ref, i === 0 ? totals : { totalProjects: 0, totalViews: 0, totalLikes: 0 });
+      });
+      transaction.set(userRef, { statsShardedAt: admin.firestore.FieldValue.serverTimestamp() }, { merge: true });
+      return totals;
+    });
+
+    if (stats) console.log(`📊 Rebuilt stats for user ${userId}: ${JSON.stringify(stats)}`);
+    return stats;
+  }
+
+  /** Shards the users queued by getUserStats. Run by the scheduler. */
+  async backfillUserStats() {
+    const userIds = await redisClient.sTakeAll(BACKFILL_KEY);
+    const failed = [];
+    for (const userId of userIds) {
+      try {
+        await this.rebuildUserStats(userId);
+      } catch (error) {
+        console.error(`❌ Stats backfill failed for user ${userId}:`, error.message);
+        failed.push(userId);
+      }
+    }
+    if (failed.length > 0) await redisClient.sAdd(BACKFILL_KEY, failed);
+  }
+
+  // --- Views ---
+
+  /** Counts one view. Falls back to a direct write when Redis is unavailable. */
+  async recordView(projectId) {
+    const buffered = await redisClient.hIncrByMany(PENDING_VIEWS_KEY, { [projectId]: 1 });
+    if (buffered) return;
+    await this.writeViews({ [projectId]: 1 });
+  }
+
+  /** Writes buffered views to projects and their owners' shards. */
+  async flushViews() {
+    if (this.flushing) return this.flushing;
+
+    this.flushing = (async () => {
+      const pending = await redisClient.hTakeAll(PENDING_VIEWS_KEY);
+      const counts = {};
+      Object.entries(pending || {}).forEach(([projectId, count]) => {
+        if (Number(count) > 0) counts[projectId] = Number(count);
+      });
+      if (Object.keys(counts).length === 0) return;
+
+      try {
+        await this.writeViews(counts);
+      } catch (error) {
+        // Put back what wasn't committed for the next flush.
+        console.error('❌ View flush failed, requeueing:', error.message);
+        await redisClient.hIncrByMany(PENDING_VIEWS_KEY, error.uncommitted || counts);
+      }
+    })().finally(() => { this.flushing = null; });
+
+    return this.flushing;
+  }
+
+  async writeViews(counts) {
+    const projectIds = Object.keys(counts);
+    const refs = projectIds.map(id => firestore.collection('projects').doc(id));
+
+    // Firestore batches hold at most 500 writes: a project and its owner each.
+    for (let i = 0; i < refs.length; i += 200) {
+      const chunk = refs.slice(i, i + 200);
+      const docs = await firestore.getAll(...chunk, { fieldMask: ['userId'] });
+      const batch = firestore.batch();
+      const viewsByOwner = new Map();
+
+      docs.forEach(doc => {
+        if (!doc.exists) return; // Deleted since the view; drop it.
+        const views = counts[doc.id];
+        batch.update(doc.ref, { 'stats.views': increment(views) });
+        const owner = doc.get('userId');
+        if (owner) viewsByOwner.set(owner, (viewsByOwner.get(owner) || 0) + views);
+      });
+      viewsByOwner.forEach((views, owner) => this.applyUserDeltas(batch, owner, { totalViews: views }));
+
+      try {
+        await batch.commit();
+      } catch (error) {
+        error.uncommitted = Object.fromEntries(projectIds.slice(i).map(id => [id, counts[id]]));
+        throw error;
+      }
+    }
+    console.log(`📊 Flushed views for ${projectIds.length} projects`);
+  }
+}
+
+module.exports = new StatsService();
@@ -0,0 +1,330 @@
+// Username availability without per-keystroke Firestore queries.
+//
+//   usernames/<lowercase name>   Firestore  { uid, username } - the source of
+//                                truth, claimed transactionally with users/<uid>
+//   usernames:owners             Redis hash    lowercase name -> uid
+//   usernames:indexed            Redis string  set once the hash covers every profile
+//   usernames:synced-until       Redis string  createdAt (ms) of the newest profile indexed
+//   usernames:added              Redis channel names added, for every instance's filter
+//   Bloom filter                 in process, every name ever seen
+//
+// A check first consults the reserved list and the Bloom filter; a miss
+// there is a definite "available" without any I/O, unless the name has the
+// shape of a generated one (see CLIENT_USERNAME_PATTERN). Only possible hits go
+// to Redis (then Firestore) to confirm and find the owner. Names are
+// case-insensitive everywhere: "Jane" and "jane" are the same user.
+//
+// Each instance seeds its filter from the Redis hash in the background.
+// When the hash is missing (first deploy, Redis flushed) one instance
+// rebuilds it with a paged scan of users/, which also writes the usernames/
+// entries older profiles lack. Until the filter is loaded, checks go to
+// Firestore. Profiles are also created client-side (lib/user-service.ts);
+// the username-sync job picks those up by createdAt (see server.js).
+
+const os = require('os');
+const { firestore, admin } = require('../config/firebase');
+const redisClient = require('../config/redis');
+const BloomFilter = require('./bloom-filter');
+
+const OWNERS_KEY = 'usernames:owners';
+const INDEXED_KEY = 'usernames:indexed';
+const SYNCED_UNTIL_KEY = 'usernames:synced-until';
+const ADDED_CHANNEL = 'usernames:added';
+const BACKFILL_LOCK_KEY = 'usernames:backfill-lock';
+const USERNAME_PATTERN = /^[A-Za-z0-9_.-]{3,30}$/;
+// Shape of the names lib/user-service.ts generates for client-created
+// profiles (up to 15 lowercase letters/digits plus a 0-999 suffix). Only
+// these can be taken without being in the filter yet.
+const CLIENT_USERNAME_PATTERN = /^[a-z0-9]{0,17}[0-9]$/;
+const FILTER_CAPACITY = parseInt(process.env.USERNAME_FILTER_CAPACITY, 10) || 200000;
+const PAGE_SIZE = 500;
+const LOAD_RETRY_MS = 30000;
+const BACKFILL_LOCK_SECONDS = 15 * 60;
+// Re-indexes from scratch every so often, dropping names released by renames
+// made outside claim()
+const INDEXED_TTL_SECONDS = 7 * 24 * 60 * 60;
+// createdAt is a server timestamp, but commits can land slightly out of order
+const SYNC_OVERLAP_MS = 60000;
+
+// Names that would shadow app routes or impersonate the site.
+const RESERVED_USERNAMES = new Set([
+  'admin', 'administrator', 'api', 'app', 'auth', 'dashboard', 'embed', 'explore',
+  'help', 'hardwaresphere', 'login', 'logout', 'me', 'new', 'null', 'project',
+  'projects', 'root', 'search', 'settings', 'signin', 'signup', 'support',
+  'system', 'undefined', 'user', 'users'
+]);
+
+class UsernameTakenError extends Error {
+  constructor(username) {
+    super('Username is already taken. Please choose another.');
+    this.status = 409;
+    this.username = username;
+  }
+}
+
+const normalize = (username) => username.trim().toLowerCase();
+
+class UsernameIndex {
+  constructor() {
+    this.filter = new BloomFilter(FILTER_CAPACITY, 0.01);
+    this.ready = false;
+    this.started = false;
+  }
+
+  /** Loads the filter in the background; checks fall back to Firestore until it is ready. */
+  start() {
+    if (this.started) return;
+    this.started = true;
+
+    redisClient.subscribe(ADDED_CHANNEL, (message) => {
+      try {
+        JSON.parse(message).forEach(key => this.filter.add(key));
+      } catch (error) {
+        console.warn('⚠️ Ignoring malformed username broadcast:', error.message);
+      }
+    });
+
+    const attempt = () => this.load().catch((error) => {
+      console.error('❌ Username index load failed:', error.message);
+      return false;
+    }).then((loaded) => {
+      if (!loaded) setTimeout(attempt, LOAD_RETRY_MS).unref();
+    });
+    attempt();
+  }
+
+  /** @returns {Promise<boolean>} false when it should be retried later */
+  async load() {
+    const startedAt = Date.now();
+    if (!await redisClient.get(INDEXED_KEY)) {
+      // Another instance may be rebuilding; its result is picked up on retry.
+      if (!await redisClient.setIfAbsent(BACKFILL_LOCK_KEY, `${os.hostname()}:${process.pid}`, BACKFILL_LOCK_SECONDS)) {
+        return false;
+      }
+      try {
+        await this.backfill();
+      } finally {
+        await redisClient.del(BACKFILL_LOCK_KEY);
+      }
+    }
+
+    const owners = await redisClient.hGetAll(OWNERS_KEY);
+    if (!owners) return false;
+    Object.keys(owners).forEach(key => this.filter.add(key));
+    this.ready = true;
+
+    console.log(`🔤 Username index ready: ${Object.keys(owners).length} names in ${Date.now() - startedAt}ms`);
+    if (this.filter.count > FILTER_CAPACITY) {
+      console.warn('⚠️ Username filter is over capacity; raise USERNAME_FILTER_CAPACITY');
+    }
+    return true;
+  }
+
+  /**
+   * Rebuilds the Redis hash from users/, a page at a time, and writes the
+   * usernames/ entries that profiles from before claim() lack. Where two old
+   * profiles differ only by case, the first one keeps the name.
+   */
+  async backfill() {
+    const startedAt = Date.now();
+    console.log('🔤 Rebuilding username index from Firestore...');
+    await redisClient.del(OWNERS_KEY);
+
+    let last = null;
+    let total = 0;
+    for (;;) {
+      let query = firestore.collection('users')
+        .orderBy(admin.firestore.FieldPath.documentId())
+        .select('username')
+        .limit(PAGE_SIZE);
+      if (last) query = query.startAfter(last);
+      const page = await query.get();
+      if (page.empty) break;
+      last = page.docs[page.docs.length - 1];
+
+      await this.indexProfiles(page.docs);
+      total += page.size;
+      if (page.size < PAGE_SIZE) break;
+    }
+
+    await redisClient.set(SYNCED_UNTIL_KEY, startedAt, INDEXED_TTL_SECONDS);
+    await redisClient.set(INDEXED_KEY, true, INDEXED_TTL_SECONDS);
+    console.log(`🔤 Username index rebuilt: ${total} users in ${Date.now() - startedAt}ms`);
+  }
+
+  /**
+   * Adds profiles to usernames/, the Redis hash and every instance's filter.
+   * @param {FirebaseFirestore.DocumentSnapshot[]} docs - users/<uid> documents
+   */
+  async indexProfiles(docs) {
+    const owners = {};
+    docs.forEach(doc => {
+      const username = doc.get('username');
+      if (typeof username === 'string' && username.trim()) {
+        const key = normalize(username);
+        if (!owners[key]) owners[key] = { uid: doc.id, username };
+      }
+    });
+    const keys = Object.keys(owners);
+    if (keys.length === 0) return;
+
+    const nameRefs = keys.map(key => firestore.collection('usernames').doc(key));
+    const nameDocs = await firestore.getAll(...nameRefs);
+    const batch = firestore.batch();
+    let writes = 0;
+    nameDocs.forEach((nameDoc, i) => {
+      const key = keys[i];
+      if (nameDoc.exists) {
+        // The claimed owner wins over a legacy profile with the same name
+        owners[key].uid = nameDoc.get('uid');
+        return;
+      }
+      batch.set(nameRefs[i], { ...owners[key], claimedAt: admin.firestore.FieldValue.serverTimestamp() });
+      writes++;
+    });
+    if (writes > 0) await batch.commit();
+
+    await redisClient.hSet(OWNERS_KEY, Object.fromEntries(keys.map(key => [key, owners[key].uid])));
+    keys.forEach(key => this.filter.add(key));
+    await redisClient.publish(ADDED_CHANNEL, keys);
+  }
+
+  /** Indexes profiles created client-side since the last run. Run by the scheduler. */
+  async syncNewProfiles() {
+    if (!await redisClient.get(INDEXED_KEY)) return; // a backfill will cover them
+    const since = await redisClient.get(SYNCED_UNTIL_KEY) || Date.now();
+
+    const page = await firestore.collection('users')
+      .where('createdAt', '>', admin.firestore.Timestamp.fromMillis(since - SYNC_OVERLAP_MS))
+      .orderBy('createdAt')
+      .select('username', 'createdAt')
+      .limit(PAGE_SIZE)
+      .get();
+    if (page.empty) return;
+
+    await this.indexProfiles(page.docs);
+    const newest = page.docs[page.docs.length - 1].get('createdAt').toMillis();
+    await redisClient.set(SYNCED_UNTIL_KEY, newest, INDEXED_TTL_SECONDS);
+  }
+
+  validate(username) {
+    if (typeof username !== 'string' || !USERNAME_PATTERN.test(username.trim())) return 'invalid';
+    if (RESERVED_USERNAMES.has(normalize(username))) return 'reserved';
+    return null;
+  }
+
+  /** uid owning the name in Firestore, or null. */
+  async findOwnerInFirestore(username) {
+    const key = normalize(username);
+    const doc = await firestore.collection('usernames').doc(key).get();
+    if (doc.exists) return doc.data().uid;
+
+    // Client-created profiles (always lowercase) until username-sync indexes them.
+    const recent = await firestore.collection('users').where('username', '==', key).limit(1).get();
+    return recent.empty ? null : recent.docs[0].id;
+  }
+
+  /** uid owning the name, or null. Consults Redis, then Firestore. */
+  async lookupOwner(username) {
+    const owner = this.ready ? await redisClient.hGet(OWNERS_KEY, normalize(username)) : undefined;
+    if (owner) return owner;
+    return this.findOwnerInFirestore(username);
+  }
+
+  /**
+   * users/<uid> document for a profile URL, matched case-insensitively, or null.
+   * @returns {Promise<FirebaseFirestore.DocumentSnapshot|null>}
+   */
+  async findUser(username) {
+    if (typeof username !== 'string' || !username.trim()) return null;
+    const uid = await this.lookupOwner(username);
+    if (!uid) return null;
+    const doc = await firestore.collection('users').doc(uid).get();
+    // The hash can briefly lag a rename
+    if (!doc.exists || normalize(doc.get('username') || '') !== normalize(username)) return null;
+    return doc;
+  }
+
+  /**
+   * @returns {Promise<{ available: boolean, isCurrentUser?: boolean, reason?: string }>}
+   */
+  async check(username, uid) {
+    const invalid = this.validate(username);
+    if (invalid) return { available: false, reason: invalid };
+
+    const key = normalize(username);
+    // Definite negative: no I/O at all.
+    // FIX: ...except for names a client-created profile could hold, which the
+    // filter only learns at the next username-sync; those go to Firestore.
+    if (this.ready && !this.filter.mightContain(key)) {
+      if (!CLIENT_USERNAME_PATTERN.test(key)) return { available: true };
+      const owner = await this.findOwnerInFirestore(username);
+      if (!owner) return { available: true };
+      return owner === uid ? { available: true, isCurrentUser: true } : { available: false, reason: 'taken' };
+    }
+
+    const owner = await this.lookupOwner(username);
+    if (!owner) return { available: true };
+    if (owner === uid) return { available: true, isCurrentUser: true };
+    return { available: false, reason: 'taken' };
+  }
+
+  /**
+   * Throws what claim() would, without claiming; for failing fast before
+   * other side effects.
+   * @throws {UsernameTakenError}
+   */
+  async assertClaimable(uid, username) {
+    const invalid = this.validate(username);
+    if (invalid) {
+      throw Object.assign(new Error(invalid === 'reserved' ? 'This username is reserved.' : 'Usernames are 3-30 letters, numbers, dots, dashes or underscores.'), { status: 400 });
+    }
+    // Straight to Firestore: the hash may still hold a name released by a rename.
+    const owner = await this.findOwnerInFirestore(username);
+    if (owner && owner !== uid) throw new UsernameTakenError(username);
+  }
+
+  /**
+   * Atomically moves `uid` to `username`: reserves usernames/<name>, releases
+   * the old reservation and updates users/<uid>.username.
+   * @throws {UsernameTakenError}
+   */
+  async claim(uid, username) {
+    // Client-created profiles may have no usernames/ entry yet, which the
+    // transaction alone can't see.
+    await this.assertClaimable(uid, username);
+
+    const key = normalize(username);
+    const userRef = firestore.collection('users').doc(uid);
+    const nameRef = firestore.collection('usernames').doc(key);
+
+    const oldUsername = await firestore.runTransaction(async (transaction) => {
+      const [nameDoc, userDoc] = await Promise.all([transaction.get(nameRef), transaction.get(userRef)]);
+      if (nameDoc.exists && nameDoc.data().uid !== uid) throw new UsernameTakenError(username);
+
+      const previous = userDoc.data()?.username;
+      const previousKey = previous && normalize(previous);
+      if (previousKey && previousKey !== key) {
+        const previousRef = firestore.collection('usernames').doc(previousKey);
+        const previousDoc = await transaction.get(previousRef);
+        if (previousDoc.exists && previousDoc.data().uid === uid) transaction.delete(previousRef);
+      }
+
+      transaction.set(nameRef, { uid, username, claimedAt: admin.firestore.FieldValue.serverTimestamp() });
+      transaction.set(userRef, { username }, { merge: true });
+      return previous;
+    });
+
+    this.filter.add(key);
+    await redisClient.hSet(OWNERS_KEY, key, uid);
+    await redisClient.publish(ADDED_CHANNEL, [key]);
+    if (oldUsername && normalize(oldUsername) !== key) {
+      await redisClient.hDel(OWNERS_KEY, normalize(oldUsername));
+    }
+    console.log(`🔤 Username claimed: ${username} -> ${uid}`);
+    return oldUsername;
+  }
+}
+
+module.exports = new UsernameIndex();
+module.exports.UsernameTakenError = UsernameTakenError;
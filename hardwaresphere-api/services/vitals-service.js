@@ -0,0 +1,184 @@
+// Aggregates real-user performance metrics sent by the frontend
+// (lib/vitals.ts) into per-route, per-day histograms in Redis.
+//
+// Samples are never stored individually. Each one increments a log-scale
+// bucket (~10% wide), so any percentile can be read back within one bucket
+// of the true value, and storage stays constant per route and metric.
+//
+//   vitals:<day>:<route>:<metric>   hash  bucket -> count
+//   vitals:<day>:index              set   "<route>|<metric>" seen that day
+
+const redisClient = require('../config/redis');
+
+const METRICS = {
+  // max: largest accepted sample; good: p75 at or below this rates "good"
+  // (web.dev thresholds; MODEL_TTFF is our own budget).
+  LCP: { max: 120000, good: 2500 },
+  INP: { max: 60000, good: 200 },
+  CLS: { max: 10, good: 0.1, scale: 1000 }, // unitless; stored as thousandths
+  TTFB: { max: 60000, good: 800 },
+  MODEL_TTFF: { max: 300000, good: 3000 }
+};
+
+const BUCKET_GROWTH = 1.1;
+const RETENTION_SECONDS = 35 * 24 * 60 * 60;
+const MAX_ROUTES_PER_DAY = 200;
+const ROUTE_PATTERN = /^\/[A-Za-z0-9\-_/[\]]{0,99}$/;
+
+// A route regresses when its latest-day p75 is this much worse than the
+// baseline, with enough samples on both sides to mean something.
+const REGRESSION_RATIO = 1.2;
+const REGRESSION_MIN_SAMPLES = 50;
+
+const dayKey = (date) => date.toISOString().slice(0, 10);
+
+class VitalsService {
+  /**
+   * Drops malformed samples rather than rejecting the whole beacon.
+   * @param {Array} samples - [{ name, value, route }]
+   * @returns {Array} valid samples
+   */
+  sanitize(samples) {
+    if (!Array.isArray(samples)) return [];
+    return samples.slice(0, 50).filter(sample => {
+      const metric = METRICS[sample?.name];
+      return metric
+        && typeof sample.value === 'number'
+        && sample.value >= 0
+        && sample.value <= metric.max
+        && typeof sample.route === 'string'
+        && ROUTE_PATTERN.test(sample.route);
+    });
+  }
+
+  toBucket(name, value) {
+    const scaled = value * (METRICS[name].scale || 1);
+    return scaled < 1 ? 0 : Math.floor(Math.log(scaled) / Math.log(BUCKET_GROWTH)) + 1;
+  }
+
+  /** Upper bound of a bucket, in the metric's own unit. */
+  fromBucket(name, bucket) {
+    const scaled = bucket === 0 ? 1 : Math.pow(BUCKET_GROWTH, bucket);
+    return scaled / (METRICS[name].scale || 1);
+  }
+
+  async record(samples) {
+    const valid = this.sanitize(samples);
+    if (valid.length === 0) return 0;
+
+    const day = dayKey(new Date());
+    const indexKey = `vitals:${day}:index`;
+
+    // Group by route and metric so one beacon is one write per histogram.
+    const grouped = new Map();
+    valid.forEach(({ name, value, route }) => {
+      const series = `${route}|${name}`;
+      const buckets = grouped.get(series) || {};
+      const bucket = this.toBucket(name, value);
+      buckets[bucket] = (buckets[bucket] || 0) + 1;
+      grouped.set(series, buckets);
+    });
+
+    // New routes stop being tracked once a day's index is full, so junk
+    // paths can't grow Redis without bound.
+    const known = new Set(await redisClient.sMembers(indexKey));
+    let routeCount = known.size;
+    const writes = [];
+
+    for (const [series, buckets] of grouped) {
+      if (!known.has(series)) {
+        if (routeCount >= MAX_ROUTES_PER_DAY) continue;
+        routeCount++;
+        writes.push(redisClient.sAdd(indexKey, series, RETENTION_SECONDS));
+      }
+      const [route, name] = series.split('|');
+      writes.push(redisClient.hIncrByMany(`vitals:${day}:${route}:${name}`, buckets, RETENTION_SECONDS));
+    }
+
+    await Promise.all(writes);
+    return valid.length;
+  }
+
+  // --- Reading ---
+
+  async loadHistograms(days) {
+    const histograms = new Map(); // "route|metric" -> Map(day -> { bucket: count })
+
+    await Promise.all(days.map(async (day) => {
+      const series = await redisClient.sMembers(`vitals:${day}:index`);
+      await Promise.all(series.map(async (entry) => {
+        const [route, name] = entry.split('|');
+        const hash = await redisClient.hGetAll(`vitals:${day}:${route}:${name}`);
+        if (!hash) return;
+        if (!histograms.has(entry)) histograms.set(entry, new Map());
+        histograms.get(entry).set(day, hash);
+      }));
+    }));
+
+    return histograms;
+  }
+
+  summarize(name, hashes) {
+    const merged = new Map();
+    hashes.forEach(hash => {
+      Object.entries(hash).forEach(([bucket, count]) => {
+        merged.set(Number(bucket), (merged.get(Number(bucket)) || 0) + Number(count));
+      });
+    });
+
+    const buckets = [...merged].sort((a, b) => a[0] - b[0]);
+    const count = buckets.reduce((sum, [, n]) => sum + n, 0);
+    if (count === 0) return { count: 0 };
+
+    const percentile = (p) => {
+      const target = Math.ceil(count * p);
+      let seen = 0;
+      for (const [bucket, n] of buckets) {
+        seen += n;
+        if (seen >= target) return Math.round(this.fromBucket(name, bucket) * 1000) / 1000;
+      }
+      return null;
+    };
+
+    const p75 = percentile(0.75);
+    return {
+      count,
+      p50: percentile(0.5),
+      p75,
+      p95: percentile(0.95),
+      rating: p75 <= METRICS[name].good ? 'good' : 'needs-improvement'
+    };
+  }
+
+  /**
+   * Percentiles per route and metric over the last `days` days, plus the
+   * routes whose most recent day is notably worse than the days before.
+   */
+  async getSummary(days = 7) {
+    const now = Date.now();
+    const dayList = Array.from({ length: days }, (_, i) => dayKey(new Date(now - i * 86400000)));
+    const [latestDay, ...baselineDays] = dayList;
+    const histograms = await this.loadHistograms(dayList);
+
+    const routes = {};
+    const regressions = [];
+
+    for (const [series, byDay] of histograms) {
+      const [route, name] = series.split('|');
+      const overall = this.summarize(name, [...byDay.values()]);
+      (routes[route] ||= {})[name] = overall;
+
+      const latest = this.summarize(name, byDay.has(latestDay) ? [byDay.get(latestDay)] : []);
+      const baseline = this.summarize(name, baselineDays.filter(day => byDay.has(day)).map(day => byDay.get(day)));
+      if (latest.count >= REGRESSION_MIN_SAMPLES
+        && baseline.count >= REGRESSION_MIN_SAMPLES
+        && latest.p75 > baseline.p75 * REGRESSION_RATIO) {
+        regressions.push({ route, metric: name, p75: latest.p75, baselineP75: baseline.p75 });
+      }
+    }
+
+    return { from: dayList[dayList.length - 1], to: latestDay, routes, regressions };
+  }
+}
+
+module.exports = new VitalsService();
@@ -0,0 +1,71 @@
+'use client';
+
+import { useCallback, useEffect, useSyncExternalStore } from 'react';
+import {
+  ensureQuery,
+  getQueryState,
+  refetchQuery,
+  subscribeQuery,
+  type QueryOptions,
+  type QueryState,
+} from '@/lib/api';
+
+interface UseApiQueryOptions<T> extends QueryOptions<T> {
+  /** Skip fetching (e.g. until auth has loaded). */
+  enabled?: boolean;
+  /** Poll while mounted, e.g. during model conversion. */
+  refetchInterval?: number | false | ((data: T | undefined) => number | false);
+}
+
+const EMPTY: QueryState<never> = { data: undefined, error: null, updatedAt: 0, isFetching: false };
+
+/**
+ * Subscribes a component to a cached API resource (see lib/api.ts). Renders
+ * cached data immediately - even when stale - and refreshes it in the background.
+ */
+export function useApiQuery<T>(
+  query: { key: string; fetcher: () => Promise<T>; tags?: string[] } | null,
+  options: UseApiQueryOptions<T> = {}
+) {
+  const { enabled = true, refetchInterval = false, staleTime, initialData, initialDataUpdatedAt } = options;
+  const key = enabled && query ? query.key : null;
+
+  useEffect(() => {
+    if (!key || !query) return;
+    ensureQuery(key, query.fetcher, { tags: query.tags, staleTime, initialData, initialDataUpdatedAt });
+    // The query object is rebuilt every render; its key identifies it.
+    // eslint-disable-next-line react-hooks/exhaustive-deps
+  }, [key, staleTime]);
+
+  const subscribe = useCallback(
+    (onChange: () => void) => (key ? subscribeQuery(key, onChange) : () => {}),
+    [key]
+  );
+
+  const state = useSyncExternalStore(
+    subscribe,
+    () => (key ? getQueryState<T>(key) : EMPTY),
+    () => EMPTY
+  ) as QueryState<T>;
+
+  const data = state.data ?? initialData;
+  const interval = typeof refetchInterval === 'function' ? refetchInterval(data) : refetchInterval;
+
+  useEffect(() => {
+    if (!key || !interval) return;
+    const intervalId = setInterval(() => {
+      refetchQuery(key)?.catch(() => {});
+    }, interval);
+    return () => clearInterval(intervalId);
+  }, [key, interval]);
+
+  const refetch = useCallback(() => (key ? refetchQuery<T>(key) : undefined), [key]);
+
+  return {
+    data,
+    error: state.error,
+    isLoading: data === undefined && !state.error,
+    isFetching: state.isFetching,
+    refetch,
+  };
+}
@@ -0,0 +1,33 @@
+'use client';
+
+import { useCallback, useEffect, useRef } from 'react';
+import { prefetchProject } from '@/lib/prefetch';
+
+/**
+ * Wires a project card to lib/prefetch.ts: project JSON when the card nears
+ * the viewport, the model as well on hover or keyboard focus.
+ */
+export function useProjectPrefetch<T extends HTMLElement>(projectId: string) {
+  const ref = useRef<T>(null);
+
+  useEffect(() => {
+    const element = ref.current;
+    if (!element || typeof IntersectionObserver === 'undefined') return;
+
+    const observer = new IntersectionObserver(
+      (entries) => {
+        if (entries.some(entry => entry.isIntersecting)) {
+          prefetchProject(projectId, 'viewport');
+          observer.disconnect();
+        }
+      },
+      { rootMargin: '200px' }
+    );
+    observer.observe(element);
+    return () => observer.disconnect();
+  }, [projectId]);
+
+  const onIntent = useCallback(() => prefetchProject(projectId, 'intent'), [projectId]);
+
+  return { ref, onPointerEnter: onIntent, onFocus: onIntent };
+}
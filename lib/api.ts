@@ -1,26 +1,633 @@
+// lib/api.ts
+//
+// Client data layer for the HardwareSphere API. Every page goes through here
+// instead of hand-rolling fetch + token headers, so that:
+//   - concurrent requests for the same resource share one network call,
+//   - a resource fetched on one page (dashboard, profile, project) is reused
+//     on the next one, and refreshed in the background when stale,
+//   - mutations update or invalidate every cached view of what they changed.
+//
+// Server components use lib/server-api.ts instead.
+
+import { onAuthStateChanged } from 'firebase/auth';
 import { auth } from './firebase';
+import {
+  normalizeProfile,
+  withAuthor,
+  type ProjectData,
+  type PublicProfile,
+  type ProfileResponse,
+  type ProjectsPageResponse,
+} from '@/types/project';
 
 const API_URL = process.env.NEXT_PUBLIC_API_URL || 'http://localhost:3001';
 
-const getAuthToken = async () => {
+/** How long cached data is served without a background refresh. */
+const DEFAULT_STALE_TIME_MS = 30 * 1000;
+
+// --- Errors ---
+
+export class ApiError extends Error {
+  constructor(message: string, public status: number) {
+    super(message);
+    this.name = 'ApiError';
+  }
+}
+
+// --- Low-level request helper ---
+
+type AuthMode = 'none' | 'optional' | 'required';
+
+interface RequestOptions {
+  method?: 'GET' | 'POST' | 'PUT' | 'PATCH' | 'DELETE';
+  /** FormData is sent as-is; anything else is JSON-encoded. */
+  body?: FormData | object;
+  /** 'optional' attaches a token when signed in (owners see private data). */
+  auth?: AuthMode;
+  signal?: AbortSignal;
+}
+
+const getAuthToken = async (mode: AuthMode) => {
+  if (mode === 'none') return null;
+  // Firebase restores the session asynchronously; don't race it on page load.
+  await auth.authStateReady();
   const user = auth.currentUser;
-  if (!user) throw new Error('User not authenticated');
+  if (!user) {
+    if (mode === 'required') throw new ApiError('User not authenticated', 401);
+    return null;
+  }
   return await user.getIdToken();
 };
 
-export const getCurrentUser = async () => {
-  const token = await getAuthToken();
-  
-  const response = await fetch(`${API_URL}/api/auth/me`, {
-    headers: {
-      'Authorization': `Bearer ${token}`,
-      'Content-Type': 'application/json'
-    }
+export async function apiRequest<T>(path: string, options: RequestOptions = {}): Promise<T> {
+  const { method = 'GET', body, auth: authMode = 'optional', signal } = options;
+  const token = await getAuthToken(authMode);
+
+  const headers: Record<string, string> = {};
+  if (token) headers['Authorization'] = `Bearer ${token}`;
+  if (body && !(body instanceof FormData)) headers['Content-Type'] = 'application/json';
+
+  const response = await fetch(`${API_URL}${path}`, {
+    method,
+    headers,
+    body: body instanceof FormData ? body : body ? JSON.stringify(body) : undefined,
+    cache: 'no-store',
+    signal,
   });
 
   if (!response.ok) {
-    throw new Error('Failed to fetch user');
+    const errorData = await response.json().catch(() => ({}));
+    throw new ApiError(
+      errorData.error || errorData.message || `Request failed (${response.status})`,
+      response.status
+    );
+  }
+
+  return response.json() as Promise<T>;
+}
+
+// --- Query cache ---
+
+export interface QueryState<T> {
+  data: T | undefined;
+  error: Error | null;
+  updatedAt: number;
+  isFetching: boolean;
+}
+
+interface CacheEntry<T> {
+  state: QueryState<T>;
+  fetcher: () => Promise<T>;
+  /** Invalidation tags, e.g. project:<id> or user:<username>. */
+  tags: string[];
+  promise: Promise<T> | null;
+  /** Generation the in-flight promise was started for. */
+  promiseGeneration: number;
+  stale: boolean;
+  /** Bumped by invalidation; a response from an older generation is never cached as fresh. */
+  generation: number;
+}
+
+const EMPTY_STATE: QueryState<never> = { data: undefined, error: null, updatedAt: 0, isFetching: false };
+
+const entries = new Map<string, CacheEntry<any>>();
+// Kept apart from entries so components stay subscribed across cache resets.
+const listeners = new Map<string, Set<() => void>>();
+
+/** Canonical keys, so every page resolves a resource to the same cache entry. */
+export const queryKeys = {
+  me: () => 'me',
+  project: (id: string) => `project:${id}`,
+  profile: (username: string) => `profile:${username}`,
+  viewAnalytics: (range: AnalyticsRange) => `analytics:views:${range}`,
+};
+
+function getEntry<T>(key: string): CacheEntry<T> | undefined {
+  return entries.get(key);
+}
+
+function ensureEntry<T>(key: string, fetcher: () => Promise<T>, tags: string[]): CacheEntry<T> {
+  let entry = getEntry<T>(key);
+  if (!entry) {
+    entry = { state: EMPTY_STATE, fetcher, tags, promise: null, promiseGeneration: 0, stale: true, generation: 0 };
+    entries.set(key, entry);
+  } else {
+    // Latest caller wins; fetchers for a key are interchangeable.
+    entry.fetcher = fetcher;
+    entry.tags = tags;
+  }
+  return entry;
+}
+
+function notify(key: string) {
+  listeners.get(key)?.forEach(listener => listener());
+}
+
+const isObserved = (key: string) => (listeners.get(key)?.size ?? 0) > 0;
+
+function setState<T>(key: string, entry: CacheEntry<T>, patch: Partial<QueryState<T>>) {
+  // A new object per change, so useSyncExternalStore sees the update.
+  entry.state = { ...entry.state, ...patch };
+  notify(key);
+}
+
+function runFetch<T>(key: string, entry: CacheEntry<T>): Promise<T> {
+  // 🚀 OPTIMIZATION: In-flight dedup - everyone asking right now shares one request.
+  // FIX: ...unless it was invalidated since that request started; its response
+  // may predate the mutation, so a new request is made instead.
+  if (entry.promise && entry.promiseGeneration === entry.generation) return entry.promise;
+
+  const generation = entry.generation;
+  setState(key, entry, { isFetching: true });
+  const promise: Promise<T> = entry.fetcher()
+    .then(data => {
+      if (entries.get(key) !== entry) return data;
+      if (generation !== entry.generation) {
+        // Superseded: hand callers the post-invalidation result instead.
+        return runFetch(key, entry);
+      }
+      entry.stale = false;
+      setState(key, entry, { data, error: null, updatedAt: Date.now(), isFetching: entry.promise !== promise });
+      return data;
+    }, error => {
+      if (entries.get(key) === entry && generation === entry.generation) {
+        setState(key, entry, { error: error instanceof Error ? error : new Error(String(error)), isFetching: entry.promise !== promise });
+      }
+      throw error;
+    })
+    .finally(() => {
+      if (entry.promise === promise) entry.promise = null;
+    });
+
+  entry.promise = promise;
+  entry.promiseGeneration = generation;
+  return promise;
+}
+
+// Content version of cached data when it carries one (projects have updatedAt).
+const versionOf = (data: unknown): number => {
+  const updatedAt = (data as { updatedAt?: unknown } | null | undefined)?.updatedAt;
+  return typeof updatedAt === 'string' ? Date.parse(updatedAt) || 0 : 0;
+};
+
+const isFresh = (entry: CacheEntry<unknown>, staleTime: number) =>
+  !entry.stale && entry.state.updatedAt > 0 && Date.now() - entry.state.updatedAt < staleTime;
+
+export interface QueryOptions<T> {
+  tags?: string[];
+  staleTime?: number;
+  /** Server-rendered data; replaces cached data that is older (see ensureQuery). */
+  initialData?: T;
+  /** When initialData was fetched; defaults to now. */
+  initialDataUpdatedAt?: number;
+}
+
+/**
+ * Returns cached data when fresh; otherwise fetches (deduped). Stale data is
+ * not returned here - use the hook for stale-while-revalidate rendering.
+ */
+export function fetchQuery<T>(key: string, fetcher: () => Promise<T>, options: QueryOptions<T> = {}): Promise<T> {
+  watchAuth();
+  const { tags = [key], staleTime = DEFAULT_STALE_TIME_MS } = options;
+  const entry = ensureEntry(key, fetcher, tags);
+  if (isFresh(entry, staleTime)) return Promise.resolve(entry.state.data as T);
+  return runFetch(key, entry);
+}
+
+/**
+ * Registers a query for a subscriber. Cached data (even stale) is available
+ * immediately; a background refresh starts when it is missing or stale.
+ */
+export function ensureQuery<T>(key: string, fetcher: () => Promise<T>, options: QueryOptions<T> = {}) {
+  watchAuth();
+  const { tags = [key], staleTime = DEFAULT_STALE_TIME_MS, initialData, initialDataUpdatedAt } = options;
+  const entry = ensureEntry(key, fetcher, tags);
+
+  // FIX: An entry cached earlier (e.g. prefetched from a card long ago) only
+  // wins over the server's data when it is newer: by content version
+  // (updatedAt), then by when it was fetched - older signed URLs may be expired.
+  if (initialData !== undefined) {
+    const initialUpdatedAt = initialDataUpdatedAt ?? Date.now();
+    const cached = entry.state;
+    const initialVersion = versionOf(initialData);
+    const cachedVersion = versionOf(cached.data);
+    const useInitial = cached.data === undefined ||
+      initialVersion > cachedVersion ||
+      (initialVersion === cachedVersion && initialUpdatedAt > cached.updatedAt);
+    if (useInitial) {
+      // Invalidated entries stay stale: the server data may predate the mutation.
+      if (cached.updatedAt === 0) entry.stale = false;
+      entry.state = { ...cached, data: initialData, updatedAt: initialUpdatedAt };
+    }
+  }
+
+  if (!isFresh(entry, staleTime)) {
+    runFetch(key, entry).catch(() => {
+      // Surfaced through entry.state.error
+    });
+  }
+}
+
+export function refetchQuery<T>(key: string): Promise<T> | undefined {
+  const entry = getEntry<T>(key);
+  return entry ? runFetch(key, entry) : undefined;
+}
+
+export function getQueryState<T>(key: string): QueryState<T> {
+  return getEntry<T>(key)?.state ?? EMPTY_STATE;
+}
+
+export function subscribeQuery(key: string, listener: () => void) {
+  let keyListeners = listeners.get(key);
+  if (!keyListeners) {
+    keyListeners = new Set();
+    listeners.set(key, keyListeners);
+  }
+  keyListeners.add(listener);
+  return () => {
+    keyListeners.delete(listener);
+    if (keyListeners.size === 0) listeners.delete(key);
+  };
+}
+
+/** Optimistically replaces cached data (no-op when the key isn't cached). */
+export function setQueryData<T>(key: string, updater: (current: T) => T) {
+  const entry = getEntry<T>(key);
+  if (!entry || entry.state.data === undefined) return;
+  setState(key, entry, { data: updater(entry.state.data) });
+}
+
+/**
+ * Marks every entry carrying one of the tags as stale. Entries that are on
+ * screen refetch immediately; the rest refetch the next time they are used.
+ */
+export function invalidateTags(tags: string[]) {
+  entries.forEach((entry, key) => {
+    if (!entry.tags.some(tag => tags.includes(tag))) return;
+    entry.stale = true;
+    entry.generation++;
+    if (isObserved(key)) {
+      runFetch(key, entry).catch(() => {});
+    }
+  });
+}
+
+/** Drops all cached data; queries currently on screen start over. */
+export function clearQueryCache() {
+  const observed = [...entries].filter(([key]) => isObserved(key));
+  entries.clear();
+  observed.forEach(([key, { fetcher, tags }]) => {
+    // A fresh entry, so responses still in flight for the old one are ignored.
+    const entry = ensureEntry(key, fetcher, tags);
+    notify(key);
+    runFetch(key, entry).catch(() => {});
+  });
+}
+
+// The cache holds owner-only data (private projects), so it must never
+// survive a change of signed-in user.
+let authWatched = false;
+let lastUid: string | null | undefined;
+function watchAuth() {
+  if (authWatched || typeof window === 'undefined') return;
+  authWatched = true;
+  onAuthStateChanged(auth, user => {
+    const uid = user?.uid ?? null;
+    if (lastUid !== undefined && uid !== lastUid) {
+      clearQueryCache();
+    }
+    lastUid = uid;
+  });
+}
+
+// --- Normalized project updates ---
+
+const listsProject = (profile: PublicProfile, projectId: string) =>
+  profile.allProjects.some(p => p.id === projectId) || profile.pinnedProjects.some(p => p.id === projectId);
+
+/** Applies a change to a project wherever it is cached (project page and profile lists). */
+function patchProjectEverywhere(projectId: string, patch: (project: any) => any) {
+  setQueryData<ProjectData>(queryKeys.project(projectId), patch);
+  entries.forEach((entry, key) => {
+    if (!key.startsWith('profile:') || !entry.state.data) return;
+    const profile = entry.state.data as PublicProfile;
+    if (!listsProject(profile, projectId)) return;
+
+    const allProjects = profile.allProjects.map(p => (p.id === projectId ? patch(p) : p));
+    // Pinned state may have changed, so rebuild the pinned list from both sides.
+    const byId = new Map([...profile.pinnedProjects.map(p => (p.id === projectId ? patch(p) : p)), ...allProjects]
+      .map(p => [p.id, p] as const));
+    const pinnedProjects = [...byId.values()].filter(p => p.isPinned);
+
+    setState(key, entry, { data: { ...profile, allProjects, pinnedProjects } });
+  });
+}
+
+function snapshotProfiles() {
+  return [...entries]
+    .filter(([key]) => key.startsWith('profile:'))
+    .map(([key, entry]) => [key, entry.state.data] as const);
+}
+
+function restoreProfiles(snapshot: ReturnType<typeof snapshotProfiles>) {
+  snapshot.forEach(([key, data]) => {
+    const entry = entries.get(key);
+    if (entry) setState(key, entry, { data });
+  });
+}
+
+function removeProjectEverywhere(projectId: string) {
+  entries.delete(queryKeys.project(projectId));
+  entries.forEach((entry, key) => {
+    if (!key.startsWith('profile:')) return;
+    const profile = entry.state.data as PublicProfile | undefined;
+    if (!profile || !listsProject(profile, projectId)) return;
+    setState(key, entry, {
+      data: {
+        ...profile,
+        allProjects: profile.allProjects.filter(p => p.id !== projectId),
+        pinnedProjects: profile.pinnedProjects.filter(p => p.id !== projectId),
+        projectCount: profile.projectCount - 1,
+        stats: { ...profile.stats, totalProjects: profile.stats.totalProjects - 1 },
+      },
+    });
+  });
+}
+
+// --- Typed endpoints ---
+
+export const projectQuery = (id: string) => ({
+  key: queryKeys.project(id),
+  fetcher: () => apiRequest<ProjectData>(`/api/projects/${encodeURIComponent(id)}`),
+  tags: [`project:${id}`],
+});
+
+export const profileQuery = (username: string) => ({
+  key: queryKeys.profile(username),
+  fetcher: async () =>
+    normalizeProfile(await apiRequest<ProfileResponse>(`/api/users/${encodeURIComponent(username)}`)),
+  tags: [`user:${username}`],
+});
+
+const pageRequests = new Map<string, Promise<void>>();
+
+/**
+ * Appends the next page of a cached profile's projects. Concurrent calls
+ * (e.g. repeated scroll events) share one request.
+ */
+export function loadMoreProfileProjects(username: string): Promise<void> {
+  const key = queryKeys.profile(username);
+  const pending = pageRequests.get(key);
+  if (pending) return pending;
+
+  const profile = getQueryState<PublicProfile>(key).data;
+  if (!profile?.nextCursor) return Promise.resolve();
+
+  const cursor = profile.nextCursor;
+  const request = apiRequest<ProjectsPageResponse>(
+    `/api/users/${encodeURIComponent(username)}/projects?cursor=${encodeURIComponent(cursor)}`
+  )
+    .then(page => {
+      const entry = entries.get(key);
+      const current = entry?.state.data as PublicProfile | undefined;
+      // Ignore the page if the profile was refetched meanwhile.
+      if (!entry || current?.nextCursor !== cursor) return;
+      const seen = new Set(current.allProjects.map(p => p.id));
+      setState(key, entry, {
+        data: {
+          ...current,
+          allProjects: [...current.allProjects, ...withAuthor(page.projects, current).filter(p => !seen.has(p.id))],
+          nextCursor: page.nextCursor,
+        },
+      });
+    })
+    .finally(() => {
+      pageRequests.delete(key);
+    });
+
+  pageRequests.set(key, request);
+  return request;
+}
+
+export type AnalyticsRange = '1h' | '24h' | '7d' | '30d' | '90d';
+
+/** Pre-aggregated view counts; series[i] covers start + i * step seconds. */
+export interface ViewAnalytics {
+  range: AnalyticsRange;
+  resolution: 'minute' | 'hour' | 'day';
+  step: number;
+  start: number;
+  totals: number[];
+  projects: { id: string; title: string; total: number; series: number[] }[];
+}
+
+export const viewAnalyticsQuery = (range: AnalyticsRange) => ({
+  key: queryKeys.viewAnalytics(range),
+  fetcher: () => apiRequest<ViewAnalytics>(`/api/users/me/analytics/views?range=${range}`, { auth: 'required' }),
+  tags: ['me'],
+});
+
+export const currentUserQuery = () => ({
+  key: queryKeys.me(),
+  fetcher: () => apiRequest<any>('/api/auth/me', { auth: 'required' }),
+  tags: ['me'],
+});
+
+/** Pass fresh to bypass the cache, e.g. when polling conversion status. */
+export const getProject = (id: string, { fresh = false } = {}) => {
+  const { key, fetcher, tags } = projectQuery(id);
+  return fetchQuery(key, fetcher, { tags, staleTime: fresh ? 0 : undefined });
+};
+
+export const getProfile = (username: string) => {
+  const { key, fetcher, tags } = profileQuery(username);
+  return fetchQuery(key, fetcher, { tags });
+};
+
+export const getCurrentUser = () => {
+  const { key, fetcher, tags } = currentUserQuery();
+  return fetchQuery(key, fetcher, { tags });
+};
+
+export async function createProject(data: FormData) {
+  const result = await apiRequest<{ id: string }>('/api/projects', { method: 'POST', body: data, auth: 'required' });
+  // New project shows up in the owner's profile and dashboard.
+  invalidateTags(['me', ...profileTags()]);
+  return result;
+}
+
+export async function updateProject(projectId: string, data: FormData) {
+  const result = await apiRequest<ProjectData>(`/api/projects/${encodeURIComponent(projectId)}`, {
+    method: 'PUT',
+    body: data,
+    auth: 'required',
+  });
+  invalidateTags([`project:${projectId}`, ...profileTags(projectId)]);
+  return result;
+}
+
+export type ProjectFileOp =
+  | { op: 'remove'; target: string }
+  | { op: 'add'; file: 'bannerImage' | 'modelFile' | 'projectFiles'; name: string }
+  | { op: 'replace'; target: string; file: 'bannerImage' | 'modelFile' | 'projectFiles'; name: string };
+
+/**
+ * Partial update: `data` carries only changed `fields`, the `fileOps` to apply
+ * and the uploads they name. `skipped` lists uploads the API found unchanged.
+ */
+export async function patchProject(projectId: string, data: FormData) {
+  const result = await apiRequest<ProjectData & { skipped: string[] }>(`/api/projects/${encodeURIComponent(projectId)}`, {
+    method: 'PATCH',
+    body: data,
+    auth: 'required',
+  });
+  invalidateTags([`project:${projectId}`, ...profileTags(projectId)]);
+  return result;
+}
+
+export interface ProjectRevision {
+  id: string;
+  reason: 'update' | 'patch' | 'restore';
+  title?: string;
+  fileCount: number;
+  /** Bytes this revision added to storage, against totalBytes of files it covers. */
+  newBytes: number;
+  totalBytes: number;
+  createdAt: string;
+}
+
+export function listProjectRevisions(projectId: string) {
+  return apiRequest<{ revisions: ProjectRevision[] }>(`/api/projects/${encodeURIComponent(projectId)}/revisions`, {
+    auth: 'required',
+  });
+}
+
+export async function restoreProjectRevision(projectId: string, revisionId: string) {
+  const result = await apiRequest<ProjectData>(
+    `/api/projects/${encodeURIComponent(projectId)}/revisions/${encodeURIComponent(revisionId)}/restore`,
+    { method: 'POST', auth: 'required' }
+  );
+  invalidateTags([`project:${projectId}`, ...profileTags(projectId)]);
+  return result;
+}
+
+/** Optimistic: the project disappears from cached lists at once and comes back on failure. */
+export async function deleteProject(projectId: string) {
+  const snapshot = snapshotProfiles();
+  removeProjectEverywhere(projectId);
+  try {
+    const result = await apiRequest<{ message: string }>(`/api/projects/${encodeURIComponent(projectId)}`, {
+      method: 'DELETE',
+      auth: 'required',
+    });
+    invalidateTags(['me']);
+    return result;
+  } catch (error) {
+    restoreProfiles(snapshot);
+    throw error;
   }
+}
 
-  return response.json();
-};
\ No newline at end of file
+/** Optimistic, like deleteProject. */
+export async function toggleProjectPin(projectId: string) {
+  const toggle = (project: any) => ({ ...project, isPinned: !project.isPinned });
+  patchProjectEverywhere(projectId, toggle);
+  try {
+    return await apiRequest<{ success: boolean }>(
+      `/api/users/projects/${encodeURIComponent(projectId)}/toggle-pin`,
+      { method: 'POST', auth: 'required' }
+    );
+  } catch (error) {
+    patchProjectEverywhere(projectId, toggle);
+    throw error;
+  }
+}
+
+export function getProjectLiked(projectId: string) {
+  return apiRequest<{ liked: boolean }>(`/api/projects/${encodeURIComponent(projectId)}/like`, {
+    auth: 'required',
+  });
+}
+
+/** Optimistic: cached like counts move at once and move back on failure. */
+export async function setProjectLiked(projectId: string, liked: boolean) {
+  const adjust = (delta: number) => (project: any) => ({
+    ...project,
+    stats: { ...project.stats, likes: Math.max(0, (project.stats?.likes || 0) + delta) },
+  });
+  patchProjectEverywhere(projectId, adjust(liked ? 1 : -1));
+  try {
+    const result = await apiRequest<{ liked: boolean; changed: boolean }>(
+      `/api/projects/${encodeURIComponent(projectId)}/like`,
+      { method: liked ? 'POST' : 'DELETE', auth: 'required' }
+    );
+    // Already in that state server-side: the optimistic step was wrong.
+    if (!result.changed) patchProjectEverywhere(projectId, adjust(liked ? -1 : 1));
+    return result;
+  } catch (error) {
+    patchProjectEverywhere(projectId, adjust(liked ? -1 : 1));
+    throw error;
+  }
+}
+
+export function recordProjectView(projectId: string) {
+  return apiRequest<{ message: string }>(`/api/projects/${encodeURIComponent(projectId)}/view`, {
+    method: 'POST',
+    auth: 'none',
+  });
+}
+
+export async function checkUsername(username: string) {
+  return apiRequest<{
+    available: boolean;
+    isCurrentUser?: boolean;
+    reason?: 'taken' | 'reserved' | 'invalid';
+  }>('/api/users/username-check', {
+    method: 'POST',
+    body: { username },
+    auth: 'required',
+  });
+}
+
+export async function updateProfile(data: FormData) {
+  const result = await apiRequest<{ message: string; updatedProfile: any }>('/api/users/me', {
+    method: 'PUT',
+    body: data,
+    auth: 'required',
+  });
+  // Display name and avatar are copied onto every project card, so drop them all.
+  invalidateTags(['me', ...profileTags()]);
+  return result;
+}
+
+/** Tags of cached profiles, optionally only those listing a given project. */
+function profileTags(projectId?: string) {
+  const tags: string[] = [];
+  entries.forEach((entry, key) => {
+    if (!key.startsWith('profile:')) return;
+    const profile = entry.state.data as PublicProfile | undefined;
+    if (projectId && (!profile || !listsProject(profile, projectId))) return;
+    tags.push(...entry.tags);
+  });
+  return tags;
+}
@@ -0,0 +1,35 @@
+// /lib/image-loader.ts
+//
+// next/image loader (wired up in next.config.ts). Stored images are served
+// as signed Storage URLs at upload size (up to 1920px); this rewrites them
+// to the API's resize endpoint so each srcset entry is a real variant of
+// that width. Anything else (blob: previews, /public assets) passes through.
+
+import type { ImageLoaderProps } from 'next/image';
+
+const API_URL = process.env.NEXT_PUBLIC_API_URL || 'http://localhost:3001';
+
+// Must match ALLOWED_WIDTHS in hardwaresphere-api/services/image-service.js
+// and images.deviceSizes + images.imageSizes in next.config.ts.
+export const IMAGE_WIDTHS = [32, 64, 96, 128, 256, 384, 640, 828, 1080, 1200, 1920];
+
+const isStoredImage = (src: string) => src.startsWith('https://storage.googleapis.com/');
+
+/** Rounds up to the next width the API will generate. */
+export const snapWidth = (width: number) =>
+  IMAGE_WIDTHS.find(w => w >= width) ?? IMAGE_WIDTHS[IMAGE_WIDTHS.length - 1];
+
+export default function imageLoader({ src, width, quality }: ImageLoaderProps): string {
+  if (!isStoredImage(src)) return src;
+  const params = new URLSearchParams({ src, w: String(snapWidth(width)), q: String(quality || 75) });
+  return `${API_URL}/api/images?${params}`;
+}
+
+/**
+ * Resized URL for places that can't use next/image (e.g. Radix AvatarImage).
+ * Pass the rendered CSS width; it is doubled for high-density screens.
+ */
+export function resizedImageUrl(src: string | null | undefined, cssWidth: number): string | undefined {
+  if (!src) return undefined;
+  return imageLoader({ src, width: cssWidth * 2 });
+}
@@ -0,0 +1,84 @@
+// lib/model-prefetch.ts
+//
+// Small in-memory cache of GLB bytes fetched ahead of navigation (see
+// lib/prefetch.ts). The project page asks for a prefetched copy before
+// downloading the model itself.
+
+import { fetchModelBuffer } from '@/lib/three/fetch-model';
+
+/** Total bytes kept in memory; oldest models are evicted first. */
+const MAX_CACHE_BYTES = 64 * 1024 * 1024;
+
+interface CachedModel {
+  buffer: ArrayBuffer;
+  objectUrl: string | null;
+}
+
+// Map iteration order doubles as LRU order.
+const models = new Map<string, CachedModel>();
+const inFlight = new Map<string, Promise<void>>();
+let cachedBytes = 0;
+
+/**
+ * Signed storage URLs differ on every API response, so models are keyed by
+ * origin + path, which identifies the stored object.
+ */
+export const modelCacheKey = (url: string) => {
+  try {
+    const { origin, pathname } = new URL(url, typeof window !== 'undefined' ? window.location.href : undefined);
+    return `${origin}${pathname}`;
+  } catch {
+    return url;
+  }
+};
+
+function evict() {
+  for (const [key, model] of models) {
+    if (cachedBytes <= MAX_CACHE_BYTES) break;
+    if (model.objectUrl) URL.revokeObjectURL(model.objectUrl);
+    cachedBytes -= model.buffer.byteLength;
+    models.delete(key);
+  }
+}
+
+export function prefetchModel(url: string): Promise<void> {
+  const key = modelCacheKey(url);
+  if (models.has(key)) return Promise.resolve();
+
+  const pending = inFlight.get(key);
+  if (pending) return pending;
+
+  const promise = fetchModelBuffer(url)
+    .then(buffer => {
+      models.set(key, { buffer, objectUrl: null });
+      cachedBytes += buffer.byteLength;
+      evict();
+    })
+    .finally(() => {
+      inFlight.delete(key);
+    });
+
+  inFlight.set(key, promise);
+  return promise;
+}
+
+export const hasPrefetchedModel = (url: string) => models.has(modelCacheKey(url));
+
+/**
+ * A blob: URL for prefetched bytes, or null. Blob URLs work for both the R3F
+ * viewer and the worker viewer, so neither needs to know about this cache.
+ */
+export function getPrefetchedModelUrl(url: string): string | null {
+  const key = modelCacheKey(url);
+  const model = models.get(key);
+  if (!model) return null;
+
+  // Touch for LRU.
+  models.delete(key);
+  models.set(key, model);
+
+  if (!model.objectUrl) {
+    model.objectUrl = URL.createObjectURL(new Blob([model.buffer], { type: 'model/gltf-binary' }));
+  }
+  return model.objectUrl;
+}
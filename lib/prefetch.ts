@@ -0,0 +1,92 @@
+// lib/prefetch.ts
+//
+// Speculative loading for project cards: project JSON when a card scrolls
+// into view, and the model itself once the user shows intent (hover/focus),
+// so opening a project usually needs no network at all.
+
+import { getProject } from '@/lib/api';
+import { prefetchModel } from '@/lib/model-prefetch';
+
+type PrefetchReason = 'viewport' | 'intent';
+
+/** Parallel prefetches; kept low so they never compete with real requests. */
+const MAX_CONCURRENT = 2;
+/** Larger models are left to the project page's streaming loader. */
+const MAX_PREFETCH_MODEL_BYTES = 15 * 1024 * 1024;
+
+interface NetworkInformation {
+  saveData?: boolean;
+  effectiveType?: string;
+}
+
+type NetworkBudget = 'none' | 'data' | 'full';
+
+/** What the connection allows: nothing on data saver / 2G, JSON only on 3G. */
+function getNetworkBudget(): NetworkBudget {
+  if (typeof navigator === 'undefined') return 'none';
+  const connection = (navigator as Navigator & { connection?: NetworkInformation }).connection;
+  if (!connection) return 'full';
+  if (connection.saveData) return 'none';
+  if (connection.effectiveType === 'slow-2g' || connection.effectiveType === '2g') return 'none';
+  if (connection.effectiveType === '3g') return 'data';
+  return 'full';
+}
+
+// --- Concurrency-capped queue ---
+
+const queue: Array<{ key: string; run: () => Promise<unknown> }> = [];
+const queued = new Set<string>();
+const done = new Set<string>();
+let active = 0;
+
+function pump() {
+  while (active < MAX_CONCURRENT && queue.length > 0) {
+    const task = queue.shift()!;
+    active++;
+    task.run()
+      .then(() => done.add(task.key))
+      .catch(() => {
+        // Best effort; the page will fetch for real when opened.
+      })
+      .finally(() => {
+        active--;
+        queued.delete(task.key);
+        pump();
+      });
+  }
+}
+
+function enqueue(key: string, run: () => Promise<unknown>, urgent: boolean) {
+  if (done.has(key)) return;
+
+  if (queued.has(key)) {
+    // Intent outranks viewport: move a waiting task to the front.
+    const index = queue.findIndex(task => task.key === key);
+    if (urgent && index > 0) queue.unshift(...queue.splice(index, 1));
+    return;
+  }
+
+  queued.add(key);
+  if (urgent) queue.unshift({ key, run });
+  else queue.push({ key, run });
+  pump();
+}
+
+export function prefetchProject(projectId: string, reason: PrefetchReason) {
+  const budget = getNetworkBudget();
+  if (budget === 'none') return;
+
+  const urgent = reason === 'intent';
+  // Lands in the shared query cache, which the project page reads from.
+  enqueue(`project:${projectId}`, () => getProject(projectId), urgent);
+
+  if (!urgent || budget !== 'full') return;
+
+  enqueue(`model:${projectId}`, async () => {
+    const project = await getProject(projectId);
+    const glb = project.files.model?.glb;
+    if (!glb?.url || project.conversionStatus?.inProgress) return;
+    if (glb.size > MAX_PREFETCH_MODEL_BYTES) return;
+    await prefetchModel(glb.url);
+  }, true);
+}
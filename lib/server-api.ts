@@ -0,0 +1,75 @@
+// lib/server-api.ts
+//
+// Data access for React Server Components. Only public data is fetched here:
+// requests are anonymous, so private projects and owner-only fields are
+// loaded client-side with the user's token instead.
+
+import { cache } from "react";
+import { normalizeProfile, type ProjectData, type PublicProfile, type ProfileResponse } from "@/types/project";
+
+// Server-side calls can use a private, in-cluster URL when one is configured.
+const API_URL = process.env.API_URL || process.env.NEXT_PUBLIC_API_URL || "http://localhost:3001";
+
+/**
+ * Upper bound on how long a pre-rendered page is served before regenerating.
+ * The API calls /api/revalidate on every change, so this only has to cover
+ * the signed file URLs embedded in the payload (valid for 15 minutes).
+ */
+export const PAGE_REVALIDATE_SECONDS = 300;
+
+/** Cache tags passed to revalidateTag() by app/api/revalidate. */
+export const projectTag = (id: string) => `project:${id}`;
+export const userTag = (username: string) => `user:${username}`;
+
+// v4 signed URLs carry their signing time, e.g. X-Goog-Date=20250101T120000Z.
+function signedAt(url: string | undefined): number | null {
+  if (!url) return null;
+  try {
+    const match = new URL(url).searchParams.get("X-Goog-Date")?.match(/^(\d{4})(\d{2})(\d{2})T(\d{2})(\d{2})(\d{2})Z$/);
+    if (!match) return null;
+    const [, y, mo, d, h, mi, s] = match.map(Number);
+    return Date.UTC(y, mo - 1, d, h, mi, s);
+  } catch {
+    return null;
+  }
+}
+
+/**
+ * When the oldest signed URL in the payload was issued. The API may have
+ * served the project from its own cache, so this can be well before the fetch.
+ */
+function urlsIssuedAt(project: ProjectData): number {
+  const { model, thumbnail, attachments = [] } = project.files;
+  const times = [model?.glb?.url, model?.stl?.url, thumbnail?.url, ...attachments.map((file) => file.url)]
+    .map(signedAt)
+    .filter((time): time is number => time !== null);
+  return times.length > 0 ? Math.min(...times) : Date.now();
+}
+
+async function getJson<T>(path: string, tags: string[]): Promise<T | null> {
+  try {
+    // 🚀 OPTIMIZATION: Cached in the Next.js data cache so anonymous traffic is
+    // served from pre-rendered HTML instead of hitting the API and Firestore.
+    const response = await fetch(`${API_URL}${path}`, {
+      next: { revalidate: PAGE_REVALIDATE_SECONDS, tags },
+    });
+    if (!response.ok) return null;
+    return (await response.json()) as T;
+  } catch (error) {
+    console.error(`Server fetch failed for ${path}:`, error);
+    return null;
+  }
+}
+
+/** Public project, or null when it is missing or private. Deduped per request. */
+export const getPublicProject = cache(async (id: string): Promise<ProjectData | null> => {
+  const project = await getJson<ProjectData>(`/api/projects/${encodeURIComponent(id)}`, [projectTag(id)]);
+  if (!project || project.visibility === "private") return null;
+  return { ...project, fetchedAt: urlsIssuedAt(project) };
+});
+
+/** Public view of a profile (public projects only). Deduped per request. */
+export const getPublicProfile = cache(async (username: string): Promise<PublicProfile | null> => {
+  const data = await getJson<ProfileResponse>(`/api/users/${encodeURIComponent(username)}`, [userTag(username)]);
+  return data ? normalizeProfile(data) : null;
+});
@@ -0,0 +1,50 @@
+// /lib/three/fetch-model.ts
+//
+// Kept free of three.js imports so prefetching code can use it without
+// pulling the renderer into the page bundle.
+
+export interface LoadProgress {
+  loaded: number;
+  total: number;
+}
+
+/**
+ * Streams a model into memory, reporting progress as bytes arrive.
+ */
+export async function fetchModelBuffer(
+  url: string,
+  onProgress?: (progress: LoadProgress) => void,
+  signal?: AbortSignal
+): Promise<ArrayBuffer> {
+  const response = await fetch(url, { signal });
+  if (!response.ok) {
+    throw new Error(`Failed to download model (${response.status})`);
+  }
+
+  const total = Number(response.headers.get('content-length')) || 0;
+  if (!response.body) {
+    const buffer = await response.arrayBuffer();
+    onProgress?.({ loaded: buffer.byteLength, total: buffer.byteLength });
+    return buffer;
+  }
+
+  const reader = response.body.getReader();
+  const chunks: Uint8Array[] = [];
+  let loaded = 0;
+
+  while (true) {
+    const { done, value } = await reader.read();
+    if (done) break;
+    chunks.push(value);
+    loaded += value.byteLength;
+    onProgress?.({ loaded, total });
+  }
+
+  const bytes = new Uint8Array(loaded);
+  let offset = 0;
+  for (const chunk of chunks) {
+    bytes.set(chunk, offset);
+    offset += chunk.byteLength;
+  }
+  return bytes.buffer;
+}
@@ -0,0 +1,29 @@
+// /lib/three/offscreen-support.ts
+
+let cachedSupport: boolean | null = null;
+
+/**
+ * True when the browser can hand a canvas to a worker and create a WebGL2
+ * context on it. The result is cached because probing creates a context.
+ * Set NEXT_PUBLIC_OFFSCREEN_VIEWER=false to force the main-thread viewer.
+ */
+export function supportsOffscreenCanvas(): boolean {
+  if (cachedSupport !== null) return cachedSupport;
+  if (typeof window === 'undefined') return false;
+
+  if (process.env.NEXT_PUBLIC_OFFSCREEN_VIEWER === 'false') {
+    cachedSupport = false;
+    return cachedSupport;
+  }
+
+  try {
+    cachedSupport =
+      typeof Worker !== 'undefined' &&
+      typeof OffscreenCanvas !== 'undefined' &&
+      'transferControlToOffscreen' in HTMLCanvasElement.prototype &&
+      !!new OffscreenCanvas(1, 1).getContext('webgl2');
+  } catch {
+    cachedSupport = false;
+  }
+  return cachedSupport;
+}
@@ -0,0 +1,318 @@
+// /lib/three/viewer-core.ts
+//
+// Framework-free three.js viewer used wherever React Three Fiber is too heavy
+// or unavailable (e.g. inside a Web Worker rendering to an OffscreenCanvas).
+// It mirrors the scene set up by components/three/model-viewer.tsx so models
+// look the same whichever renderer path is taken.
+
+import * as THREE from 'three';
+import { GLTFLoader } from 'three/examples/jsm/loaders/GLTFLoader.js';
+import { DRACOLoader } from 'three/examples/jsm/loaders/DRACOLoader.js';
+import { OrbitControls } from 'three/examples/jsm/controls/OrbitControls.js';
+import { RoomEnvironment } from 'three/examples/jsm/environments/RoomEnvironment.js';
+import { fetchModelBuffer, type LoadProgress } from './fetch-model';
+
+export { fetchModelBuffer, type LoadProgress };
+
+// Same decoder location drei's useGLTF uses, so the main-thread viewer and
+// this one share the browser's HTTP cache for the Draco WASM.
+const DRACO_DECODER_PATH = 'https://www.gstatic.com/draco/versioned/decoders/1.5.5/';
+
+export type ClipAxis = 'X' | 'Y' | 'Z';
+
+export interface ViewerOptions {
+  autoRotate: boolean;
+  rotationSpeed: number;
+  wireframe: boolean;
+  clipping: boolean;
+  clipAxis: ClipAxis;
+  clipPosition: number;
+}
+
+export const DEFAULT_VIEWER_OPTIONS: ViewerOptions = {
+  autoRotate: false,
+  rotationSpeed: 0.5,
+  wireframe: false,
+  clipping: false,
+  clipAxis: 'X',
+  clipPosition: 0,
+};
+
+export interface ViewerCoreConfig {
+  width: number;
+  height: number;
+  pixelRatio: number;
+  /** Light the model with a generated room environment (no HDR download). */
+  environment?: boolean;
+  /** Called once, the first time a frame containing the model is drawn. */
+  onFirstFrame?: (msSinceLoadStart: number) => void;
+}
+
+export interface ModelStats {
+  triangles: number;
+  meshes: number;
+}
+
+/**
+ * Anything OrbitControls can attach its listeners to. On the main thread this
+ * is the canvas itself; in a worker it is a proxy fed with forwarded events.
+ */
+export type ControlsElement = HTMLElement;
+
+export class ViewerCore {
+  private renderer: THREE.WebGLRenderer;
+  private scene = new THREE.Scene();
+  private camera: THREE.PerspectiveCamera;
+  private controls: OrbitControls;
+  private modelGroup = new THREE.Group();
+  private model: THREE.Object3D | null = null;
+  private originalMaterials = new Map<string, THREE.Material | THREE.Material[]>();
+  private wireframeMaterial = new THREE.MeshBasicMaterial({ color: 'deepskyblue', wireframe: true });
+  private options: ViewerOptions = { ...DEFAULT_VIEWER_OPTIONS };
+  private clock = new THREE.Clock();
+  private frameHandle: number | null = null;
+  private needsRender = true;
+  private loadStartedAt = 0;
+  private firstFrameReported = false;
+  private disposed = false;
+  private config: ViewerCoreConfig;
+  private dracoLoader: DRACOLoader;
+
+  constructor(
+    canvas: HTMLCanvasElement | OffscreenCanvas,
+    controlsElement: ControlsElement,
+    config: ViewerCoreConfig
+  ) {
+    this.config = config;
+
+    this.renderer = new THREE.WebGLRenderer({
+      canvas,
+      antialias: true,
+      powerPreference: 'high-performance',
+    });
+    this.renderer.toneMapping = THREE.ACESFilmicToneMapping;
+    this.renderer.localClippingEnabled = true;
+    this.renderer.shadowMap.enabled = true;
+    this.renderer.shadowMap.type = THREE.PCFSoftShadowMap;
+    // OffscreenCanvas has no style to update, so never let three touch it.
+    this.renderer.setPixelRatio(Math.min(config.pixelRatio, 2));
+    this.renderer.setSize(config.width, config.height, false);
+
+    this.camera = new THREE.PerspectiveCamera(50, config.width / Math.max(config.height, 1), 0.1, 1000);
+    this.camera.position.set(0, 2, 10);
+
+    this.controls = new OrbitControls(this.camera, controlsElement);
+    this.controls.minDistance = 0.5;
+    this.controls.maxDistance = 50;
+    this.controls.enableDamping = true;
+    this.controls.dampingFactor = 0.05;
+    this.controls.saveState();
+    this.controls.addEventListener('change', () => {
+      this.needsRender = true;
+    });
+
+    this.dracoLoader = new DRACOLoader().setDecoderPath(DRACO_DECODER_PATH);
+
+    this.setupLights(config.environment ?? true);
+    this.scene.add(this.modelGroup);
+    this.startLoop();
+  }
+
+  private setupLights(environment: boolean) {
+    this.scene.add(new THREE.HemisphereLight('#ffffff', '#444444', 0.2));
+    this.scene.add(new THREE.AmbientLight('#ffffff', 0.3));
+
+    const key = new THREE.DirectionalLight('#ffffff', 1.2);
+    key.position.set(5, 10, 7);
+    key.castShadow = true;
+    key.shadow.mapSize.set(2048, 2048);
+    key.shadow.camera.far = 50;
+    this.scene.add(key);
+
+    const fill = new THREE.DirectionalLight('#ffffff', 0.2);
+    fill.position.set(-5, -5, -5);
+    this.scene.add(fill);
+
+    if (environment) {
+      const pmrem = new THREE.PMREMGenerator(this.renderer);
+      this.scene.environment = pmrem.fromScene(new RoomEnvironment(), 0.04).texture;
+      pmrem.dispose();
+    }
+  }
+
+  /**
+   * Loads a GLB either from a URL (streamed) or from bytes that were already
+   * fetched elsewhere, e.g. prefetched on the main thread and transferred in.
+   */
+  async loadModel(
+    source: string | ArrayBuffer,
+    onProgress?: (progress: LoadProgress) => void
+  ): Promise<ModelStats> {
+    this.loadStartedAt = performance.now();
+    this.firstFrameReported = false;
+
+    const buffer = typeof source === 'string'
+      ? await fetchModelBuffer(source, onProgress)
+      : source;
+
+    if (this.disposed) throw new Error('Viewer disposed during load');
+
+    const loader = new GLTFLoader().setDRACOLoader(this.dracoLoader);
+    const gltf = await loader.parseAsync(buffer, '');
+
+    this.setModel(gltf.scene);
+    return this.getStats(gltf.scene);
+  }
+
+  private setModel(object: THREE.Object3D) {
+    if (this.model) {
+      this.modelGroup.remove(this.model);
+    }
+    this.originalMaterials.clear();
+
+    // Equivalent of drei's <Center>: move the bounding box centre to the origin.
+    const box = new THREE.Box3().setFromObject(object);
+    const center = box.getCenter(new THREE.Vector3());
+    object.position.sub(center);
+
+    this.model = object;
+    this.modelGroup.rotation.set(0, 0, 0);
+    this.modelGroup.add(object);
+    this.applyMaterialOptions();
+    this.needsRender = true;
+  }
+
+  private getStats(object: THREE.Object3D): ModelStats {
+    let triangles = 0;
+    let meshes = 0;
+    object.traverse((child) => {
+      if (child instanceof THREE.Mesh) {
+        meshes++;
+        const geometry = child.geometry as THREE.BufferGeometry;
+        const count = geometry.index ? geometry.index.count : geometry.attributes.position?.count ?? 0;
+        triangles += Math.floor(count / 3);
+      }
+    });
+    return { triangles, meshes };
+  }
+
+  setOptions(options: Partial<ViewerOptions>) {
+    const previous = this.options;
+    this.options = { ...previous, ...options };
+
+    if (
+      previous.wireframe !== this.options.wireframe ||
+      previous.clipping !== this.options.clipping ||
+      previous.clipAxis !== this.options.clipAxis ||
+      previous.clipPosition !== this.options.clipPosition
+    ) {
+      this.applyMaterialOptions();
+    }
+    this.needsRender = true;
+  }
+
+  private applyMaterialOptions() {
+    if (!this.model) return;
+
+    const { wireframe, clipping, clipAxis, clipPosition } = this.options;
+    const normal = clipAxis === 'X'
+      ? new THREE.Vector3(1, 0, 0)
+      : clipAxis === 'Y'
+        ? new THREE.Vector3(0, 1, 0)
+        : new THREE.Vector3(0, 0, 1);
+    const planes = clipping ? [new THREE.Plane(normal, -clipPosition)] : null;
+
+    this.model.traverse((child) => {
+      if (!(child instanceof THREE.Mesh)) return;
+
+      if (!this.originalMaterials.has(child.uuid)) {
+        this.originalMaterials.set(child.uuid, child.material);
+      }
+      child.castShadow = true;
+      child.receiveShadow = true;
+
+      const original = this.originalMaterials.get(child.uuid)!;
+      const materials = Array.isArray(original) ? original : [original];
+      [...materials, this.wireframeMaterial].forEach((mat) => {
+        mat.clippingPlanes = planes;
+        mat.clipIntersection = false;
+        mat.needsUpdate = true;
+      });
+
+      child.material = wireframe ? this.wireframeMaterial : original;
+    });
+  }
+
+  resize(width: number, height: number, pixelRatio: number) {
+    if (width === 0 || height === 0) return;
+    this.renderer.setPixelRatio(Math.min(pixelRatio, 2));
+    this.renderer.setSize(width, height, false);
+    this.camera.aspect = width / height;
+    this.camera.updateProjectionMatrix();
+    this.needsRender = true;
+  }
+
+  resetView() {
+    this.controls.reset();
+    this.needsRender = true;
+  }
+
+  private startLoop() {
+    const scope = globalThis as typeof globalThis & {
+      requestAnimationFrame?: (cb: FrameRequestCallback) => number;
+    };
+    const schedule = scope.requestAnimationFrame
+      ? (cb: FrameRequestCallback) => scope.requestAnimationFrame!(cb)
+      : (cb: FrameRequestCallback) => setTimeout(() => cb(performance.now()), 16) as unknown as number;
+
+    const tick = () => {
+      if (this.disposed) return;
+      const delta = this.clock.getDelta();
+
+      if (this.model && this.options.autoRotate) {
+        this.modelGroup.rotation.y += delta * this.options.rotationSpeed * 0.25;
+        this.needsRender = true;
+      }
+
+      // update() returns true while damping is still settling.
+      if (this.controls.update(delta)) {
+        this.needsRender = true;
+      }
+
+      // 🚀 OPTIMIZATION: Render on demand - an idle model costs no GPU time.
+      if (this.needsRender) {
+        this.renderer.render(this.scene, this.camera);
+        this.needsRender = false;
+
+        if (this.model && !this.firstFrameReported) {
+          this.firstFrameReported = true;
+          this.config.onFirstFrame?.(performance.now() - this.loadStartedAt);
+        }
+      }
+
+      this.frameHandle = schedule(tick);
+    };
+
+    this.frameHandle = schedule(tick);
+  }
+
+  dispose() {
+    this.disposed = true;
+    if (this.frameHandle !== null) {
+      const scope = globalThis as typeof globalThis & { cancelAnimationFrame?: (id: number) => void };
+      scope.cancelAnimationFrame?.(this.frameHandle);
+    }
+    this.controls.dispose();
+    this.dracoLoader.dispose();
+    this.wireframeMaterial.dispose();
+    this.scene.environment?.dispose();
+    this.scene.traverse((child) => {
+      if (child instanceof THREE.Mesh) {
+        child.geometry.dispose();
+        const materials = Array.isArray(child.material) ? child.material : [child.material];
+        materials.forEach((mat) => mat.dispose());
+      }
+    });
+    this.renderer.dispose();
+  }
+}
@@ -0,0 +1,80 @@
+// /lib/three/viewer-protocol.ts
+//
+// Messages exchanged between the main thread and lib/three/viewer.worker.ts.
+
+import type { LoadProgress, ModelStats, ViewerOptions } from './viewer-core';
+
+/** The subset of DOM event fields OrbitControls reads. */
+export interface ForwardedEvent {
+  type: string;
+  pointerId?: number;
+  pointerType?: string;
+  button?: number;
+  buttons?: number;
+  clientX?: number;
+  clientY?: number;
+  pageX?: number;
+  pageY?: number;
+  deltaX?: number;
+  deltaY?: number;
+  deltaMode?: number;
+  ctrlKey?: boolean;
+  metaKey?: boolean;
+  shiftKey?: boolean;
+  altKey?: boolean;
+  key?: string;
+  code?: string;
+}
+
+export interface ElementRect {
+  left: number;
+  top: number;
+  width: number;
+  height: number;
+}
+
+export type ViewerWorkerRequest =
+  | {
+      type: 'init';
+      canvas: OffscreenCanvas;
+      rect: ElementRect;
+      pixelRatio: number;
+      environment: boolean;
+    }
+  | { type: 'load'; url?: string; buffer?: ArrayBuffer }
+  | { type: 'options'; options: Partial<ViewerOptions> }
+  | { type: 'resize'; rect: ElementRect; pixelRatio: number }
+  | { type: 'event'; event: ForwardedEvent }
+  | { type: 'reset' }
+  | { type: 'dispose' };
+
+export type ViewerWorkerResponse =
+  | { type: 'progress'; progress: LoadProgress }
+  | { type: 'loaded'; stats: ModelStats }
+  | { type: 'first-frame'; ms: number }
+  | { type: 'error'; message: string };
+
+const POINTER_KEYS = [
+  'pointerId', 'pointerType', 'button', 'buttons', 'clientX', 'clientY', 'pageX', 'pageY',
+  'ctrlKey', 'metaKey', 'shiftKey', 'altKey',
+] as const;
+const WHEEL_KEYS = ['deltaX', 'deltaY', 'deltaMode', 'clientX', 'clientY', 'ctrlKey', 'metaKey', 'shiftKey'] as const;
+const KEY_KEYS = ['key', 'code', 'ctrlKey', 'metaKey', 'shiftKey', 'altKey'] as const;
+
+/**
+ * Copies the fields OrbitControls needs out of a DOM event into a plain,
+ * structured-clone-friendly object.
+ */
+export function serializeEvent(event: Event): ForwardedEvent {
+  const keys = event.type === 'wheel'
+    ? WHEEL_KEYS
+    : event.type.startsWith('key')
+      ? KEY_KEYS
+      : POINTER_KEYS;
+
+  const data: Record<string, unknown> = { type: event.type };
+  for (const key of keys) {
+    data[key] = (event as unknown as Record<string, unknown>)[key];
+  }
+  return data as unknown as ForwardedEvent;
+}
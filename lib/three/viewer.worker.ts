@@ -0,0 +1,104 @@
+// /lib/three/viewer.worker.ts
+//
+// Dedicated worker that owns the whole three.js scene for the OffscreenCanvas
+// viewer. The main thread only forwards input and layout changes, so React
+// work on the page never competes with model parsing or rendering.
+
+import * as THREE from 'three';
+import { ViewerCore } from './viewer-core';
+import type { ElementRect, ForwardedEvent, ViewerWorkerRequest, ViewerWorkerResponse } from './viewer-protocol';
+
+const ctx = self as unknown as Worker;
+
+/**
+ * Stands in for the canvas element so OrbitControls can run without a DOM.
+ * It exposes the handful of properties and methods the controls touch and
+ * re-dispatches events received from the main thread.
+ */
+class ElementProxy extends THREE.EventDispatcher<Record<string, ForwardedEvent & { preventDefault(): void }>> {
+  style: Record<string, string> = {};
+  private rect: ElementRect = { left: 0, top: 0, width: 0, height: 0 };
+
+  get clientWidth() { return this.rect.width; }
+  get clientHeight() { return this.rect.height; }
+  get ownerDocument() { return this; }
+
+  setRect(rect: ElementRect) {
+    this.rect = rect;
+  }
+
+  getBoundingClientRect() {
+    const { left, top, width, height } = this.rect;
+    return { left, top, width, height, right: left + width, bottom: top + height, x: left, y: top };
+  }
+
+  getRootNode() { return this; }
+  setPointerCapture() {}
+  releasePointerCapture() {}
+  hasPointerCapture() { return false; }
+  focus() {}
+
+  handleEvent(event: ForwardedEvent) {
+    // preventDefault is applied on the main thread before forwarding.
+    this.dispatchEvent({ ...event, preventDefault() {}, stopPropagation() {} } as never);
+  }
+}
+
+const proxy = new ElementProxy();
+let viewer: ViewerCore | null = null;
+
+const post = (message: ViewerWorkerResponse) => ctx.postMessage(message);
+
+ctx.addEventListener('message', async (e: MessageEvent<ViewerWorkerRequest>) => {
+  const message = e.data;
+
+  switch (message.type) {
+    case 'init': {
+      proxy.setRect(message.rect);
+      viewer = new ViewerCore(message.canvas, proxy as unknown as HTMLElement, {
+        width: message.rect.width,
+        height: message.rect.height,
+        pixelRatio: message.pixelRatio,
+        environment: message.environment,
+        onFirstFrame: (ms) => post({ type: 'first-frame', ms }),
+      });
+      break;
+    }
+
+    case 'load': {
+      if (!viewer) return;
+      const source = message.buffer ?? message.url;
+      if (!source) return;
+      try {
+        const stats = await viewer.loadModel(source, (progress) => post({ type: 'progress', progress }));
+        post({ type: 'loaded', stats });
+      } catch (error) {
+        post({ type: 'error', message: error instanceof Error ? error.message : 'Failed to load model' });
+      }
+      break;
+    }
+
+    case 'options':
+      viewer?.setOptions(message.options);
+      break;
+
+    case 'resize':
+      proxy.setRect(message.rect);
+      viewer?.resize(message.rect.width, message.rect.height, message.pixelRatio);
+      break;
+
+    case 'event':
+      proxy.handleEvent(message.event);
+      break;
+
+    case 'reset':
+      viewer?.resetView();
+      break;
+
+    case 'dispose':
+      viewer?.dispose();
+      viewer = null;
+      (self as unknown as { close(): void }).close();
+      break;
+  }
+});
@@ -0,0 +1,70 @@
+// /lib/upload/compress-model.ts
+//
+// Main-thread side of the in-browser STL → Draco GLB conversion. Every failure
+// (old browser, ASCII STL, encoder download, timeout) resolves to null so the
+// caller simply uploads the raw STL and lets the API convert it as before.
+
+export interface StlToGlbRequest {
+  id: number;
+  stl: ArrayBuffer;
+}
+
+export type StlToGlbResponse =
+  | { id: number; ok: true; glb: ArrayBuffer; triangleCount: number; conversionTime: number }
+  | { id: number; ok: false; error: string };
+
+export interface CompressedModel {
+  file: File;
+  originalSize: number;
+  triangleCount: number;
+  conversionTime: number;
+}
+
+// Past this the browser tab is more likely to run out of memory than to help.
+const MAX_CLIENT_STL_BYTES = 150 * 1024 * 1024;
+const CONVERSION_TIMEOUT_MS = 60_000;
+
+let nextRequestId = 0;
+
+export async function compressStlToGlb(stl: File): Promise<CompressedModel | null> {
+  if (typeof Worker === 'undefined' || stl.size > MAX_CLIENT_STL_BYTES) return null;
+
+  // Classic worker: it loads the Draco encoder with importScripts.
+  const worker = new Worker(new URL('./stl-to-glb.worker.ts', import.meta.url));
+  const id = ++nextRequestId;
+
+  try {
+    const buffer = await stl.arrayBuffer();
+    const result = await new Promise<StlToGlbResponse>((resolve, reject) => {
+      const timer = setTimeout(() => reject(new Error('Conversion timed out')), CONVERSION_TIMEOUT_MS);
+      worker.onmessage = (e: MessageEvent<StlToGlbResponse>) => {
+        if (e.data.id !== id) return;
+        clearTimeout(timer);
+        resolve(e.data);
+      };
+      worker.onerror = (event) => {
+        clearTimeout(timer);
+        reject(new Error(event.message || 'Conversion worker crashed'));
+      };
+      worker.postMessage({ id, stl: buffer } satisfies StlToGlbRequest, [buffer]);
+    });
+
+    if (!result.ok) throw new Error(result.error);
+
+    // Not worth it if Draco could not beat the original.
+    if (result.glb.byteLength >= stl.size) return null;
+
+    const name = stl.name.replace(/\.stl$/i, '') + '.glb';
+    return {
+      file: new File([result.glb], name, { type: 'model/gltf-binary' }),
+      originalSize: stl.size,
+      triangleCount: result.triangleCount,
+      conversionTime: result.conversionTime,
+    };
+  } catch (error) {
+    console.warn('In-browser STL compression skipped:', error);
+    return null;
+  } finally {
+    worker.terminate();
+  }
+}
@@ -0,0 +1,10 @@
+// /lib/upload/hash-file.ts
+//
+// SHA-256 of an upload, hex encoded. Matches the contentHash the API stores
+// for every file (FileService.hashFile), so the edit page can tell when a
+// "new" file is byte-identical to the one already on the project.
+
+export async function hashFile(file: Blob): Promise<string> {
+  const digest = await crypto.subtle.digest('SHA-256', await file.arrayBuffer());
+  return Array.from(new Uint8Array(digest), byte => byte.toString(16).padStart(2, '0')).join('');
+}
@@ -0,0 +1,36 @@
+// /lib/upload/image-resize.worker.ts
+//
+// Decodes, downscales and re-encodes an image on an OffscreenCanvas so large
+// phone photos never block the form while they are shrunk for upload.
+
+import type { ImageResizeRequest, ImageResizeResponse } from './resize-image';
+
+const post = (message: ImageResizeResponse) => (self as unknown as Worker).postMessage(message);
+
+self.addEventListener('message', async (e: MessageEvent<ImageResizeRequest>) => {
+  const { id, blob, maxWidth, quality } = e.data;
+
+  try {
+    const bitmap = await createImageBitmap(blob);
+    const scale = Math.min(1, maxWidth / bitmap.width);
+    const width = Math.max(1, Math.round(bitmap.width * scale));
+    const height = Math.max(1, Math.round(bitmap.height * scale));
+
+    const canvas = new OffscreenCanvas(width, height);
+    const ctx = canvas.getContext('2d');
+    if (!ctx) throw new Error('2D canvas is not available in this worker');
+
+    ctx.imageSmoothingEnabled = true;
+    ctx.imageSmoothingQuality = 'high';
+    ctx.drawImage(bitmap, 0, 0, width, height);
+    bitmap.close();
+
+    const output = await canvas.convertToBlob({ type: 'image/webp', quality });
+    // Browsers without a WebP encoder silently fall back to PNG.
+    if (output.type !== 'image/webp') throw new Error('WebP encoding is not supported');
+
+    post({ id, ok: true, blob: output, width, height });
+  } catch (error) {
+    post({ id, ok: false, error: error instanceof Error ? error.message : 'Image resize failed' });
+  }
+});
@@ -0,0 +1,70 @@
+// /lib/upload/model-preview.ts
+//
+// Main-thread side of the local model preview. One worker is kept alive while
+// the form is open; the file is read here and its bytes are transferred in.
+
+export const PREVIEWABLE_MODEL_EXTENSIONS = ['stl', 'obj', 'glb', 'gltf'];
+
+export interface ModelPreviewRequest {
+  id: number;
+  buffer: ArrayBuffer;
+  extension: string;
+}
+
+export type ModelPreviewResponse =
+  | {
+      id: number;
+      ok: true;
+      positions: Float32Array;
+      normals: Float32Array;
+      triangleCount: number;
+      dimensions: [number, number, number];
+    }
+  | { id: number; ok: false; error: string };
+
+export type ModelPreviewData = Extract<ModelPreviewResponse, { ok: true }>;
+
+let worker: Worker | null = null;
+let nextRequestId = 0;
+const pending = new Map<number, { resolve: (data: ModelPreviewData) => void; reject: (error: Error) => void }>();
+
+const getWorker = () => {
+  if (!worker) {
+    worker = new Worker(new URL('./model-preview.worker.ts', import.meta.url), { type: 'module' });
+    worker.onmessage = (e: MessageEvent<ModelPreviewResponse>) => {
+      const request = pending.get(e.data.id);
+      if (!request) return;
+      pending.delete(e.data.id);
+      if (e.data.ok) request.resolve(e.data);
+      else request.reject(new Error(e.data.error));
+    };
+    worker.onerror = (event) => {
+      pending.forEach(({ reject }) => reject(new Error(event.message || 'Preview worker crashed')));
+      pending.clear();
+      worker?.terminate();
+      worker = null;
+    };
+  }
+  return worker;
+};
+
+export async function parseModelPreview(file: File): Promise<ModelPreviewData> {
+  const extension = file.name.split('.').pop()?.toLowerCase() ?? '';
+  if (!PREVIEWABLE_MODEL_EXTENSIONS.includes(extension)) {
+    throw new Error(`Preview is not available for .${extension} files`);
+  }
+
+  const buffer = await file.arrayBuffer();
+  const id = ++nextRequestId;
+  return new Promise<ModelPreviewData>((resolve, reject) => {
+    pending.set(id, { resolve, reject });
+    getWorker().postMessage({ id, buffer, extension } satisfies ModelPreviewRequest, [buffer]);
+  });
+}
+
+/** Stops the preview worker; called when the form unmounts. */
+export function disposeModelPreviewWorker() {
+  worker?.terminate();
+  worker = null;
+  pending.clear();
+}
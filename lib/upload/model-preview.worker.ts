@@ -0,0 +1,103 @@
+// /lib/upload/model-preview.worker.ts
+//
+// Parses a locally selected model file off the main thread and hands back flat,
+// transferable geometry for an instant preview in the project form.
+
+import * as THREE from 'three';
+import { STLLoader } from 'three/examples/jsm/loaders/STLLoader.js';
+import { OBJLoader } from 'three/examples/jsm/loaders/OBJLoader.js';
+import { GLTFLoader } from 'three/examples/jsm/loaders/GLTFLoader.js';
+import { DRACOLoader } from 'three/examples/jsm/loaders/DRACOLoader.js';
+import type { ModelPreviewRequest, ModelPreviewResponse } from './model-preview';
+
+const DRACO_DECODER_PATH = 'https://www.gstatic.com/draco/versioned/decoders/1.5.5/';
+
+let dracoLoader: DRACOLoader | null = null;
+
+/** Flattens every mesh in the object into one non-indexed, world-space geometry. */
+function flattenObject(root: THREE.Object3D): THREE.BufferGeometry {
+  root.updateMatrixWorld(true);
+  const parts: THREE.BufferGeometry[] = [];
+
+  root.traverse((child) => {
+    if (!(child instanceof THREE.Mesh)) return;
+    let geometry = (child.geometry as THREE.BufferGeometry).clone();
+    if (geometry.index) geometry = geometry.toNonIndexed();
+    geometry.applyMatrix4(child.matrixWorld);
+    parts.push(geometry);
+  });
+
+  const vertexCount = parts.reduce((sum, g) => sum + g.attributes.position.count, 0);
+  const positions = new Float32Array(vertexCount * 3);
+  let offset = 0;
+  for (const part of parts) {
+    const attr = part.attributes.position;
+    for (let i = 0; i < attr.count; i++, offset += 3) {
+      positions[offset] = attr.getX(i);
+      positions[offset + 1] = attr.getY(i);
+      positions[offset + 2] = attr.getZ(i);
+    }
+    part.dispose();
+  }
+
+  const merged = new THREE.BufferGeometry();
+  merged.setAttribute('position', new THREE.BufferAttribute(positions, 3));
+  return merged;
+}
+
+async function parseModel(buffer: ArrayBuffer, extension: string): Promise<THREE.BufferGeometry> {
+  switch (extension) {
+    case 'stl':
+      return new STLLoader().parse(buffer);
+
+    case 'obj': {
+      const text = new TextDecoder().decode(buffer);
+      return flattenObject(new OBJLoader().parse(text));
+    }
+
+    case 'glb':
+    case 'gltf': {
+      if (!dracoLoader) dracoLoader = new DRACOLoader().setDecoderPath(DRACO_DECODER_PATH);
+      const gltf = await new GLTFLoader().setDRACOLoader(dracoLoader).parseAsync(buffer, '');
+      return flattenObject(gltf.scene);
+    }
+
+    default:
+      throw new Error(`Preview is not available for .${extension} files`);
+  }
+}
+
+const post = (message: ModelPreviewResponse, transfer: Transferable[] = []) =>
+  (self as unknown as Worker).postMessage(message, transfer);
+
+self.addEventListener('message', async (e: MessageEvent<ModelPreviewRequest>) => {
+  const { id, buffer, extension } = e.data;
+
+  try {
+    let geometry = await parseModel(buffer, extension);
+    if (geometry.index) geometry = geometry.toNonIndexed();
+    geometry.computeVertexNormals();
+    geometry.computeBoundingBox();
+
+    const positionAttr = geometry.attributes.position;
+    if (!positionAttr || positionAttr.count === 0) {
+      throw new Error('The file does not contain any geometry');
+    }
+
+    const box = geometry.boundingBox!;
+    const size = box.getSize(new THREE.Vector3());
+    const positions = positionAttr.array as Float32Array;
+    const normals = geometry.attributes.normal.array as Float32Array;
+
+    post({
+      id,
+      ok: true,
+      positions,
+      normals,
+      triangleCount: Math.floor(positionAttr.count / 3),
+      dimensions: [size.x, size.y, size.z],
+    }, [positions.buffer, normals.buffer]);
+  } catch (error) {
+    post({ id, ok: false, error: error instanceof Error ? error.message : 'Failed to read model' });
+  }
+});
@@ -0,0 +1,104 @@
+// /lib/upload/resize-image.ts
+//
+// Shrinks images to the size the API stores them at before they are uploaded.
+// The presets mirror compressUserImage (routes/users.js) and uploadBannerImage
+// (services/file-service.js); the API skips re-encoding a WebP that is already
+// within its target width.
+
+export interface ImageResizeRequest {
+  id: number;
+  blob: Blob;
+  maxWidth: number;
+  quality: number;
+}
+
+export type ImageResizeResponse =
+  | { id: number; ok: true; blob: Blob; width: number; height: number }
+  | { id: number; ok: false; error: string };
+
+export const IMAGE_PRESETS = {
+  avatar: { maxWidth: 400, quality: 0.85 },
+  background: { maxWidth: 1920, quality: 0.75 },
+  banner: { maxWidth: 1200, quality: 0.8 },
+} as const;
+
+export type ImagePreset = keyof typeof IMAGE_PRESETS;
+
+let worker: Worker | null = null;
+let workerUnavailable = false;
+let nextRequestId = 0;
+
+const canResizeInWorker = () =>
+  !workerUnavailable &&
+  typeof Worker !== 'undefined' &&
+  typeof OffscreenCanvas !== 'undefined' &&
+  typeof createImageBitmap !== 'undefined';
+
+function resizeInWorker(file: File, maxWidth: number, quality: number): Promise<Blob> {
+  if (!worker) {
+    worker = new Worker(new URL('./image-resize.worker.ts', import.meta.url), { type: 'module' });
+  }
+  const activeWorker = worker;
+  const id = ++nextRequestId;
+
+  return new Promise((resolve, reject) => {
+    const onMessage = (e: MessageEvent<ImageResizeResponse>) => {
+      if (e.data.id !== id) return;
+      activeWorker.removeEventListener('message', onMessage);
+      if (e.data.ok) resolve(e.data.blob);
+      else reject(new Error(e.data.error));
+    };
+    activeWorker.addEventListener('message', onMessage);
+    activeWorker.onerror = (event) => {
+      workerUnavailable = true;
+      activeWorker.terminate();
+      worker = null;
+      reject(new Error(event.message || 'Image worker crashed'));
+    };
+    activeWorker.postMessage({ id, blob: file, maxWidth, quality } satisfies ImageResizeRequest);
+  });
+}
+
+// Fallback for browsers without OffscreenCanvas (or without WebP encoding in workers).
+async function resizeOnMainThread(file: File, maxWidth: number, quality: number): Promise<Blob> {
+  const bitmap = await createImageBitmap(file);
+  const scale = Math.min(1, maxWidth / bitmap.width);
+  const canvas = document.createElement('canvas');
+  canvas.width = Math.max(1, Math.round(bitmap.width * scale));
+  canvas.height = Math.max(1, Math.round(bitmap.height * scale));
+
+  const ctx = canvas.getContext('2d');
+  if (!ctx) throw new Error('2D canvas is not available');
+  ctx.imageSmoothingQuality = 'high';
+  ctx.drawImage(bitmap, 0, 0, canvas.width, canvas.height);
+  bitmap.close();
+
+  const blob = await new Promise<Blob | null>(resolve => canvas.toBlob(resolve, 'image/webp', quality));
+  if (!blob || blob.type !== 'image/webp') throw new Error('WebP encoding is not supported');
+  return blob;
+}
+
+/**
+ * Returns a WebP no wider than the preset, or the original file when resizing
+ * is not possible or would not make the upload smaller.
+ */
+export async function resizeImageForUpload(file: File, preset: ImagePreset): Promise<File> {
+  if (typeof window === 'undefined' || !file.type.startsWith('image/')) return file;
+
+  const { maxWidth, quality } = IMAGE_PRESETS[preset];
+
+  let blob: Blob;
+  try {
+    blob = canResizeInWorker()
+      ? await resizeInWorker(file, maxWidth, quality).catch(() => resizeOnMainThread(file, maxWidth, quality))
+      : await resizeOnMainThread(file, maxWidth, quality);
+  } catch (error) {
+    console.warn(`Image resize skipped for ${file.name}:`, error);
+    return file;
+  }
+
+  if (blob.size >= file.size && file.type === 'image/webp') return file;
+
+  const name = file.name.replace(/\.[^.]+$/, '') + '.webp';
+  return new File([blob], name, { type: 'image/webp', lastModified: Date.now() });
+}
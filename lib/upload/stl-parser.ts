@@ -0,0 +1,114 @@
+// /lib/upload/stl-parser.ts
+//
+// Typed-array port of ConversionService.parseStlWithColor / scaleAndCenterVertices
+// (hardwaresphere-api/services/conversion-service.js). Keep the two in step:
+// a GLB converted in the browser must look exactly like one converted on the server.
+
+export interface StlMesh {
+  positions: Float32Array;
+  normals: Float32Array;
+  colors: Float32Array | null;
+  triangleCount: number;
+}
+
+const HEADER_BYTES = 84;
+const TRIANGLE_BYTES = 50;
+const DEFAULT_GREY = 0.7;
+
+/**
+ * True when the buffer is a well-formed binary STL (the triangle count in the
+ * header agrees with the file size). ASCII STLs fail this check.
+ */
+export function isBinaryStl(buffer: ArrayBuffer): boolean {
+  if (buffer.byteLength < HEADER_BYTES) return false;
+  const triangleCount = new DataView(buffer).getUint32(80, true);
+  return buffer.byteLength === HEADER_BYTES + triangleCount * TRIANGLE_BYTES;
+}
+
+export function parseBinaryStl(buffer: ArrayBuffer): StlMesh {
+  if (!isBinaryStl(buffer)) {
+    throw new Error('Only binary STL files can be converted in the browser');
+  }
+
+  const view = new DataView(buffer);
+  const triangleCount = view.getUint32(80, true);
+  const positions = new Float32Array(triangleCount * 9);
+  const normals = new Float32Array(triangleCount * 9);
+  const colors = new Float32Array(triangleCount * 9);
+  let hasColor = false;
+
+  let offset = HEADER_BYTES;
+  for (let i = 0; i < triangleCount; i++, offset += TRIANGLE_BYTES) {
+    const base = i * 9;
+    const nx = view.getFloat32(offset, true);
+    const ny = view.getFloat32(offset + 4, true);
+    const nz = view.getFloat32(offset + 8, true);
+
+    for (let v = 0; v < 3; v++) {
+      const src = offset + 12 + v * 12;
+      const dst = base + v * 3;
+      positions[dst] = view.getFloat32(src, true);
+      positions[dst + 1] = view.getFloat32(src + 4, true);
+      positions[dst + 2] = view.getFloat32(src + 8, true);
+      normals[dst] = nx;
+      normals[dst + 1] = ny;
+      normals[dst + 2] = nz;
+    }
+
+    // Same colour heuristics as the server parser (BGR555 with an RGB fallback).
+    const attribute = view.getUint16(offset + 48, true);
+    let r = DEFAULT_GREY, g = DEFAULT_GREY, b = DEFAULT_GREY;
+
+    if ((attribute & 0x8000) !== 0) {
+      hasColor = true;
+      b = ((attribute >> 10) & 0x1f) / 31;
+      g = ((attribute >> 5) & 0x1f) / 31;
+      r = (attribute & 0x1f) / 31;
+      if ((r + g + b) / 3 < 0.1) {
+        [r, b] = [b, r];
+      }
+    } else if (attribute !== 0) {
+      const cb = ((attribute >> 10) & 0x1f) / 31;
+      const cg = ((attribute >> 5) & 0x1f) / 31;
+      const cr = (attribute & 0x1f) / 31;
+      if (cr > 0.05 || cg > 0.05 || cb > 0.05) {
+        hasColor = true;
+        r = cr; g = cg; b = cb;
+      }
+    }
+
+    for (let v = 0; v < 3; v++) {
+      colors[base + v * 3] = r;
+      colors[base + v * 3 + 1] = g;
+      colors[base + v * 3 + 2] = b;
+    }
+  }
+
+  scaleAndCenter(positions);
+
+  return { positions, normals, colors: hasColor ? colors : null, triangleCount };
+}
+
+/** Centres the mesh on the origin and scales its largest dimension to 10 units, in place. */
+function scaleAndCenter(positions: Float32Array) {
+  if (positions.length === 0) return;
+
+  let minX = Infinity, minY = Infinity, minZ = Infinity;
+  let maxX = -Infinity, maxY = -Infinity, maxZ = -Infinity;
+  for (let i = 0; i < positions.length; i += 3) {
+    const x = positions[i], y = positions[i + 1], z = positions[i + 2];
+    if (x < minX) minX = x; if (x > maxX) maxX = x;
+    if (y < minY) minY = y; if (y > maxY) maxY = y;
+    if (z < minZ) minZ = z; if (z > maxZ) maxZ = z;
+  }
+
+  const maxDimension = Math.max(maxX - minX, maxY - minY, maxZ - minZ);
+  const scale = maxDimension > 0 ? 10 / maxDimension : 1;
+  const cx = (minX + maxX) / 2, cy = (minY + maxY) / 2, cz = (minZ + maxZ) / 2;
+
+  for (let i = 0; i < positions.length; i += 3) {
+    positions[i] = (positions[i] - cx) * scale;
+    positions[i + 1] = (positions[i + 1] - cy) * scale;
+    positions[i + 2] = (positions[i + 2] - cz) * scale;
+  }
+}
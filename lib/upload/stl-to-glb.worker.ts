@@ -0,0 +1,104 @@
+// /lib/upload/stl-to-glb.worker.ts
+//
+// Converts a binary STL into the same Draco-compressed GLB the API produces in
+// ConversionService.convertStlToGltf, so the upload can skip the raw STL.
+
+import { Document, WebIO } from '@gltf-transform/core';
+import { KHRDracoMeshCompression } from '@gltf-transform/extensions';
+import { parseBinaryStl, type StlMesh } from './stl-parser';
+import type { StlToGlbRequest, StlToGlbResponse } from './compress-model';
+
+// three.js ships the Emscripten encoder as a classic script, loaded once per
+// worker with importScripts (this is a classic worker, see compress-model.ts).
+// FIX: Served from our own origin - scripts/copy-draco.mjs copies it out of
+// node_modules on install - and never string-evaluated, so it works under a
+// CSP without 'unsafe-eval'.
+const DRACO_ENCODER_URL = '/draco/draco_encoder.js';
+
+interface ClassicWorkerScope {
+  importScripts(...urls: string[]): void;
+  DracoEncoderModule?: () => Promise<unknown>;
+}
+
+let encoderModule: Promise<unknown> | null = null;
+
+const loadEncoder = () => {
+  if (!encoderModule) {
+    encoderModule = new Promise<unknown>((resolve, reject) => {
+      const scope = self as unknown as ClassicWorkerScope;
+      if (!scope.DracoEncoderModule) scope.importScripts(DRACO_ENCODER_URL);
+      if (!scope.DracoEncoderModule) throw new Error('Failed to load Draco encoder');
+      scope.DracoEncoderModule().then(resolve, reject);
+    });
+    encoderModule.catch(() => { encoderModule = null; });
+  }
+  return encoderModule;
+};
+
+function createDocument(mesh: StlMesh): Document {
+  const document = new Document();
+  const buffer = document.createBuffer();
+
+  const indices = new Uint32Array(mesh.triangleCount * 3);
+  for (let i = 0; i < indices.length; i++) indices[i] = i;
+
+  const prim = document.createPrimitive()
+    .setAttribute('POSITION', document.createAccessor('POSITION').setArray(mesh.positions).setType('VEC3').setBuffer(buffer))
+    .setAttribute('NORMAL', document.createAccessor('NORMAL').setArray(mesh.normals).setType('VEC3').setBuffer(buffer))
+    .setIndices(document.createAccessor('INDICES').setArray(indices).setType('SCALAR').setBuffer(buffer));
+
+  if (mesh.colors) {
+    prim.setAttribute('COLOR_0', document.createAccessor('COLOR_0').setArray(mesh.colors).setType('VEC3').setBuffer(buffer));
+  }
+
+  prim.setMaterial(
+    document.createMaterial('DefaultMaterial')
+      .setBaseColorFactor([1, 1, 1, 1])
+      .setMetallicFactor(0.1)
+      .setRoughnessFactor(0.8)
+      .setDoubleSided(true)
+  );
+
+  const node = document.createNode('MeshNode').setMesh(document.createMesh('Mesh').addPrimitive(prim));
+  document.createScene('DefaultScene').addChild(node);
+
+  // Same encoder settings as the server-side draco() transform.
+  document.createExtension(KHRDracoMeshCompression)
+    .setRequired(true)
+    .setEncoderOptions({
+      method: KHRDracoMeshCompression.EncoderMethod.EDGEBREAKER,
+      quantizationBits: { POSITION: 12, NORMAL: 8, COLOR_0: 8 },
+    });
+
+  return document;
+}
+
+const post = (message: StlToGlbResponse, transfer: Transferable[] = []) =>
+  (self as unknown as Worker).postMessage(message, transfer);
+
+self.addEventListener('message', async (e: MessageEvent<StlToGlbRequest>) => {
+  const { id, stl } = e.data;
+  const startedAt = performance.now();
+
+  try {
+    const mesh = parseBinaryStl(stl);
+    const [encoder, document] = await Promise.all([loadEncoder(), Promise.resolve(createDocument(mesh))]);
+
+    const io = new WebIO()
+      .registerExtensions([KHRDracoMeshCompression])
+      .registerDependencies({ 'draco3d.encoder': encoder });
+
+    const glb = await io.writeBinary(document);
+    const output = glb.buffer.slice(glb.byteOffset, glb.byteOffset + glb.byteLength) as ArrayBuffer;
+
+    post({
+      id,
+      ok: true,
+      glb: output,
+      triangleCount: mesh.triangleCount,
+      conversionTime: Math.round(performance.now() - startedAt),
+    }, [output]);
+  } catch (error) {
+    post({ id, ok: false, error: error instanceof Error ? error.message : 'Conversion failed' });
+  }
+});
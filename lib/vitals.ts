@@ -0,0 +1,68 @@
+// /lib/vitals.ts
+//
+// Real-user performance reporting. Metrics are queued and sent in one
+// sendBeacon when the page is hidden, so reporting never competes with the
+// page for the network. The API aggregates them per route (see
+// hardwaresphere-api/routes/vitals.js).
+
+const API_URL = process.env.NEXT_PUBLIC_API_URL || 'http://localhost:3001';
+const MAX_QUEUE = 50;
+
+export type VitalName = 'LCP' | 'INP' | 'CLS' | 'TTFB' | 'MODEL_TTFF';
+
+interface VitalSample {
+  name: VitalName;
+  value: number;
+  route: string;
+}
+
+// Dynamic segments are collapsed so every project or profile counts towards
+// one route. Order matters: the first match wins.
+const ROUTE_PATTERNS: [RegExp, string][] = [
+  // Static segments before the dynamic ones they would otherwise match (app/project/*)
+  [/^\/project\/create\/?$/, '/project/create'],
+  [/^\/project\/new-project\/?$/, '/project/new-project'],
+  [/^\/project\/edit\/[^/]+\/?$/, '/project/edit/[id]'],
+  [/^\/project\/[^/]+\/?$/, '/project/[id]'],
+  [/^\/user\/[^/]+\/?$/, '/user/[username]'],
+  [/^\/embed\/[^/]+\/?$/, '/embed/[id]'],
+];
+
+export function routeOf(pathname: string): string {
+  for (const [pattern, route] of ROUTE_PATTERNS) {
+    if (pattern.test(pathname)) return route;
+  }
+  return pathname.replace(/\/$/, '') || '/';
+}
+
+let queue: VitalSample[] = [];
+let listening = false;
+
+function flush() {
+  if (queue.length === 0) return;
+  const body = JSON.stringify({ metrics: queue });
+  queue = [];
+  // text/plain keeps the beacon a "simple" request, so no CORS preflight.
+  const blob = new Blob([body], { type: 'text/plain' });
+  if (!navigator.sendBeacon?.(`${API_URL}/api/vitals`, blob)) {
+    fetch(`${API_URL}/api/vitals`, { method: 'POST', body: blob, keepalive: true }).catch(() => {});
+  }
+}
+
+function listen() {
+  if (listening) return;
+  listening = true;
+  // pagehide covers bfcache navigations where visibilitychange may not fire.
+  document.addEventListener('visibilitychange', () => {
+    if (document.visibilityState === 'hidden') flush();
+  });
+  window.addEventListener('pagehide', flush);
+}
+
+/** Queues one measurement for `pathname` (defaults to the current page). */
+export function reportVital(name: VitalName, value: number, pathname?: string) {
+  if (typeof window === 'undefined' || !Number.isFinite(value) || value < 0) return;
+  listen();
+  queue.push({ name, value, route: routeOf(pathname ?? window.location.pathname) });
+  if (queue.length >= MAX_QUEUE) flush();
+}
@@ -12,8 +12,27 @@ const nextConfig: NextConfig = {
     optimizePackageImports: ['lucide-react'],
   },
   compress: true,
+  // 🚀 OPTIMIZATION: Uploaded images are resized by the API (GET /api/images);
+  // widths must stay in sync with lib/image-loader.ts.
+  images: {
+    loader: 'custom',
+    loaderFile: './lib/image-loader.ts',
+    deviceSizes: [640, 828, 1080, 1200, 1920],
+    imageSizes: [32, 64, 96, 128, 256, 384],
+  },
   transpilePackages: ['three'],
 
+  // /embed/* is meant to be iframed from makers' docs and READMEs.
+  async headers() {
+    return [
+      {
+        source: '/embed/:path*',
+        headers: [
+          { key: 'Content-Security-Policy', value: 'frame-ancestors *' },
+        ],
+      },
+    ];
+  },
 
 };
 
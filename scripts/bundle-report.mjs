@@ -0,0 +1,65 @@
+// scripts/bundle-report.mjs
+//
+// Compares the client JS shipped by the embed route against the full project
+// page. Run after `next build`:
+//
+//   npm run bundle:report
+//   npm run bundle:report -- /user/[username]/page   # extra routes to include
+
+import { readFileSync, existsSync, statSync } from 'node:fs';
+import { join } from 'node:path';
+import { gzipSync } from 'node:zlib';
+
+const NEXT_DIR = join(process.cwd(), '.next');
+const MANIFEST = join(NEXT_DIR, 'app-build-manifest.json');
+const ROUTES = ['/embed/[id]/page', '/project/[id]/page', ...process.argv.slice(2)];
+
+if (!existsSync(MANIFEST)) {
+  console.error('❌ .next/app-build-manifest.json not found - run `npm run build` first.');
+  process.exit(1);
+}
+
+const { pages } = JSON.parse(readFileSync(MANIFEST, 'utf8'));
+const gzipCache = new Map();
+
+const sizeOf = (file) => {
+  const path = join(NEXT_DIR, file);
+  if (!existsSync(path)) return { raw: 0, gzip: 0 };
+  if (!gzipCache.has(file)) {
+    gzipCache.set(file, { raw: statSync(path).size, gzip: gzipSync(readFileSync(path)).length });
+  }
+  return gzipCache.get(file);
+};
+
+const kb = (bytes) => `${(bytes / 1024).toFixed(1)} kB`;
+
+const rows = ROUTES.map((route) => {
+  const files = (pages[route] || []).filter((file) => file.endsWith('.js'));
+  const total = files.reduce(
+    (acc, file) => {
+      const { raw, gzip } = sizeOf(file);
+      return { raw: acc.raw + raw, gzip: acc.gzip + gzip };
+    },
+    { raw: 0, gzip: 0 }
+  );
+  return { route, chunks: files.length, ...total, missing: !pages[route] };
+});
+
+console.log('\n📦 First-load client JS per route\n');
+console.log(`${'Route'.padEnd(28)}${'Chunks'.padStart(8)}${'Raw'.padStart(12)}${'Gzip'.padStart(12)}`);
+for (const row of rows) {
+  if (row.missing) {
+    console.log(`${row.route.padEnd(28)}   (not in build)`);
+    continue;
+  }
+  console.log(
+    `${row.route.padEnd(28)}${String(row.chunks).padStart(8)}${kb(row.raw).padStart(12)}${kb(row.gzip).padStart(12)}`
+  );
+}
+
+const [embed, project] = rows;
+if (!embed.missing && !project.missing && project.gzip > 0) {
+  const ratio = ((embed.gzip / project.gzip) * 100).toFixed(0);
+  console.log(`\n✅ Embed ships ${ratio}% of the project page's gzipped JS.`);
+  console.log('   (Viewer worker chunks load separately and are not counted above.)\n');
+}
@@ -0,0 +1,32 @@
+// scripts/copy-draco.mjs
+//
+// Copies the Draco encoder that ships with three.js into public/draco/, so
+// the STL -> GLB worker (lib/upload/stl-to-glb.worker.ts) loads it from our
+// own origin instead of a script fetched from a CDN. Runs on install; the
+// version always matches the installed three.
+//
+//   npm run draco:copy          fails when the encoder is missing
+//   node scripts/copy-draco.mjs --optional
+//                               only warns (postinstall, so installs that
+//                               skip or prune three never fail here)
+
+import { copyFileSync, existsSync, mkdirSync } from 'node:fs';
+import { join } from 'node:path';
+
+const SOURCE = join(process.cwd(), 'node_modules/three/examples/jsm/libs/draco/draco_encoder.js');
+const TARGET_DIR = join(process.cwd(), 'public/draco');
+
+const optional = process.argv.includes('--optional');
+
+if (!existsSync(SOURCE)) {
+  if (optional) {
+    console.warn('⚠️ three/examples/jsm/libs/draco/draco_encoder.js not found - skipped; run `npm run draco:copy` once three is installed.');
+    process.exit(0);
+  }
+  console.error('❌ three/examples/jsm/libs/draco/draco_encoder.js not found - run `npm install` first.');
+  process.exit(1);
+}
+
+mkdirSync(TARGET_DIR, { recursive: true });
+copyFileSync(SOURCE, join(TARGET_DIR, 'draco_encoder.js'));
+console.log('📦 Copied draco_encoder.js to public/draco/');
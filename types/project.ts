@@ -0,0 +1,148 @@
+// types/project.ts
+// Shapes returned by the HardwareSphere API (hardwaresphere-api/routes).
+
+export type FileType = "model" | "code" | "documentation" | "video" | "other";
+
+export interface FileAttachment {
+  type: FileType;
+  url: string;
+  filename: string;
+  size: number;
+  storagePath?: string;
+  /** SHA-256 of the uploaded bytes; absent on files uploaded before it was recorded. */
+  contentHash?: string;
+}
+
+export interface ProjectData {
+  id: string;
+  title: string;
+  description: string;
+  tags: string[];
+  authorName: string;
+  authorAvatar?: string;
+  username: string;
+  userId: string;
+  visibility?: "public" | "private";
+  files: {
+    model?: {
+      glb?: { url: string; filename: string; size: number };
+      stl?: { url: string; filename: string; size: number };
+    };
+    thumbnail?: { url: string };
+    attachments?: Array<Omit<FileAttachment, "type"> & { type: string }>;
+  };
+  stats: {
+    views: number;
+    likes: number;
+  };
+  allowDownloads: boolean;
+  createdAt: string;
+  updatedAt?: string;
+  conversionStatus?: {
+    inProgress: boolean;
+    completed: boolean;
+    errors: any[];
+  };
+  /**
+   * Set by lib/server-api for payloads rendered into a cached page: when its
+   * signed URLs were issued, which the API cache can put before the fetch.
+   */
+  fetchedAt?: number;
+}
+
+// Firestore timestamps are serialised as { _seconds, _nanoseconds } in profile listings.
+export type ApiTimestamp = string | { _seconds: number; _nanoseconds: number };
+
+export interface ProfileProject {
+  id: string;
+  title: string;
+  files: { thumbnail?: { url: string } };
+  stats: { views: number; likes: number; downloads?: number };
+  isPinned?: boolean;
+  createdAt: ApiTimestamp;
+  visibility?: string;
+  authorName: string;
+  username: string;
+  authorAvatar?: string;
+}
+
+export interface PublicProfile {
+  id: string;
+  displayName: string;
+  username: string;
+  bio: string;
+  avatar?: string;
+  backgroundImage?: string;
+  github?: string;
+  linkedin?: string;
+  location?: string;
+  skills?: string[];
+  stats: { totalProjects: number; totalViews: number; totalLikes: number };
+  createdAt: string;
+  pinnedProjects: ProfileProject[];
+  /** Projects loaded so far, newest first (pinned ones included). */
+  allProjects: ProfileProject[];
+  /** Cursor for GET /api/users/:username/projects, or null on the last page. */
+  nextCursor: string | null;
+  /** Projects visible to this viewer, across all pages. */
+  projectCount: number;
+}
+
+type ProjectSummary = Omit<ProfileProject, "authorName" | "username" | "authorAvatar">;
+
+/** Raw /api/users/:username payload, before projects are decorated. */
+export interface ProfileResponse extends Omit<PublicProfile, "allProjects" | "pinnedProjects"> {
+  pinnedProjects: ProjectSummary[];
+  projects: ProjectSummary[];
+}
+
+/** Raw /api/users/:username/projects payload. */
+export interface ProjectsPageResponse {
+  projects: ProjectSummary[];
+  nextCursor: string | null;
+}
+
+type ProfileAuthor = Pick<PublicProfile, "displayName" | "username" | "avatar">;
+
+/** Injects author details so ProjectCard can render without the parent profile. */
+export const withAuthor = (projects: ProjectSummary[], author: ProfileAuthor): ProfileProject[] =>
+  projects.map(project => ({
+    ...project,
+    authorName: author.displayName,
+    username: author.username,
+    authorAvatar: author.avatar,
+  }));
+
+export function normalizeProfile(data: ProfileResponse): PublicProfile {
+  const { projects, pinnedProjects, ...profile } = data;
+  return {
+    ...profile,
+    pinnedProjects: withAuthor(pinnedProjects || [], data),
+    allProjects: withAuthor(projects || [], data),
+  };
+}
+
+/** Flattens a project's model and attachments into one list for the file browser. */
+export function getProjectFiles(project: ProjectData): FileAttachment[] {
+  const files: FileAttachment[] = [];
+
+  if (project.files.model?.glb && !project.conversionStatus?.inProgress) {
+    files.push({
+      type: "model",
+      url: project.files.model.glb.url,
+      filename: project.files.model.stl?.filename || project.files.model.glb.filename,
+      size: project.files.model.stl?.size || project.files.model.glb.size,
+    });
+  }
+
+  if (project.files.attachments) {
+    files.push(
+      ...project.files.attachments.map((f) => ({
+        ...f,
+        type: f.type as FileType,
+      }))
+    );
+  }
+
+  return files;
+}